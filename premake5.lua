@@ -15,3 +15,5 @@ project("elemental-forms")
   recursive_platform_files("src/")
 
 include("testbed")
+include("tools/benchmarks")
+include("tools/packer")
@@ -23,6 +23,12 @@ void Animation::InvokeOnAnimationStart() {
 }
 
 void Animation::InvokeOnAnimationUpdate(float progress) {
+  // Most animations have no listeners, so skip setting up the iterator.
+  // NOTE: This object may be deleted by OnAnimationUpdate.
+  if (!m_listeners.HasLinks()) {
+    OnAnimationUpdate(progress);
+    return;
+  }
   auto li = m_listeners.IterateForward();
   OnAnimationUpdate(progress);
   while (AnimationListener* listener = li.GetAndStep()) {
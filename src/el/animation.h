@@ -10,6 +10,7 @@
 #ifndef EL_ANIMATION_H_
 #define EL_ANIMATION_H_
 
+#include <cstddef>
 #include <cstdint>
 
 #include "el/util/intrusive_list.h"
@@ -69,8 +70,7 @@ class AnimationListener : public util::IntrusiveListEntry<AnimationListener> {
 };
 
 // Base class for all animated objects.
-class Animation : public util::TypedObject,
-                  public util::IntrusiveListEntry<Animation> {
+class Animation : public util::TypedObject {
  public:
   static const AnimationCurve kDefaultCurve = AnimationCurve::kSlowDown;
   static const uint64_t kDefaultDuration = 200;
@@ -86,7 +86,7 @@ class Animation : public util::TypedObject,
   ~Animation() override = default;
 
   /** Returns true if the object is currently animating. */
-  bool is_animating() const { return linklist ? true : false; }
+  bool is_animating() const { return m_animation_index != kNotAnimating; }
 
   // Called on animation start.
   virtual void OnAnimationStart() = 0;
@@ -115,6 +115,9 @@ class Animation : public util::TypedObject,
 
  private:
   friend class AnimationManager;
+  static const size_t kNotAnimating = ~size_t(0);
+  // The index of this object in the running animations of AnimationManager.
+  size_t m_animation_index = kNotAnimating;
   util::IntrusiveList<AnimationListener> m_listeners;
   void InvokeOnAnimationStart();
   void InvokeOnAnimationUpdate(float progress);
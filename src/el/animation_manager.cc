@@ -10,11 +10,20 @@
 #include <algorithm>
 
 #include "el/animation_manager.h"
+#include "el/util/counters.h"
 #include "el/util/metrics.h"
+#include "el/util/trace.h"
 
 namespace el {
 
-util::IntrusiveList<Animation> AnimationManager::animating_objects;
+std::vector<Animation*> AnimationManager::animating_objects;
+std::vector<uint64_t> AnimationManager::start_times;
+std::vector<float> AnimationManager::durations;
+std::vector<AnimationCurve> AnimationManager::curves;
+std::vector<uint8_t> AnimationManager::adjust_start_times;
+std::vector<float> AnimationManager::progresses;
+size_t AnimationManager::running_count = 0;
+bool AnimationManager::is_updating = false;
 int AnimationManager::block_animations_counter = 0;
 
 inline float SmoothStep(float x) { return x * x * (3.0f - 2.0f * x); }
@@ -22,8 +31,7 @@ inline float SmoothStep(float x) { return x * x * (3.0f - 2.0f * x); }
 inline float sc(float x) {
   float s = x < 0 ? -1.f : 1.f;
   x = std::abs(x);
-  if (x >= 1) return s;
-  return s * (x < 0 ? x / 0.5f : (x / (1 + x * x)) / 0.5f);
+  return s * (x >= 1 ? 1.f : (x / (1 + x * x)) / 0.5f);
 }
 
 inline float SmoothCurve(float x, float a) {
@@ -34,72 +42,137 @@ inline float SmoothCurve(float x, float a) {
 
 // static
 void AnimationManager::AbortAllAnimations() {
-  while (Animation* obj = animating_objects.GetFirst()) {
-    AbortAnimation(obj, true);
+  // Also aborts animations started by the callbacks of aborted ones.
+  for (size_t i = 0; i < animating_objects.size(); ++i) {
+    if (Animation* obj = animating_objects[i]) {
+      AbortAnimation(obj, true);
+    }
+  }
+  if (!is_updating) {
+    Compact();
+  }
+}
+
+// static
+void AnimationManager::UpdateProgresses(uint64_t time_now, size_t count) {
+  // Adjust the start time if it's the first update time for the animation.
+  for (size_t i = 0; i < count; ++i) {
+    if (adjust_start_times[i]) {
+      start_times[i] = time_now;
+      adjust_start_times[i] = 0;
+      animating_objects[i]->animation_start_time = time_now;
+      animating_objects[i]->adjust_start_time = false;
+    }
+  }
+
+  // Calculate current progress.
+  // If the duration is 0, it should just complete immediately.
+  for (size_t i = 0; i < count; ++i) {
+    float progress =
+        static_cast<float>(time_now - start_times[i]) / durations[i];
+    progresses[i] = durations[i] != 0 ? std::min(progress, 1.0f) : 1.0f;
+  }
+
+  // Apply the animation curves. All curves are evaluated and the right one
+  // picked, so there are no branches keeping this from being vectorized.
+  for (size_t i = 0; i < count; ++i) {
+    float progress = progresses[i];
+    float tmp = 1 - progress;
+    float slow_down = 1 - tmp * tmp * tmp;
+    float speed_up = progress * progress * progress;
+    float bezier = SmoothStep(progress);
+    float smooth = SmoothCurve(progress, 0.6f);
+    AnimationCurve curve = curves[i];
+    progress = curve == AnimationCurve::kSlowDown ? slow_down : progress;
+    progress = curve == AnimationCurve::kSpeedUp ? speed_up : progress;
+    progress = curve == AnimationCurve::kBezier ? bezier : progress;
+    progress = curve == AnimationCurve::kSmooth ? smooth : progress;
+    progresses[i] = progress;
   }
 }
 
 // static
 void AnimationManager::Update() {
+  EL_TRACE_ZONE("AnimationManager::Update");
+  // Holes are only removed between updates, so a nested update would break
+  // the indices of the one in progress.
+  if (is_updating) {
+    return;
+  }
+  is_updating = true;
+  Compact();
   uint64_t time_now = util::GetTimeMS();
 
-  auto iter = animating_objects.IterateForward();
-  while (Animation* obj = iter.GetAndStep()) {
-    // Adjust the start time if it's the first update time for this object.
-    if (obj->adjust_start_time) {
-      obj->animation_start_time = time_now;
-      obj->adjust_start_time = false;
-    }
-
-    // Calculate current progress
-    // If animation_duration is 0, it should just complete immediately.
-    float progress = 1.0f;
-    if (obj->animation_duration != 0) {
-      progress = static_cast<float>(time_now - obj->animation_start_time) /
-                 static_cast<float>(obj->animation_duration);
-      progress = std::min(progress, 1.0f);
-    }
+  // Animations started by the callbacks below are updated by the next Update.
+  const size_t count = animating_objects.size();
+  UpdateProgresses(time_now, count);
 
-    // Apply animation curve
-    float tmp;
-    switch (obj->animation_curve) {
-      case AnimationCurve::kSlowDown:
-        tmp = 1 - progress;
-        progress = 1 - tmp * tmp * tmp;
-        break;
-      case AnimationCurve::kSpeedUp:
-        progress = progress * progress * progress;
-        break;
-      case AnimationCurve::kBezier:
-        progress = SmoothStep(progress);
-        break;
-      case AnimationCurve::kSmooth:
-        progress = SmoothCurve(progress, 0.6f);
-        break;
-      default:  // linear (progress is already linear)
-        break;
+  for (size_t i = 0; i < count; ++i) {
+    Animation* obj = animating_objects[i];
+    if (!obj) {
+      continue;  // Removed by the callbacks of an earlier animation.
     }
+    util::Counters::Add(util::Counter::kAnimationUpdates);
+    float progress = progresses[i];
 
     // Update animation
     obj->InvokeOnAnimationUpdate(progress);
-    if (!animating_objects.ContainsLink(obj)) {
-      continue;
+    if (animating_objects[i] != obj) {
+      continue;  // Removed (and maybe deleted) by the callbacks.
     }
 
     // Remove completed animations
     if (progress == 1.0f) {
-      animating_objects.Remove(obj);
+      Remove(obj);
       obj->InvokeOnAnimationStop(false);
       delete obj;
     }
   }
+
+  Compact();
+  is_updating = false;
 }
 
 // static
-bool AnimationManager::has_running_animations() {
-  return animating_objects.HasLinks();
+void AnimationManager::Remove(Animation* obj) {
+  animating_objects[obj->m_animation_index] = nullptr;
+  obj->m_animation_index = Animation::kNotAnimating;
+  --running_count;
+}
+
+// static
+void AnimationManager::Compact() {
+  if (running_count == animating_objects.size()) {
+    return;
+  }
+  // Keep the order, so animations are updated in the order they started.
+  size_t count = 0;
+  for (size_t i = 0; i < animating_objects.size(); ++i) {
+    Animation* obj = animating_objects[i];
+    if (!obj) {
+      continue;
+    }
+    if (i != count) {
+      animating_objects[count] = obj;
+      start_times[count] = start_times[i];
+      durations[count] = durations[i];
+      curves[count] = curves[i];
+      adjust_start_times[count] = adjust_start_times[i];
+      obj->m_animation_index = count;
+    }
+    ++count;
+  }
+  animating_objects.resize(count);
+  start_times.resize(count);
+  durations.resize(count);
+  curves.resize(count);
+  adjust_start_times.resize(count);
+  progresses.resize(count);
 }
 
+// static
+bool AnimationManager::has_running_animations() { return running_count > 0; }
+
 // static
 void AnimationManager::StartAnimation(Animation* obj,
                                       AnimationCurve animation_curve,
@@ -115,14 +188,25 @@ void AnimationManager::StartAnimation(Animation* obj,
   obj->animation_start_time = util::GetTimeMS();
   obj->animation_duration = std::max(animation_duration, uint64_t(0));
   obj->animation_curve = animation_curve;
-  animating_objects.AddLast(obj);
+  // Don't let holes from aborted animations pile up between updates.
+  if (!is_updating && animating_objects.size() >= running_count * 2 + 16) {
+    Compact();
+  }
+  obj->m_animation_index = animating_objects.size();
+  animating_objects.push_back(obj);
+  start_times.push_back(obj->animation_start_time);
+  durations.push_back(static_cast<float>(obj->animation_duration));
+  curves.push_back(animation_curve);
+  adjust_start_times.push_back(obj->adjust_start_time);
+  progresses.push_back(0);
+  ++running_count;
   obj->InvokeOnAnimationStart();
 }
 
 // static
 void AnimationManager::AbortAnimation(Animation* obj, bool delete_animation) {
   if (obj->is_animating()) {
-    animating_objects.Remove(obj);
+    Remove(obj);
     obj->InvokeOnAnimationStop(true);
     if (delete_animation) {
       delete obj;
@@ -10,20 +10,40 @@
 #ifndef EL_ANIMATION_MANAGER_H_
 #define EL_ANIMATION_MANAGER_H_
 
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 
 #include "el/animation.h"
-#include "el/util/intrusive_list.h"
 #include "el/util/object.h"
 
 namespace el {
 
 // System class that manages all animated object.
+// The running animations are kept with their timing and curve in parallel
+// arrays, so Update computes the progress of all of them in a few tight loops
+// over contiguous data before calling into any of them.
 class AnimationManager {
  private:
-  static util::IntrusiveList<Animation> animating_objects;
+  // The running animations, by Animation::m_animation_index. Removed
+  // animations leave a hole (nullptr) until the next Update.
+  static std::vector<Animation*> animating_objects;
+  static std::vector<uint64_t> start_times;
+  static std::vector<float> durations;
+  static std::vector<AnimationCurve> curves;
+  static std::vector<uint8_t> adjust_start_times;
+  static std::vector<float> progresses;
+  static size_t running_count;
+  static bool is_updating;
   static int block_animations_counter;
 
+  // Computes progresses for the first count animations.
+  static void UpdateProgresses(uint64_t time_now, size_t count);
+  // Removes obj from the running animations.
+  static void Remove(Animation* obj);
+  // Removes the holes left by removed animations.
+  static void Compact();
+
  public:
   // Updates all running animations.
   static void Update();
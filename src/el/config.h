@@ -27,6 +27,11 @@
 #define EL_UNIT_TESTING
 #endif  // CHECKED
 
+// Enables trace zones (EL_TRACE_ZONE) in the frame work of the library
+// (processing, layout, painting...), recorded by util::Tracer while it's
+// started and exported as Chrome trace JSON.
+// #define EL_TRACE
+
 // Enable if the focus state should automatically be set on edit fields even
 // when using the pointer. It is normally set only while moving focus by
 // keyboard.
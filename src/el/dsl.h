@@ -82,6 +82,16 @@ class Node {
     return *this;
   }
 
+  // Writes this node and its children in the binary format (See
+  // ParseNode::WriteBinary), so generated layouts can be loaded without
+  // parsing. Element::LoadFile and LoadData detect the format automatically.
+  void WriteBinary(std::vector<uint8_t>* out) const {
+    el::parsing::ParseNode root;
+    root.Add(parse_node_);
+    root.WriteBinary(out);
+    root.Remove(parse_node_);
+  }
+
  protected:
   Node(const char* name,
        std::vector<std::pair<const char*, const char*>> properties = {},
@@ -7,10 +7,13 @@
  ******************************************************************************
  */
 
+#include <algorithm>
 #include <cstdarg>
 
 #include "el/element.h"
+#include "el/element_delete_queue.h"
 #include "el/element_listener.h"
+#include "el/element_pool.h"
 #include "el/elements/form.h"
 #include "el/elements/parts/scroller.h"
 #include "el/elements/tab_container.h"
@@ -19,12 +22,15 @@
 #include "el/graphics/renderer.h"
 #include "el/list_item.h"
 #include "el/parsing/element_inflater.h"
+#include "el/parsing/element_template.h"
 #include "el/parsing/parse_node.h"
 #include "el/text/font_manager.h"
+#include "el/util/counters.h"
 #include "el/util/debug.h"
 #include "el/util/math.h"
 #include "el/util/metrics.h"
 #include "el/util/string.h"
+#include "el/util/trace.h"
 #include "el/value.h"
 
 namespace el {
@@ -42,6 +48,8 @@ bool Element::cancel_click = false;
 bool Element::update_element_states = true;
 bool Element::update_skin_states = true;
 bool Element::show_focus_state = false;
+bool Element::occlusion_culling = true;
+uint32_t Element::inherited_generation_ = 1;
 
 // One shot timer for long click event.
 class LongClickTimer : private MessageHandler {
@@ -61,6 +69,53 @@ class LongClickTimer : private MessageHandler {
   bool m_touch;
 };
 
+struct Element::Layer : private graphics::RendererListener {
+  ~Layer() override { ReleaseTarget(); }
+
+  // Makes sure there is a render target of the given size (rounded up to a
+  // power of two) from the current renderer.
+  // Returns false if the renderer doesn't support render targets.
+  bool ReserveTarget(int width, int height);
+  void ReleaseTarget();
+
+  void OnContextLost() override { ReleaseTarget(); }
+  void OnContextRestored() override {}
+
+  Renderer* renderer = nullptr;
+  std::unique_ptr<graphics::Bitmap> target;
+  // The painted part of the target, relative to the element.
+  Rect rect;
+  // The inherited text color used when painted.
+  Color text_color;
+  bool is_valid = false;
+};
+
+bool Element::Layer::ReserveTarget(int width, int height) {
+  Renderer* current_renderer = Renderer::get();
+  if (target && renderer == current_renderer &&
+      target->width() == util::GetNearestPowerOfTwo(width) &&
+      target->height() == util::GetNearestPowerOfTwo(height)) {
+    return true;
+  }
+  ReleaseTarget();
+  target = current_renderer->CreateRenderTarget(width, height);
+  if (!target) {
+    return false;
+  }
+  renderer = current_renderer;
+  renderer->AddListener(this);
+  return true;
+}
+
+void Element::Layer::ReleaseTarget() {
+  if (renderer) {
+    renderer->RemoveListener(this);
+    renderer = nullptr;
+  }
+  target.reset();
+  is_valid = false;
+}
+
 Element::PaintProps::PaintProps() {
   // Set the default properties, used for the root elements
   // calling InvokePaint. The base values for all inheritance.
@@ -73,6 +128,22 @@ void Element::RegisterInflater() {
 
 Element::Element() = default;
 
+void* Element::operator new(size_t size) {
+  if (ElementPool* pool = ElementPool::get()) {
+    return pool->Allocate(size);
+  }
+  // Allocate a whole block, as it may be pooled when released.
+  return ::operator new(ElementPool::block_size(size));
+}
+
+void Element::operator delete(void* ptr, size_t size) {
+  if (ElementPool* pool = ElementPool::get()) {
+    pool->Release(ptr, size);
+  } else {
+    ::operator delete(ptr);
+  }
+}
+
 Element::~Element() {
   // A element must be removed from parent before deleted.
   RemoveFromParent();
@@ -90,12 +161,17 @@ Element::~Element() {
   }
 
   ElementListener::InvokeElementDelete(this);
-  DeleteAllChildren();
+  // There's no need to invalidate this element for each removed child, since
+  // it's being deleted.
+  while (Element* child = first_child()) {
+    DetachChild(child, InvokeInfo::kNormal);
+    delete child;
+  }
 
   StopLongClickTimer();
 
-  assert(!m_listeners
-              .HasLinks());  // There's still listeners added to this element!
+  // There's still listeners added to this element!
+  assert(!m_cold || !m_cold->listeners.HasLinks());
 }
 
 bool Element::LoadFile(const char* filename) {
@@ -127,44 +203,59 @@ void Element::SetIdFromNode(TBID* id, parsing::ParseNode* node) {
 }
 
 void Element::OnInflate(const parsing::InflateInfo& info) {
-  Element::SetIdFromNode(&id(), info.node->GetNode("id"));
-  Element::SetIdFromNode(&group_id(), info.node->GetNode("group-id"));
+  // The generic properties are usually parsed by the ElementFactory (once for
+  // all inflations of a template). Parse them here if called directly.
+  parsing::InflateProperties parsed_properties;
+  const parsing::InflateProperties* properties = info.properties;
+  if (!properties) {
+    parsed_properties.Parse(info.node, info.sync_type);
+    properties = &parsed_properties;
+  }
+  const parsing::InflateProperties& p = *properties;
+  using parsing::InflateProperties;
+
+  if (p.has_id) {
+    id() = p.id;
+  }
+  if (p.has_group_id) {
+    group_id() = p.group_id;
+  }
 
   if (info.sync_type == Value::Type::kFloat) {
-    set_double_value(info.node->GetValueFloat("value", 0));
+    set_double_value(p.float_value);
   } else {
-    set_value(info.node->GetValueInt("value", 0));
+    set_value(p.int_value);
   }
 
-  if (auto data_node = info.node->GetNode("data")) {
-    data.Copy(data_node->value());
+  if (p.has_data) {
+    data.Copy(p.data);
   }
 
-  set_group_root(
-      info.node->GetValueInt("is-group-root", is_group_root()) ? true : false);
-
-  set_focusable(info.node->GetValueInt("is-focusable", is_focusable()) ? true
-                                                                       : false);
-
-  set_long_clickable(
-      info.node->GetValueInt("want-long-click", is_long_clickable()) ? true
-                                                                     : false);
-
-  set_ignoring_input(info.node->GetValueInt("ignore-input", is_ignoring_input())
-                         ? true
-                         : false);
-
-  set_opacity(info.node->GetValueFloat("opacity", opacity()));
+  if (p.is_group_root != InflateProperties::kNotSpecified) {
+    set_group_root(p.is_group_root ? true : false);
+  }
+  if (p.is_focusable != InflateProperties::kNotSpecified) {
+    set_focusable(p.is_focusable ? true : false);
+  }
+  if (p.want_long_click != InflateProperties::kNotSpecified) {
+    set_long_clickable(p.want_long_click ? true : false);
+  }
+  if (p.ignore_input != InflateProperties::kNotSpecified) {
+    set_ignoring_input(p.ignore_input ? true : false);
+  }
+  if (p.opacity >= 0) {
+    set_opacity(p.opacity);
+  }
 
-  if (const char* text = info.node->GetValueString("text", nullptr)) {
-    set_text(text);
+  if (p.has_text) {
+    set_text(p.text);
   }
 
-  if (const char* connection =
-          info.node->GetValueStringRaw("connection", nullptr)) {
+  if (p.has_connection) {
     // If we already have a element value with this name, just connect to it and
     // the element will adjust its value to it. Otherwise create a new element
     // value, and give it the value we got from the resource.
+    const char* connection = p.connection.c_str();
     if (ElementValue* value = ElementValueGroup::get()->GetValue(connection)) {
       Connect(value);
     } else if (ElementValue* value =
@@ -174,103 +265,74 @@ void Element::OnInflate(const parsing::InflateInfo& info) {
       Connect(value);
     }
   }
-  if (const char* axis = info.node->GetValueString("axis", nullptr)) {
-    set_axis(el::from_string(axis, Axis::kY));
+  if (p.has_axis) {
+    set_axis(p.axis);
   }
-  if (const char* gravity = info.node->GetValueString("gravity", nullptr)) {
-    Gravity g = Gravity::kNone;
-    if (strstr(gravity, "left")) g |= Gravity::kLeft;
-    if (strstr(gravity, "top")) g |= Gravity::kTop;
-    if (strstr(gravity, "right")) g |= Gravity::kRight;
-    if (strstr(gravity, "bottom")) g |= Gravity::kBottom;
-    if (strstr(gravity, "all")) g |= Gravity::kAll;
-    if (!any(g & Gravity::kLeftRight)) g |= Gravity::kLeft;
-    if (!any(g & Gravity::kTopBottom)) g |= Gravity::kTop;
-    set_gravity(g);
+  if (p.has_gravity) {
+    set_gravity(p.gravity);
   }
-  if (const char* visibility_str =
-          info.node->GetValueString("visibility", nullptr)) {
-    set_visibility(from_string(visibility_str, visibility()));
+  if (p.has_visibility) {
+    set_visibility(p.visibility);
   }
-  if (const char* state = info.node->GetValueString("state", nullptr)) {
-    if (strstr(state, "disabled")) {
-      set_state(Element::State::kDisabled, true);
-    }
+  if (p.is_disabled) {
+    set_state(Element::State::kDisabled, true);
   }
-  if (const char* skin = info.node->GetValueString("skin", nullptr)) {
-    set_background_skin(skin);
+  if (p.has_skin) {
+    set_background_skin(p.skin);
   }
-  if (auto lp = info.node->GetNode("lp")) {
+  if (p.has_layout_params) {
     LayoutParams layout_params;
     if (this->layout_params()) {
       layout_params = *this->layout_params();
     }
-    auto dc = Skin::get()->dimension_converter();
-    if (const char* str = lp->GetValueString("width", nullptr)) {
-      layout_params.set_width(
-          dc->GetPxFromString(str, LayoutParams::kUnspecified));
+    if (p.lp_width != InflateProperties::kNotSpecified) {
+      layout_params.set_width(p.lp_width);
     }
-    if (const char* str = lp->GetValueString("height", nullptr)) {
-      layout_params.set_height(
-          dc->GetPxFromString(str, LayoutParams::kUnspecified));
+    if (p.lp_height != InflateProperties::kNotSpecified) {
+      layout_params.set_height(p.lp_height);
     }
-    if (const char* str = lp->GetValueString("min-width", nullptr)) {
-      layout_params.min_w =
-          dc->GetPxFromString(str, LayoutParams::kUnspecified);
+    if (p.lp_min_width != InflateProperties::kNotSpecified) {
+      layout_params.min_w = p.lp_min_width;
     }
-    if (const char* str = lp->GetValueString("max-width", nullptr)) {
-      layout_params.max_w =
-          dc->GetPxFromString(str, LayoutParams::kUnspecified);
+    if (p.lp_max_width != InflateProperties::kNotSpecified) {
+      layout_params.max_w = p.lp_max_width;
     }
-    if (const char* str = lp->GetValueString("pref-width", nullptr)) {
-      layout_params.pref_w =
-          dc->GetPxFromString(str, LayoutParams::kUnspecified);
+    if (p.lp_pref_width != InflateProperties::kNotSpecified) {
+      layout_params.pref_w = p.lp_pref_width;
     }
-    if (const char* str = lp->GetValueString("min-height", nullptr)) {
-      layout_params.min_h =
-          dc->GetPxFromString(str, LayoutParams::kUnspecified);
+    if (p.lp_min_height != InflateProperties::kNotSpecified) {
+      layout_params.min_h = p.lp_min_height;
     }
-    if (const char* str = lp->GetValueString("max-height", nullptr)) {
-      layout_params.max_h =
-          dc->GetPxFromString(str, LayoutParams::kUnspecified);
+    if (p.lp_max_height != InflateProperties::kNotSpecified) {
+      layout_params.max_h = p.lp_max_height;
     }
-    if (const char* str = lp->GetValueString("pref-height", nullptr)) {
-      layout_params.pref_h =
-          dc->GetPxFromString(str, LayoutParams::kUnspecified);
+    if (p.lp_pref_height != InflateProperties::kNotSpecified) {
+      layout_params.pref_h = p.lp_pref_height;
     }
     set_layout_params(layout_params);
   }
 
-  set_tooltip(info.node->GetValueString("tooltip", nullptr));
+  set_tooltip(p.has_tooltip ? p.tooltip.c_str() : nullptr);
 
   // Add the new element to the hiearchy if not already added.
   if (!parent()) info.target->AddChild(this, info.target->z_inflate());
 
   // Read the font now when the element is in the hiearchy so inheritance works.
-  if (auto font = info.node->GetNode("font")) {
+  if (p.has_font) {
     FontDescription fd = computed_font_description();
-    if (const char* size = font->GetValueString("size", nullptr)) {
-      int new_size =
-          Skin::get()->dimension_converter()->GetPxFromString(size, fd.size());
-      fd.set_size(new_size);
+    if (p.font_size != InflateProperties::kNotSpecified) {
+      fd.set_size(p.font_size);
     }
-    if (const char* name = font->GetValueString("name", nullptr)) {
-      fd.set_id(name);
+    if (p.has_font_name) {
+      fd.set_id(p.font_name);
     }
     set_font_description(fd);
   }
 
   info.target->OnInflateChild(this);
 
-  if (auto rect_node = info.node->GetNode("rect")) {
-    auto dc = Skin::get()->dimension_converter();
-    Value& val = rect_node->value();
-    if (val.array_size() == 4) {
-      set_rect({dc->GetPxFromValue(val.as_array()->at(0), 0),
-                dc->GetPxFromValue(val.as_array()->at(1), 0),
-                dc->GetPxFromValue(val.as_array()->at(2), 0),
-                dc->GetPxFromValue(val.as_array()->at(3), 0)});
-    }
+  if (p.has_rect) {
+    set_rect(p.rect);
   }
 }
 
@@ -283,22 +345,43 @@ void Element::set_rect(const Rect& rect) {
   m_rect = rect;
   if (old_rect.w != m_rect.w || old_rect.h != m_rect.h) {
     OnResized(old_rect.w, old_rect.h);
+    Invalidate();
+  } else {
+    // Moving doesn't change what's painted in the layer.
+    InvalidateComposite();
   }
-
-  Invalidate();
 }
 
 void Element::Invalidate() {
-  if (!computed_visibility() && !m_rect.empty()) {
-    return;
-  }
+  // Nothing needs to be repainted while hidden, but the layers painted
+  // before it was hidden are stale when it's shown again.
+  bool repaint = computed_visibility() || m_rect.empty();
   Element* tmp = this;
   while (tmp) {
-    tmp->OnInvalid();
+    if (repaint) {
+      tmp->OnInvalid();
+    }
+    if (tmp->m_packed.is_layer && tmp->m_cold && tmp->m_cold->layer) {
+      tmp->m_cold->layer->is_valid = false;
+    }
     tmp = tmp->m_parent;
   }
 }
 
+void Element::InvalidateComposite() {
+  if (!m_packed.is_layer) {
+    Invalidate();
+    return;
+  }
+  if (!computed_visibility() && !m_rect.empty()) {
+    return;
+  }
+  OnInvalid();
+  if (m_parent) {
+    m_parent->Invalidate();
+  }
+}
+
 void Element::InvalidateStates() {
   update_element_states = true;
   InvalidateSkinStates();
@@ -367,6 +450,9 @@ void Element::set_id(const TBID& id) {
 
 void Element::set_state_raw(Element::State state) {
   if (m_state == state) return;
+  if (any((m_state ^ state) & Element::State::kDisabled)) {
+    InvalidateInheritedState();
+  }
   m_state = state;
   Invalidate();
   InvalidateSkinStates();
@@ -417,7 +503,22 @@ void Element::set_opacity(float opacity) {
     // Invalidate after setting opacity 0 will do nothing.
     Invalidate();
   }
+  if ((m_opacity == 0) != (opacity == 0)) {
+    InvalidateInheritedState();
+  }
   m_opacity = opacity;
+  // Layers are painted without the opacity, it's applied when drawing them.
+  InvalidateComposite();
+}
+
+void Element::set_layer(bool layer) {
+  if (m_packed.is_layer == layer) {
+    return;
+  }
+  m_packed.is_layer = layer;
+  if (!layer && m_cold) {
+    m_cold->layer.reset();
+  }
   Invalidate();
 }
 
@@ -436,6 +537,7 @@ void Element::set_visibility(Visibility vis) {
 
   Visibility old_vis = visibility();
   m_packed.visibility = static_cast<int>(vis);
+  InvalidateInheritedState();
 
   Invalidate();
   if (old_vis == Visibility::kGone) {
@@ -449,27 +551,18 @@ Visibility Element::visibility() const {
   return static_cast<Visibility>(m_packed.visibility);
 }
 
-bool Element::computed_visibility() const {
-  const Element* tmp = this;
-  while (tmp) {
-    if (tmp->opacity() == 0 || tmp->visibility() != Visibility::kVisible) {
-      return false;
-    }
-    tmp = tmp->m_parent;
+void Element::UpdateInheritedState() const {
+  bool visible = m_opacity != 0 && visibility() == Visibility::kVisible;
+  bool enabled = !has_state(Element::State::kDisabled);
+  if (m_parent) {
+    visible = visible && m_parent->computed_visibility();
+    enabled = enabled && m_parent->is_enabled();
   }
-  return true;
+  m_inherited_visible = visible;
+  m_inherited_enabled = enabled;
+  m_inherited_generation = inherited_generation_;
 }
 
-bool Element::is_enabled() const {
-  const Element* tmp = this;
-  while (tmp) {
-    if (tmp->has_state(Element::State::kDisabled)) {
-      return false;
-    }
-    tmp = tmp->m_parent;
-  }
-  return true;
-}
 
 void Element::RemoveFromParent() {
   if (parent()) {
@@ -487,6 +580,8 @@ void Element::AddChildRelative(Element* child, ElementZRel z,
                                Element* reference, InvokeInfo info) {
   assert(!child->m_parent);
   child->m_parent = this;
+  InvalidateInheritedState();
+  InvalidateSubtreeMeasureThreadSafe();
 
   if (reference) {
     if (z == ElementZRel::kBefore) {
@@ -515,13 +610,21 @@ void Element::AddChildRelative(Element* child, ElementZRel z,
 }
 
 void Element::RemoveChild(Element* child, InvokeInfo info) {
+  DetachChild(child, info);
+  InvalidateLayout(InvalidationMode::kRecursive);
+  Invalidate();
+  InvalidateSkinStates();
+}
+
+void Element::DetachChild(Element* child, InvokeInfo info) {
   assert(child->m_parent == this);
 
   if (info == InvokeInfo::kNormal) {
-    // If we're not being deleted and delete the focused element, try
-    // to keep the focus in this element by moving it to the next element.
-    if (!m_packed.is_dying && child == focused_element) {
-      m_parent->MoveFocus(true);
+    // If we're not being deleted and delete the focused element (or the
+    // branch containing it), try to keep the focus in this element by moving
+    // it to the next element.
+    if (!m_packed.is_dying && child->IsAncestorOf(focused_element)) {
+      MoveFocus(true);
     }
 
     OnChildRemove(child);
@@ -531,10 +634,8 @@ void Element::RemoveChild(Element* child, InvokeInfo info) {
 
   m_children.Remove(child);
   child->m_parent = nullptr;
-
-  InvalidateLayout(InvalidationMode::kRecursive);
-  Invalidate();
-  InvalidateSkinStates();
+  InvalidateInheritedState();
+  InvalidateSubtreeMeasureThreadSafe();
 }
 
 void Element::DeleteChild(Element* child, InvokeInfo info) {
@@ -554,6 +655,47 @@ void Element::DeleteAllChildren() {
   }
 }
 
+void Element::DeleteChildDeferred(Element* child) {
+  RemoveChild(child);
+  QueueForDeletion(child);
+}
+
+void Element::DeleteAllChildrenDeferred() {
+  if (!first_child()) {
+    return;
+  }
+  while (Element* child = first_child()) {
+    DetachChild(child, InvokeInfo::kNormal);
+    QueueForDeletion(child);
+  }
+  InvalidateLayout(InvalidationMode::kRecursive);
+  Invalidate();
+  InvalidateSkinStates();
+}
+
+void Element::QueueForDeletion(Element* element) {
+  ElementDeleteQueue* queue = ElementDeleteQueue::get();
+  if (!queue) {
+    delete element;
+    return;
+  }
+  // The destructor would forget these, so don't leave them pointing into the
+  // removed branch until it's deleted.
+  if (element->IsAncestorOf(hovered_element)) {
+    hovered_element = nullptr;
+  }
+  if (element->IsAncestorOf(captured_element)) {
+    captured_element = nullptr;
+  }
+  // DetachChild has moved the focus out of the branch if anything else could
+  // take it.
+  if (element->IsAncestorOf(focused_element)) {
+    focused_element = nullptr;
+  }
+  element->m_packed.is_dying = true;
+  queue->Add(element);
+}
+
 void Element::set_z(ElementZ z) {
   if (!m_parent) return;
   if (z == ElementZ::kTop && this == m_parent->m_children.GetLast()) {
@@ -616,8 +758,9 @@ Element* Element::FindScrollableElement(bool scroll_x, bool scroll_y) {
 elements::parts::Scroller* Element::FindStartedScroller() {
   Element* candidate = this;
   while (candidate) {
-    if (candidate->m_scroller && candidate->m_scroller->is_started()) {
-      return candidate->m_scroller.get();
+    auto cold = candidate->m_cold.get();
+    if (cold && cold->scroller && cold->scroller->is_started()) {
+      return cold->scroller.get();
     }
     candidate = candidate->parent();
   }
@@ -636,10 +779,11 @@ elements::parts::Scroller* Element::GetReadyScroller(bool scroll_x,
 }
 
 elements::parts::Scroller* Element::scroller() {
-  if (!m_scroller) {
-    m_scroller = std::make_unique<elements::parts::Scroller>(this);
+  ColdData* cold = this->cold();
+  if (!cold->scroller) {
+    cold->scroller = std::make_unique<elements::parts::Scroller>(this);
   }
-  return m_scroller.get();
+  return cold->scroller.get();
 }
 
 void Element::ScrollToSmooth(int x, int y) {
@@ -943,6 +1087,26 @@ Element* Element::parent_root() {
   return tmp;
 }
 
+Element::ColdData* Element::cold() {
+  if (!m_cold) {
+    m_cold = std::make_unique<ColdData>();
+  }
+  return m_cold.get();
+}
+
+const std::string& Element::tooltip() {
+  static const std::string empty_tooltip;
+  return m_cold ? m_cold->tooltip_str : empty_tooltip;
+}
+
+void Element::set_tooltip(const char* value) {
+  if (value && *value) {
+    cold()->tooltip_str = value;
+  } else if (m_cold) {
+    m_cold->tooltip_str.clear();
+  }
+}
+
 elements::Form* Element::parent_form() {
   Element* tmp = this;
   while (tmp && !tmp->IsOfType<elements::Form>()) {
@@ -952,27 +1116,34 @@ elements::Form* Element::parent_form() {
 }
 
 void Element::AddListener(ElementListener* listener) {
-  m_listeners.AddLast(listener);
+  cold()->listeners.AddLast(listener);
 }
 
 void Element::RemoveListener(ElementListener* listener) {
-  m_listeners.Remove(listener);
+  if (m_cold) {
+    m_cold->listeners.Remove(listener);
+  }
 }
 
 bool Element::HasListener(ElementListener* listener) const {
-  return m_listeners.ContainsLink(listener);
+  return m_cold && m_cold->listeners.ContainsLink(listener);
 }
 
 void Element::AddEventHandler(EventHandler* event_handler) {
-  event_handlers_.AddLast(event_handler);
+  cold()->event_handlers.AddLast(event_handler);
 }
 
 void Element::RemoveEventHandler(EventHandler* event_handler) {
-  event_handlers_.Remove(event_handler);
+  if (m_cold) {
+    m_cold->event_handlers.Remove(event_handler);
+  }
 }
 
 bool Element::OnEvent(const Event& ev) {
-  auto it = event_handlers_.IterateForward();
+  if (!m_cold) {
+    return false;
+  }
+  auto it = m_cold->event_handlers.IterateForward();
   while (auto event_handler = it.GetAndStep()) {
     if (event_handler->OnEvent(ev)) {
       return true;
@@ -991,10 +1162,16 @@ void Element::OnPaintChildren(const PaintProps& paint_props) {
   Renderer::get()->Translate(child_translation_x, child_translation_y);
 
   Rect clip_rect = Renderer::get()->clip_rect();
+  const bool has_occluded = occlusion_culling && may_children_overlap() &&
+                            MarkOccludedChildren(clip_rect);
 
   // Invoke paint on all children that are in the current visible rect.
   for (Element* child = first_child(); child; child = child->GetNext()) {
-    if (clip_rect.intersects(child->m_rect)) {
+    if (!clip_rect.intersects(child->m_rect)) {
+      util::Counters::Add(util::Counter::kElementsCulled);
+    } else if (has_occluded && child->m_packed.is_occluded) {
+      util::Counters::Add(util::Counter::kElementsOccluded);
+    } else {
       child->InvokePaint(paint_props);
     }
   }
@@ -1176,6 +1353,7 @@ PreferredSize Element::OnCalculatePreferredSize(
   // specified.
   // If not set by the element, calculate based on the intrinsic size of the
   // skin.
+  e->LoadBitmapSize();
   const int skin_intrinsic_w = e->intrinsic_width();
   if (e->preferred_width() != kSkinValueNotSpecified) {
     ps.pref_w = e->preferred_width();
@@ -1229,17 +1407,19 @@ PreferredSize Element::OnCalculatePreferredSize(
   return ps;
 }
 
-PreferredSize Element::GetPreferredSize(const SizeConstraints& in_constraints) {
-  SizeConstraints constraints(in_constraints);
-  if (m_layout_params) {
-    constraints = constraints.ConstrainByLayoutParams(*m_layout_params);
-  }
+bool Element::is_preferred_size_cached(
+    const SizeConstraints& in_constraints) const {
+  const LayoutParams* layout_params = this->layout_params();
+  return IsCachedPreferredSizeValid(
+      layout_params ? in_constraints.ConstrainByLayoutParams(*layout_params)
+                    : in_constraints);
+}
 
-  // Returned cached result if valid and the constraints are the same.
-  if (m_packed.is_cached_ps_valid) {
-    if (m_cached_sc == constraints ||
-        m_cached_ps.size_dependency == SizeDependency::kNone) {
-      /*||
+bool Element::IsCachedPreferredSizeValid(
+    const SizeConstraints& constraints) const {
+  return m_packed.is_cached_ps_valid &&
+         (m_cached_sc == constraints ||
+          m_cached_ps.size_dependency == SizeDependency::kNone /*||
                         // FIX: These optimizations would probably be good.
          Keeping
                         //      disabled for now because it needs testing.
@@ -1252,23 +1432,55 @@ PreferredSize Element::GetPreferredSize(const SizeConstraints& in_constraints) {
          matter
                         (m_cached_ps.size_dependency ==
          SizeDependency::kHeightOnWidth &&
-                        m_cached_sc.available_w == constraints.available_w)*/
-      return m_cached_ps;
-    }
+                        m_cached_sc.available_w == constraints.available_w)*/);
+}
+
+bool Element::IsSubtreeMeasureThreadSafe() const {
+  if (m_is_subtree_measure_thread_safe_valid) {
+    return m_is_subtree_measure_thread_safe;
+  }
+  bool is_thread_safe = is_measure_thread_safe();
+  for (Element* child = first_child(); child && is_thread_safe;
+       child = child->GetNext()) {
+    is_thread_safe = child->IsSubtreeMeasureThreadSafe();
+  }
+  m_is_subtree_measure_thread_safe = is_thread_safe;
+  m_is_subtree_measure_thread_safe_valid = true;
+  return is_thread_safe;
+}
+
+void Element::InvalidateSubtreeMeasureThreadSafe() {
+  for (Element* element = this; element; element = element->m_parent) {
+    element->m_is_subtree_measure_thread_safe_valid = false;
+  }
+}
+
+PreferredSize Element::GetPreferredSize(const SizeConstraints& in_constraints) {
+  EL_TRACE_ZONE("Element::GetPreferredSize");
+  SizeConstraints constraints(in_constraints);
+  const LayoutParams* layout_params = this->layout_params();
+  if (layout_params) {
+    constraints = constraints.ConstrainByLayoutParams(*layout_params);
+  }
+
+  // Returned cached result if valid and the constraints are the same.
+  if (IsCachedPreferredSizeValid(constraints)) {
+    return m_cached_ps;
   }
 
   // Measure and save to cache.
   EL_IF_DEBUG_SETTING(util::DebugInfo::Setting::kLayoutSizing,
                       last_measure_time = util::GetTimeMS());
   m_packed.is_cached_ps_valid = 1;
+  util::Counters::Add(util::Counter::kMeasures);
   m_cached_ps = OnCalculatePreferredSize(constraints);
   m_cached_sc = constraints;
 
   // Override the calculated ps with any specified layout parameter.
-  if (m_layout_params) {
-#define LP_OVERRIDE(param)                                    \
-  if (m_layout_params->param != LayoutParams::kUnspecified) { \
-    m_cached_ps.param = m_layout_params->param;               \
+  if (layout_params) {
+#define LP_OVERRIDE(param)                                  \
+  if (layout_params->param != LayoutParams::kUnspecified) { \
+    m_cached_ps.param = layout_params->param;               \
   }
     LP_OVERRIDE(min_w);
     LP_OVERRIDE(min_h);
@@ -1287,10 +1499,11 @@ PreferredSize Element::GetPreferredSize(const SizeConstraints& in_constraints) {
 }
 
 void Element::set_layout_params(const LayoutParams& lp) {
-  if (!m_layout_params) {
-    m_layout_params = std::make_unique<LayoutParams>();
+  ColdData* cold = this->cold();
+  if (!cold->layout_params) {
+    cold->layout_params = std::make_unique<LayoutParams>();
   }
-  *m_layout_params = lp;
+  *cold->layout_params = lp;
   m_packed.is_cached_ps_valid = 0;
   InvalidateLayout(InvalidationMode::kRecursive);
 }
@@ -1307,6 +1520,14 @@ void Element::InvalidateLayout(InvalidationMode il) {
 }
 
 void Element::InvokeProcess() {
+  EL_TRACE_ZONE("Element::InvokeProcess");
+  // Processing the root is the frame boundary where elements queued for
+  // deletion are deleted.
+  if (!m_parent) {
+    if (ElementDeleteQueue* queue = ElementDeleteQueue::get()) {
+      queue->Flush();
+    }
+  }
   InvokeSkinUpdatesInternal(false);
   InvokeProcessInternal();
 }
@@ -1349,6 +1570,7 @@ void Element::InvokeProcessStates(bool force_update) {
   if (!update_element_states && !force_update) {
     return;
   }
+  EL_TRACE_ZONE("Element::InvokeProcessStates");
   update_element_states = false;
 
   OnProcessStates();
@@ -1357,6 +1579,120 @@ void Element::InvokeProcessStates(bool force_update) {
     child->InvokeProcessStates(true);
 }
 
+namespace {
+
+// Returns true if rect is covered by the union of the given rects.
+bool IsRectCovered(const Rect& rect, const Rect* rects, int count) {
+  if (rect.empty()) {
+    return true;
+  }
+  for (int i = 0; i < count; ++i) {
+    const Rect& cover = rects[i];
+    if (!rect.intersects(cover)) {
+      continue;
+    }
+    // The parts of rect outside of this rect must be covered by the rest.
+    const int band_top = std::max(rect.y, cover.y);
+    const int band_bottom = std::min(rect.y + rect.h, cover.y + cover.h);
+    const Rect parts[] = {
+        Rect(rect.x, rect.y, rect.w, cover.y - rect.y),
+        Rect(rect.x, cover.y + cover.h, rect.w,
+             rect.y + rect.h - cover.y - cover.h),
+        Rect(rect.x, band_top, cover.x - rect.x, band_bottom - band_top),
+        Rect(cover.x + cover.w, band_top, rect.x + rect.w - cover.x - cover.w,
+             band_bottom - band_top),
+    };
+    for (const Rect& part : parts) {
+      if (!IsRectCovered(part, rects + i + 1, count - i - 1)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+bool Element::MarkOccludedChildren(const Rect& clip_rect) {
+  // Anything painted with less than full opacity shows what's below.
+  if (Renderer::get()->opacity() < 1.0f || first_child() == last_child()) {
+    return false;
+  }
+  // Walk from the top of the z order, collecting the children that may paint
+  // opaque to check the children below against. Their opaque rects are only
+  // resolved when something below is within their rects, since most children
+  // (f.ex list items) don't overlap. The number of occluders is limited to
+  // keep the cost of the coverage check down.
+  const int kMaxOccluders = 8;
+  Element* occluder_elements[kMaxOccluders];
+  Rect occluders[kMaxOccluders];
+  int occluder_count = 0;
+  int resolved_count = 0;
+  // Resolves the opaque rects of the occluders, dropping the ones that turn
+  // out not to be opaque.
+  auto resolve_occluders = [&]() {
+    int count = resolved_count;
+    for (int i = resolved_count; i < occluder_count; ++i) {
+      Element* occluder = occluder_elements[i];
+      auto skin_element = occluder->background_skin_element();
+      Element::State state = occluder->computed_state();
+      ElementSkinConditionContext context(occluder);
+      if (skin_element &&
+          occluder->CalculateOpacityInternal(state, skin_element) == 1.0f) {
+        Rect opaque_rect = Skin::get()
+                               ->GetOpaqueRect(occluder->m_rect, skin_element,
+                                               state, context)
+                               .Clip(clip_rect);
+        if (!opaque_rect.empty()) {
+          occluder_elements[count] = occluder;
+          occluders[count++] = opaque_rect;
+        }
+      }
+    }
+    occluder_count = resolved_count = count;
+  };
+
+  bool any_occluded = false;
+  for (Element* child = last_child(); child; child = child->GetPrev()) {
+    child->m_packed.is_occluded = 0;
+    if (!clip_rect.intersects(child->m_rect) || child->m_opacity == 0 ||
+        child->visibility() != Visibility::kVisible) {
+      continue;
+    }
+    // Check the rect against the (unresolved) occluder rects first, since
+    // resolving skins is more expensive. The skin expansion is painted outside
+    // of the rect.
+    Rect bounds = child->m_rect.Clip(clip_rect);
+    if (occluder_count && IsRectCovered(bounds, occluders, occluder_count)) {
+      resolve_occluders();
+      auto skin_element = child->background_skin_element();
+      int expand = skin_element ? std::max(int(skin_element->expand), 0) : 0;
+      bounds = child->m_rect.Expand(expand, expand).Clip(clip_rect);
+      if (IsRectCovered(bounds, occluders, occluder_count)) {
+        child->m_packed.is_occluded = 1;
+        any_occluded = true;
+        continue;
+      }
+    }
+    // Skip skins that are never opaque before resolving the skin and state.
+    // The expected skin is the one after strong overrides were last updated.
+    if (child->m_opacity != 1.0f ||
+        !Skin::get()->MayBeOpaque(
+            Skin::get()->GetSkinElementById(child->m_skin_bg_expected))) {
+      continue;
+    }
+    if (occluder_count == kMaxOccluders) {
+      resolve_occluders();
+    }
+    if (occluder_count < kMaxOccluders) {
+      occluder_elements[occluder_count] = child;
+      occluders[occluder_count++] = child->m_rect.Clip(clip_rect);
+    }
+  }
+  return any_occluded;
+}
+
 float Element::CalculateOpacityInternal(Element::State state,
                                         SkinElement* skin_element) const {
   float opacity = m_opacity;
@@ -1375,6 +1711,8 @@ void Element::InvokePaint(const PaintProps& parent_paint_props) {
       visibility() != Visibility::kVisible) {
     return;
   }
+  EL_TRACE_ZONE("Element::InvokePaint");
+  util::Counters::Add(util::Counter::kElementsPainted);
 
   Element::State state = computed_state();
   auto skin_element = background_skin_element();
@@ -1385,12 +1723,60 @@ void Element::InvokePaint(const PaintProps& parent_paint_props) {
   float opacity = old_opacity * CalculateOpacityInternal(state, skin_element);
   if (opacity == 0) return;
 
-  // FIX: This does not give the correct result! Must use a new render target!
+  if (m_packed.is_layer &&
+      PaintLayer(parent_paint_props, state, skin_element, opacity)) {
+    return;
+  }
+
+  // NOTE: The opacity is applied to each quad, so overlapping children show
+  // through each other. Layers apply it to the element as a whole.
   Renderer::get()->set_opacity(opacity);
 
   int trns_x = m_rect.x, trns_y = m_rect.y;
   Renderer::get()->Translate(trns_x, trns_y);
+  PaintContent(parent_paint_props, state, skin_element);
+  Renderer::get()->Translate(-trns_x, -trns_y);
+  Renderer::get()->set_opacity(old_opacity);
+}
 
+bool Element::PaintLayer(const PaintProps& parent_paint_props, State state,
+                         SkinElement* skin_element, float opacity) {
+  Renderer* renderer = Renderer::get();
+  // The skin expansion is painted outside of the rect.
+  int expand = skin_element ? std::max(int(skin_element->expand), 0) : 0;
+  Rect layer_rect = Rect(0, 0, m_rect.w, m_rect.h).Expand(expand, expand);
+  ColdData* cold_data = cold();
+  if (!cold_data->layer) {
+    cold_data->layer = std::make_unique<Layer>();
+  }
+  Layer* layer = cold_data->layer.get();
+  if (!layer->ReserveTarget(layer_rect.w, layer_rect.h)) {
+    return false;
+  }
+  if (!layer->is_valid || !layer->rect.equals(layer_rect) ||
+      layer->text_color != parent_paint_props.text_color) {
+    util::Counters::Add(util::Counter::kLayersPainted);
+    // Set before painting, so anything invalidated while painting is painted
+    // again next time.
+    layer->is_valid = true;
+    layer->rect = layer_rect;
+    layer->text_color = parent_paint_props.text_color;
+    renderer->BeginRenderTarget(layer->target.get());
+    renderer->Translate(-layer_rect.x, -layer_rect.y);
+    PaintContent(parent_paint_props, state, skin_element);
+    renderer->EndRenderTarget();
+  }
+  float old_opacity = renderer->opacity();
+  renderer->set_opacity(opacity);
+  renderer->DrawRenderTarget(layer_rect.Offset(m_rect.x, m_rect.y),
+                             Rect(0, 0, layer_rect.w, layer_rect.h),
+                             layer->target.get());
+  renderer->set_opacity(old_opacity);
+  return true;
+}
+
+void Element::PaintContent(const PaintProps& parent_paint_props, State state,
+                           SkinElement* skin_element) {
   // Paint background skin.
   Rect local_rect(0, 0, m_rect.w, m_rect.h);
   ElementSkinConditionContext context(this);
@@ -1443,9 +1829,6 @@ void Element::InvokePaint(const PaintProps& parent_paint_props) {
     Renderer::get()->Translate(-used_element->content_ofs_x,
                                -used_element->content_ofs_y);
   }
-
-  Renderer::get()->Translate(-trns_x, -trns_y);
-  Renderer::get()->set_opacity(old_opacity);
 }
 
 bool Element::InvokeEvent(Event ev) {
@@ -1465,7 +1848,9 @@ bool Element::InvokeEvent(Event ev) {
 
   if (ev.type == EventType::kChanged) {
     InvalidateSkinStates();
-    m_connection.SyncFromElement(this);
+    if (m_cold) {
+      m_cold->connection.SyncFromElement(this);
+    }
   }
 
   if (!this_element.get()) {
@@ -1497,10 +1882,14 @@ bool Element::InvokeEvent(Event ev) {
 
 void Element::StartLongClickTimer(bool touch) {
   StopLongClickTimer();
-  m_long_click_timer = std::make_unique<LongClickTimer>(this, touch);
+  cold()->long_click_timer = std::make_unique<LongClickTimer>(this, touch);
 }
 
-void Element::StopLongClickTimer() { m_long_click_timer.reset(); }
+void Element::StopLongClickTimer() {
+  if (m_cold) {
+    m_cold->long_click_timer.reset();
+  }
+}
 
 bool Element::InvokePointerDown(int x, int y, int click_count,
                                 ModifierKeys modifierkeys, bool touch) {
@@ -1529,11 +1918,12 @@ bool Element::InvokePointerDown(int x, int y, int click_count,
     // Check if there's any started scroller that should be stopped.
     Element* tmp = captured_element;
     while (tmp) {
-      if (tmp->m_scroller && tmp->m_scroller->is_started()) {
+      auto cold = tmp->m_cold.get();
+      if (cold && cold->scroller && cold->scroller->is_started()) {
         // When we touch down to stop a scroller, we don't
         // want the touch to end up causing a click.
         cancel_click = true;
-        tmp->m_scroller->Stop();
+        cold->scroller->Stop();
         break;
       }
       tmp = tmp->parent();
@@ -1873,14 +2263,14 @@ void Element::SetCapturedElement(Element* element) {
 }
 
 bool Element::set_font_description(const FontDescription& font_desc) {
-  if (m_font_desc == font_desc) return true;
+  if (font_description() == font_desc) return true;
 
   // Set the font description only if we have a matching font, or succeed
   // creating one.
   if (text::FontManager::get()->HasFontFace(font_desc)) {
-    m_font_desc = font_desc;
+    cold()->font_desc = font_desc;
   } else if (text::FontManager::get()->CreateFontFace(font_desc)) {
-    m_font_desc = font_desc;
+    cold()->font_desc = font_desc;
   } else {
     return false;
   }
@@ -1894,7 +2284,7 @@ void Element::InvokeFontChanged() {
 
   // Recurse to children that inherit the font.
   for (Element* child = first_child(); child; child = child->GetNext()) {
-    if (child->m_font_desc.font_face_id() == 0) {
+    if (child->font_description().font_face_id() == 0) {
       child->InvokeFontChanged();
     }
   }
@@ -1903,8 +2293,8 @@ void Element::InvokeFontChanged() {
 FontDescription Element::computed_font_description() const {
   const Element* tmp = this;
   while (tmp) {
-    if (tmp->m_font_desc.font_face_id() != 0) {
-      return tmp->m_font_desc;
+    if (tmp->m_cold && tmp->m_cold->font_desc.font_face_id() != 0) {
+      return tmp->m_cold->font_desc;
     }
     tmp = tmp->m_parent;
   }
@@ -275,6 +275,11 @@ class Element : public util::TypedObject,
   Element();
   virtual ~Element();
 
+  // Elements are allocated through the ElementPool (if set), so deleting and
+  // creating elements reuses memory instead of going through the heap.
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr, size_t size);
+
   bool LoadFile(const char* filename);
   bool LoadData(const char* data_str, size_t data_length = std::string::npos);
   bool LoadData(std::string data_str) {
@@ -410,11 +415,30 @@ class Element : public util::TypedObject,
   // when clicking with the pointer.
   static void set_auto_focus_state(bool on);
 
+  // Sets whether OnPaintChildren should skip children that are fully covered
+  // by later siblings painting an opaque background skin (enabled by
+  // default). Only the element rect and its skin expansion is considered to be
+  // painted, so content painted outside of that (f.ex children placed outside
+  // of their parent) may be skipped too.
+  static void set_occlusion_culling(bool on) { occlusion_culling = on; }
+
   float opacity() const { return m_opacity; }
   // Sets opacity for this element and its children from 0.0 - 1.0.
   // If opacity is 0 (invisible), the element won't receive any input.
   void set_opacity(float opacity);
 
+  bool is_layer() const { return m_packed.is_layer; }
+  // Sets whether this element and its children should be painted into an
+  // offscreen render target, which is only repainted when something in it is
+  // invalidated and drawn from it otherwise. The opacity then applies to the
+  // element as a whole (so overlapping children don't show through each
+  // other), and changing the opacity or position doesn't repaint the
+  // children, at the cost of the memory of the render target. Content painted
+  // outside of the element rect and its skin expansion is cut off.
+  // It's only used if the renderer supports render targets (See
+  // graphics::Renderer::CreateRenderTarget).
+  void set_layer(bool layer);
+
   Visibility visibility() const;
   // Sets visibility for this element and its children.
   // If visibility is not Visibility::kVisible, the element won't receive any
@@ -423,11 +447,24 @@ class Element : public util::TypedObject,
 
   // Returns true if this element and all its ancestors are visible (has a
   // opacity > 0 and visibility Visibility::kVisible).
-  bool computed_visibility() const;
+  // The result is cached until any element changes in a way that may affect
+  // it (See InvalidateInheritedState), so it's usually not walking the
+  // ancestors.
+  bool computed_visibility() const {
+    if (m_inherited_generation != inherited_generation_) {
+      UpdateInheritedState();
+    }
+    return m_inherited_visible;
+  }
 
   // Returns false if this element or any of its parents are disabled (has state
-  // SkinState::kDisabled).
-  bool is_enabled() const;
+  // SkinState::kDisabled). Cached like computed_visibility.
+  bool is_enabled() const {
+    if (m_inherited_generation != inherited_generation_) {
+      UpdateInheritedState();
+    }
+    return m_inherited_enabled;
+  }
   // Sets whether the element is enabled (default) or disabled.
   void set_enabled(bool value) { set_state(Element::State::kDisabled, !value); }
 
@@ -463,6 +500,17 @@ class Element : public util::TypedObject,
   // animate. They will be instantly removed and deleted.
   void DeleteAllChildren();
 
+  // Removes child from this element and queues it for deletion at the start
+  // of the next frame (See ElementDeleteQueue). The child and its children
+  // won't paint or receive input after this call.
+  // NOTE: Like DeleteAllChildren, this won't invoke Die.
+  void DeleteChildDeferred(Element* child);
+
+  // Removes all children in this element and queues them for deletion like
+  // DeleteChildDeferred, invalidating this element only once. This is much
+  // faster than DeleteAllChildren for elements with many children.
+  void DeleteAllChildrenDeferred();
+
   // Sets the z-order of this element related to its siblings.
   // When a element is added with AddChild, it will be placed at the top in the
   // parent (Above previously added element). SetZ can be used to change the
@@ -872,11 +920,9 @@ class Element : public util::TypedObject,
   void set_text_format(const char* format, ...);
 
   // Gets the description string of this element. Used for tooltips.
-  virtual const std::string& tooltip() { return m_tooltip_str; }
+  virtual const std::string& tooltip();
   // Sets the description string for this element. Used for tooltips.
-  virtual void set_tooltip(const char* value) {
-    m_tooltip_str = value ? value : "";
-  }
+  virtual void set_tooltip(const char* value);
 
   // Connects this element to a element value.
   // When this element invoke EventType::kChanged, it will automatically update
@@ -884,10 +930,16 @@ class Element : public util::TypedObject,
   // to it.
   // On connection, the value of this element will be updated to the value of
   // the given ElementValue.
-  void Connect(ElementValue* value) { m_connection.Connect(value, this); }
+  void Connect(ElementValue* value) {
+    cold()->connection.Connect(value, this);
+  }
 
   // Disconnects, if this element is connected to a ElementValue.
-  void Disconnect() { m_connection.Disconnect(); }
+  void Disconnect() {
+    if (m_cold) {
+      m_cold->connection.Disconnect();
+    }
+  }
 
   // Gets the rectangle inside any padding, relative to this element.
   // This is the rectangle in which the content should be rendered.
@@ -917,6 +969,25 @@ class Element : public util::TypedObject,
     return GetPreferredSize(SizeConstraints());
   }
 
+  // Returns true if GetPreferredSize would return the cached preferred size
+  // for the given constraints without measuring.
+  bool is_preferred_size_cached(const SizeConstraints& constraints) const;
+
+  // Returns true if OnCalculatePreferredSize only changes this element and its
+  // children, so elements in separate subtrees can be measured on separate
+  // threads (See LayoutBox::set_parallel_measure_pool).
+  // The result must not change while the element is in a tree.
+  virtual bool is_measure_thread_safe() const { return true; }
+  // Returns true if is_measure_thread_safe is true for this element and all
+  // its descendants. The result is cached until children are added or removed
+  // within the subtree.
+  bool IsSubtreeMeasureThreadSafe() const;
+
+  // Returns true if children may be placed so that they overlap each other.
+  // If not, OnPaintChildren doesn't have to look for children covered by
+  // their siblings (See set_occlusion_culling).
+  virtual bool may_children_overlap() const { return true; }
+
   // Type used for InvalidateLayout.
   enum class InvalidationMode {
     kTargetOnly,  // InvalidationMode should not be recursively called on
@@ -944,7 +1015,9 @@ class Element : public util::TypedObject,
   // NOTE: the layout params has already been applied to the PreferredSize
   // returned from GetPreferredSize so you normally don't need to check these
   // params.
-  const LayoutParams* layout_params() const { return m_layout_params.get(); }
+  const LayoutParams* layout_params() const {
+    return m_cold ? m_cold->layout_params.get() : nullptr;
+  }
   // Sets layout params. Calls InvalidateLayout.
   void set_layout_params(const LayoutParams& lp);
 
@@ -1013,7 +1086,9 @@ class Element : public util::TypedObject,
   // Gets the font description as set with SetFontDescription.
   // Use computed_font_description() to get the calculated font description
   // (inherit from parent element, etc).
-  FontDescription font_description() const { return m_font_desc; }
+  FontDescription font_description() const {
+    return m_cold ? m_cold->font_desc : FontDescription();
+  }
 
   // Calculates the font description for this element.
   // If this element have unspecified font description, it will be inheritted
@@ -1037,6 +1112,58 @@ class Element : public util::TypedObject,
 
  private:
   friend class ElementListener;
+
+  // The render target of an element painted as a layer (See set_layer).
+  struct Layer;
+
+  // State that most elements never use, allocated on first use by cold() so
+  // the fields touched when walking the tree (painting, layout, hit testing)
+  // are packed in fewer cache lines.
+  struct ColdData {
+    ElementValueConnection connection;
+    util::IntrusiveList<ElementListener> listeners;
+    util::IntrusiveList<EventHandler> event_handlers;
+    FontDescription font_desc;
+    std::unique_ptr<LayoutParams> layout_params;
+    std::unique_ptr<elements::parts::Scroller> scroller;
+    std::unique_ptr<LongClickTimer> long_click_timer;
+    std::unique_ptr<Layer> layer;
+    std::string tooltip_str;
+  };
+
+  // Gets the cold state, allocating it if needed.
+  ColdData* cold();
+
+  // Returns true if the cached preferred size is valid for the given
+  // constraints (already constrained by the layout params).
+  bool IsCachedPreferredSizeValid(const SizeConstraints& constraints) const;
+
+  // Invalidates like Invalidate, but keeps the painted layer of this element
+  // (See set_layer), for changes that only affect how the layer is drawn.
+  void InvalidateComposite();
+
+  // Updates the cached results of computed_visibility and is_enabled, and
+  // those of the ancestors as needed.
+  void UpdateInheritedState() const;
+  // Makes all elements update the cached results of computed_visibility and
+  // is_enabled when next asked. Called when the visibility, opacity, disabled
+  // state or parent of any element changes.
+  static void InvalidateInheritedState() {
+    // Generation 0 is reserved for elements that never updated.
+    if (++inherited_generation_ == 0) {
+      inherited_generation_ = 1;
+    }
+  }
+
+  // Makes this element and its ancestors check IsSubtreeMeasureThreadSafe
+  // again when next asked. Called when the children change.
+  void InvalidateSubtreeMeasureThreadSafe();
+
+  // Removes child like RemoveChild, but without invalidating this element.
+  void DetachChild(Element* child, InvokeInfo info);
+  // Prepares a removed element for being queued for deferred deletion.
+  static void QueueForDeletion(Element* element);
+
   Element* m_parent = nullptr;
   TBID m_id;                // ID for GetElementById and others.
   TBID m_group_id;          // ID for button groups (such as RadioButton)
@@ -1047,21 +1174,25 @@ class Element : public util::TypedObject,
   // The rectangle of this element, relative to the parent. See set_rect.
   Rect m_rect;
   util::IntrusiveList<Element> m_children;
-  ElementValueConnection m_connection;
-  util::IntrusiveList<ElementListener> m_listeners;
-  util::IntrusiveList<EventHandler> event_handlers_;
   // Opacity 0-1. See SetOpacity.
   float m_opacity = 1.0f;
   // The element state (excluding any auto states).
   State m_state = State::kNone;
   Gravity m_gravity = Gravity::kDefault;
-  FontDescription m_font_desc;
   PreferredSize m_cached_ps;    // Cached preferred size.
   SizeConstraints m_cached_sc;  // Cached size constraints.
-  std::unique_ptr<LayoutParams> m_layout_params;
-  std::unique_ptr<elements::parts::Scroller> m_scroller;
-  std::unique_ptr<LongClickTimer> m_long_click_timer;
-  std::string m_tooltip_str;
+  std::unique_ptr<ColdData> m_cold;
+  // Cached results of computed_visibility and is_enabled, valid while
+  // m_inherited_generation matches inherited_generation_.
+  mutable uint32_t m_inherited_generation = 0;
+  mutable bool m_inherited_visible = true;
+  mutable bool m_inherited_enabled = true;
+  // Cached result of IsSubtreeMeasureThreadSafe, if
+  // m_is_subtree_measure_thread_safe_valid.
+  mutable bool m_is_subtree_measure_thread_safe_valid = false;
+  mutable bool m_is_subtree_measure_thread_safe = true;
+  // Bumped by InvalidateInheritedState.
+  static uint32_t inherited_generation_;
   union {
     struct {
       uint16_t is_group_root : 1;
@@ -1077,6 +1208,8 @@ class Element : public util::TypedObject,
       uint16_t visibility : 2;
       uint16_t inflate_child_z : 1;  // Should have enough bits to hold ElementZ
                                      // values.
+      uint16_t is_occluded : 1;  // Set by the parents MarkOccludedChildren.
+      uint16_t is_layer : 1;
     } m_packed;
     uint16_t m_packed_init = 0;
   };
@@ -1117,6 +1250,8 @@ class Element : public util::TypedObject,
   static bool update_skin_states;
   // true if the focused state should be painted automatically.
   static bool show_focus_state;
+  // true if children covered by opaque siblings are skipped when painting.
+  static bool occlusion_culling;
 
   static void SetIdFromNode(TBID* id, parsing::ParseNode* node);
 
@@ -1140,6 +1275,19 @@ class Element : public util::TypedObject,
   // Returns the opacity for this element multiplied with its skin opacity and
   // state opacity.
   float CalculateOpacityInternal(State state, SkinElement* skin_element) const;
+  // Paints the background skin, content and children of this element, at its
+  // origin.
+  void PaintContent(const PaintProps& parent_paint_props, State state,
+                    SkinElement* skin_element);
+  // Draws this element from its layer with the given opacity, painting it
+  // into the layer first if invalidated.
+  // Returns false if the renderer doesn't support render targets.
+  bool PaintLayer(const PaintProps& parent_paint_props, State state,
+                  SkinElement* skin_element, float opacity);
+  // Sets is_occluded on the children within clip_rect that are covered by
+  // later siblings painting an opaque background skin.
+  // Returns true if any child was occluded.
+  bool MarkOccludedChildren(const Rect& clip_rect);
 };
 
 // Gets this element or any child element with a matching id, or nullptr if
@@ -7,6 +7,8 @@
  ******************************************************************************
  */
 
+#include <unordered_map>
+
 #include "el/animation_manager.h"
 #include "el/element.h"
 #include "el/element_animation.h"
@@ -16,7 +18,8 @@ namespace el {
 
 using el::util::SafeCast;
 
-extern util::IntrusiveList<ElementAnimation> element_animations;
+extern std::unordered_map<Element*, util::IntrusiveList<ElementAnimation>>
+    element_animations;
 
 inline float Lerp(float src, float dst, float progress) {
   return src + (dst - src) * progress;
@@ -25,10 +28,38 @@ inline float Lerp(float src, float dst, float progress) {
 const float ElementAnimation::kAlmostZeroOpacity = 0.001f;
 
 ElementAnimation::ElementAnimation(Element* element) : m_element(element) {
-  element_animations.AddLast(this);
+  element_animations[element].AddLast(this);
 }
 
-ElementAnimation::~ElementAnimation() { element_animations.Remove(this); }
+ElementAnimation::~ElementAnimation() {
+  element_animations[m_element].Remove(this);
+}
+
+void ElementAnimation::BeginLayer() {
+  if (m_element->is_layer() || !m_element->first_child()) {
+    return;
+  }
+  m_element->set_layer(true);
+  m_owns_layer = true;
+}
+
+void ElementAnimation::EndLayer() {
+  if (!m_owns_layer) {
+    return;
+  }
+  m_owns_layer = false;
+  auto iter = element_animations[m_element].IterateForward();
+  while (ElementAnimation* wao = iter.GetAndStep()) {
+    if (wao != this && wao->is_animating()) {
+      wao->m_owns_layer = true;
+      return;
+    }
+  }
+  // No need to repaint an element that is about to be deleted.
+  if (!m_element->is_dying()) {
+    m_element->set_layer(false);
+  }
+}
 
 OpacityElementAnimation::OpacityElementAnimation(Element* element,
                                                  float src_opacity,
@@ -43,6 +74,7 @@ void OpacityElementAnimation::OnAnimationStart() {
   // FIX: fix this properly
   m_element->Invalidate();
 
+  BeginLayer();
   m_element->set_opacity(m_src_opacity);
 }
 
@@ -58,6 +90,7 @@ void OpacityElementAnimation::OnAnimationStop(bool aborted) {
     if (the_element.get()) delete the_element.get();
   } else {
     m_element->set_opacity(m_dst_opacity);
+    EndLayer();
   }
 }
 
@@ -83,6 +116,15 @@ void RectElementAnimation::OnAnimationStart() {
   if (m_mode == Mode::kSrcToDest) {
     m_element->set_rect(m_src_rect);
   }
+  // Moving the element only redraws the layer, but it must be repainted if
+  // it's resized.
+  bool is_resizing = m_mode == Mode::kSrcToDest
+                         ? m_src_rect.w != m_dst_rect.w ||
+                               m_src_rect.h != m_dst_rect.h
+                         : m_delta_rect.w != 0 || m_delta_rect.h != 0;
+  if (!is_resizing) {
+    BeginLayer();
+  }
 }
 
 void RectElementAnimation::OnAnimationUpdate(float progress) {
@@ -124,6 +166,7 @@ void RectElementAnimation::OnAnimationStop(bool aborted) {
     // m_dst_rect may still be unset if aborted.
     m_element->set_rect(m_dst_rect);
   }
+  EndLayer();
 }
 
 }  // namespace el
@@ -35,6 +35,19 @@ class ElementAnimation : public Animation,
 
  public:
   Element* m_element;
+
+ protected:
+  // Makes the element a layer while animating, so animating the opacity or
+  // position doesn't repaint its children each frame (See
+  // Element::set_layer). Elements without children gain nothing from it and
+  // are left as they are.
+  void BeginLayer();
+  // Reverts BeginLayer, unless another animation of the element is still
+  // running and can take over the layer.
+  void EndLayer();
+
+ private:
+  bool m_owns_layer = false;
 };
 
 // Animates the opacity of the target element.
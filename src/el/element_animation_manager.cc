@@ -7,6 +7,8 @@
  ******************************************************************************
  */
 
+#include <unordered_map>
+
 #include "el/animation_manager.h"
 #include "el/element.h"
 #include "el/element_animation.h"
@@ -19,17 +21,23 @@ namespace el {
 
 using el::util::SafeCast;
 
-util::IntrusiveList<ElementAnimation> element_animations;
+// The animations of each element, so aborting the animations of an element
+// doesn't have to look through all element animations.
+std::unordered_map<Element*, util::IntrusiveList<ElementAnimation>>
+    element_animations;
 ElementAnimationManager elements_animation_manager;
 
 void ElementAnimationManager::Init() {
-  assert(!element_animations.HasLinks());
+  assert(element_animations.empty());
   ElementListener::AddGlobalListener(&elements_animation_manager);
 }
 
 void ElementAnimationManager::Shutdown() {
   ElementListener::RemoveGlobalListener(&elements_animation_manager);
-  assert(!element_animations.HasLinks());
+  for (auto& it : element_animations) {
+    assert(!it.second.HasLinks());
+  }
+  element_animations.clear();
 }
 
 void ElementAnimationManager::AbortAnimations(Element* element) {
@@ -38,23 +46,30 @@ void ElementAnimationManager::AbortAnimations(Element* element) {
 
 void ElementAnimationManager::AbortAnimations(Element* element,
                                               util::tb_type_id_t type_id) {
-  auto iter = element_animations.IterateForward();
+  auto animations = element_animations.find(element);
+  if (animations == element_animations.end()) {
+    return;
+  }
+  auto iter = animations->second.IterateForward();
   while (ElementAnimation* wao = iter.GetAndStep()) {
-    if (wao->m_element == element) {
-      // Skip this animation if we asked for a specific (and
-      // different) animation type.
-      if (type_id != nullptr && !wao->IsOfTypeId(type_id)) continue;
+    // Skip this animation if we asked for a specific (and
+    // different) animation type.
+    if (type_id != nullptr && !wao->IsOfTypeId(type_id)) continue;
 
-      // Abort the animation. This will both autoremove itself
-      // and delete it, so no need to do it here.
-      AnimationManager::AbortAnimation(wao, true);
-    }
+    // Abort the animation. This will both autoremove itself
+    // and delete it, so no need to do it here.
+    AnimationManager::AbortAnimation(wao, true);
   }
 }
 
 void ElementAnimationManager::OnElementDelete(Element* element) {
   // Kill and delete all animations running for the element being deleted.
   AbortAnimations(element);
+  auto animations = element_animations.find(element);
+  if (animations != element_animations.end() &&
+      !animations->second.HasLinks()) {
+    element_animations.erase(animations);
+  }
 }
 
 bool ElementAnimationManager::OnElementDying(Element* element) {
@@ -0,0 +1,50 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <cassert>
+
+#include "el/element.h"
+#include "el/element_delete_queue.h"
+#include "el/util/metrics.h"
+
+namespace el {
+
+std::unique_ptr<ElementDeleteQueue> ElementDeleteQueue::delete_queue_singleton_;
+
+ElementDeleteQueue::ElementDeleteQueue() = default;
+
+ElementDeleteQueue::~ElementDeleteQueue() { FlushAll(); }
+
+void ElementDeleteQueue::Add(Element* element) {
+  assert(!element->parent());
+  m_elements.push_back(element);
+}
+
+size_t ElementDeleteQueue::Flush() { return FlushInternal(m_budget_ms); }
+
+size_t ElementDeleteQueue::FlushAll() { return FlushInternal(0); }
+
+size_t ElementDeleteQueue::FlushInternal(uint32_t budget_ms) {
+  uint64_t end_time = budget_ms ? util::GetTimeMS() + budget_ms : 0;
+  size_t deleted_count = 0;
+  // Destructors may queue more elements, which are then deleted in the same
+  // flush.
+  while (!m_elements.empty()) {
+    Element* element = m_elements.front();
+    m_elements.pop_front();
+    delete element;
+    ++deleted_count;
+    if (end_time && util::GetTimeMS() >= end_time) {
+      break;
+    }
+  }
+  return deleted_count;
+}
+
+}  // namespace el
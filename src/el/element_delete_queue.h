@@ -0,0 +1,77 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#ifndef EL_ELEMENT_DELETE_QUEUE_H_
+#define EL_ELEMENT_DELETE_QUEUE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+namespace el {
+
+class Element;
+
+// Holds elements that have been removed from the tree but not yet deleted.
+// Element::DeleteChildDeferred and DeleteAllChildrenDeferred remove elements
+// immediately (so they won't paint or receive input) and queue them here, and
+// the destructors run in a batch when the root element is processed at the
+// start of the next frame (See Element::InvokeProcess).
+//
+// A time budget per frame may be set, so tearing down huge forms is spread over
+// several frames instead of stalling one. The budget is checked between queued
+// elements, so a single queued element is always deleted with all its children
+// at once.
+class ElementDeleteQueue {
+ public:
+  static ElementDeleteQueue* get() { return delete_queue_singleton_.get(); }
+  static void set(std::unique_ptr<ElementDeleteQueue> value) {
+    delete_queue_singleton_ = std::move(value);
+  }
+
+  ElementDeleteQueue();
+  // Deletes all elements still in the queue.
+  ~ElementDeleteQueue();
+
+  // Adds an element that has been removed from its parent. It's marked as
+  // dying, and will be deleted by the next Flush.
+  void Add(Element* element);
+
+  bool empty() const { return m_elements.empty(); }
+  size_t size() const { return m_elements.size(); }
+
+  // Gets the time budget per Flush in milliseconds (0 means no limit).
+  uint32_t budget_ms() const { return m_budget_ms; }
+  // Sets the time budget per Flush in milliseconds. 0 (the default) deletes
+  // all queued elements in each Flush.
+  void set_budget_ms(uint32_t budget_ms) { m_budget_ms = budget_ms; }
+
+  // Deletes queued elements in the order they were added, until the queue is
+  // empty or the time budget is used up. At least one element is deleted per
+  // call, so the queue always drains.
+  // Returns the number of queued elements deleted.
+  size_t Flush();
+
+  // Deletes all queued elements, ignoring the time budget.
+  // Returns the number of queued elements deleted.
+  size_t FlushAll();
+
+ private:
+  size_t FlushInternal(uint32_t budget_ms);
+
+  static std::unique_ptr<ElementDeleteQueue> delete_queue_singleton_;
+
+  std::deque<Element*> m_elements;
+  uint32_t m_budget_ms = 0;
+};
+
+}  // namespace el
+
+#endif  // EL_ELEMENT_DELETE_QUEUE_H_
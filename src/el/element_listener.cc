@@ -24,9 +24,11 @@ void ElementListener::RemoveGlobalListener(ElementListener* listener) {
 
 void ElementListener::InvokeElementDelete(Element* element) {
   auto global_i = g_listeners.IterateForward();
-  auto local_i = element->m_listeners.IterateForward();
-  while (ElementListener* listener = local_i.GetAndStep()) {
-    listener->OnElementDelete(element);
+  if (element->m_cold) {
+    auto local_i = element->m_cold->listeners.IterateForward();
+    while (ElementListener* listener = local_i.GetAndStep()) {
+      listener->OnElementDelete(element);
+    }
   }
   while (ElementListenerGlobalLink* link = global_i.GetAndStep()) {
     static_cast<ElementListener*>(link)->OnElementDelete(element);
@@ -36,9 +38,11 @@ void ElementListener::InvokeElementDelete(Element* element) {
 bool ElementListener::InvokeElementDying(Element* element) {
   bool handled = false;
   auto global_i = g_listeners.IterateForward();
-  auto local_i = element->m_listeners.IterateForward();
-  while (ElementListener* listener = local_i.GetAndStep()) {
-    handled |= listener->OnElementDying(element);
+  if (element->m_cold) {
+    auto local_i = element->m_cold->listeners.IterateForward();
+    while (ElementListener* listener = local_i.GetAndStep()) {
+      handled |= listener->OnElementDying(element);
+    }
   }
   while (ElementListenerGlobalLink* link = global_i.GetAndStep()) {
     handled |= static_cast<ElementListener*>(link)->OnElementDying(element);
@@ -48,9 +52,11 @@ bool ElementListener::InvokeElementDying(Element* element) {
 
 void ElementListener::InvokeElementAdded(Element* parent, Element* child) {
   auto global_i = g_listeners.IterateForward();
-  auto local_i = parent->m_listeners.IterateForward();
-  while (ElementListener* listener = local_i.GetAndStep()) {
-    listener->OnElementAdded(parent, child);
+  if (parent->m_cold) {
+    auto local_i = parent->m_cold->listeners.IterateForward();
+    while (ElementListener* listener = local_i.GetAndStep()) {
+      listener->OnElementAdded(parent, child);
+    }
   }
   while (ElementListenerGlobalLink* link = global_i.GetAndStep()) {
     static_cast<ElementListener*>(link)->OnElementAdded(parent, child);
@@ -59,9 +65,11 @@ void ElementListener::InvokeElementAdded(Element* parent, Element* child) {
 
 void ElementListener::InvokeElementRemove(Element* parent, Element* child) {
   auto global_i = g_listeners.IterateForward();
-  auto local_i = parent->m_listeners.IterateForward();
-  while (ElementListener* listener = local_i.GetAndStep()) {
-    listener->OnElementRemove(parent, child);
+  if (parent->m_cold) {
+    auto local_i = parent->m_cold->listeners.IterateForward();
+    while (ElementListener* listener = local_i.GetAndStep()) {
+      listener->OnElementRemove(parent, child);
+    }
   }
   while (ElementListenerGlobalLink* link = global_i.GetAndStep()) {
     static_cast<ElementListener*>(link)->OnElementRemove(parent, child);
@@ -71,9 +79,11 @@ void ElementListener::InvokeElementRemove(Element* parent, Element* child) {
 void ElementListener::InvokeElementFocusChanged(Element* element,
                                                 bool focused) {
   auto global_i = g_listeners.IterateForward();
-  auto local_i = element->m_listeners.IterateForward();
-  while (ElementListener* listener = local_i.GetAndStep()) {
-    listener->OnElementFocusChanged(element, focused);
+  if (element->m_cold) {
+    auto local_i = element->m_cold->listeners.IterateForward();
+    while (ElementListener* listener = local_i.GetAndStep()) {
+      listener->OnElementFocusChanged(element, focused);
+    }
   }
   while (ElementListenerGlobalLink* link = global_i.GetAndStep()) {
     static_cast<ElementListener*>(link)
@@ -85,9 +95,11 @@ bool ElementListener::InvokeElementInvokeEvent(Element* element,
                                                const Event& ev) {
   bool handled = false;
   auto global_i = g_listeners.IterateForward();
-  auto local_i = element->m_listeners.IterateForward();
-  while (ElementListener* listener = local_i.GetAndStep()) {
-    handled |= listener->OnElementInvokeEvent(element, ev);
+  if (element->m_cold) {
+    auto local_i = element->m_cold->listeners.IterateForward();
+    while (ElementListener* listener = local_i.GetAndStep()) {
+      handled |= listener->OnElementInvokeEvent(element, ev);
+    }
   }
   while (ElementListenerGlobalLink* link = global_i.GetAndStep()) {
     handled |=
@@ -0,0 +1,102 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <algorithm>
+
+#include "el/element_pool.h"
+
+namespace el {
+
+std::unique_ptr<ElementPool> ElementPool::element_pool_singleton_;
+
+ElementPool::ElementPool()
+    : m_free_lists(kMaxPooledSize / kGranularity + 1) {}
+
+ElementPool::~ElementPool() { Trim(); }
+
+void* ElementPool::Allocate(size_t size) {
+  size = block_size(size);
+  ++m_stats.live_count;
+  if (size <= kMaxPooledSize) {
+    auto& free_list = m_free_lists[size / kGranularity];
+    if (!free_list.empty()) {
+      void* ptr = free_list.back();
+      free_list.pop_back();
+      --m_stats.pooled_count;
+      m_stats.pooled_bytes -= size;
+      ++m_stats.hit_count;
+      return ptr;
+    }
+  }
+  ++m_stats.miss_count;
+  return ::operator new(size);
+}
+
+void ElementPool::Release(void* ptr, size_t size) {
+  size = block_size(size);
+  // Elements allocated before the pool was set aren't counted as live.
+  if (m_stats.live_count) {
+    --m_stats.live_count;
+  }
+  if (size <= kMaxPooledSize) {
+    auto& free_list = m_free_lists[size / kGranularity];
+    if (free_list.size() < m_max_pooled_per_size) {
+      free_list.push_back(ptr);
+      ++m_stats.pooled_count;
+      m_stats.pooled_bytes += size;
+      return;
+    }
+  }
+  ::operator delete(ptr);
+}
+
+void ElementPool::Reserve(size_t size, size_t count) {
+  size = block_size(size);
+  if (size > kMaxPooledSize) {
+    return;
+  }
+  auto& free_list = m_free_lists[size / kGranularity];
+  count = std::min(count, m_max_pooled_per_size);
+  while (free_list.size() < count) {
+    free_list.push_back(::operator new(size));
+    ++m_stats.pooled_count;
+    m_stats.pooled_bytes += size;
+  }
+}
+
+void ElementPool::Trim() {
+  for (auto& free_list : m_free_lists) {
+    for (void* ptr : free_list) {
+      ::operator delete(ptr);
+    }
+    free_list.clear();
+  }
+  m_stats.pooled_count = 0;
+  m_stats.pooled_bytes = 0;
+}
+
+void ElementPool::set_max_pooled_per_size(size_t count) {
+  m_max_pooled_per_size = count;
+  for (size_t i = 0; i < m_free_lists.size(); ++i) {
+    auto& free_list = m_free_lists[i];
+    while (free_list.size() > count) {
+      ::operator delete(free_list.back());
+      free_list.pop_back();
+      --m_stats.pooled_count;
+      m_stats.pooled_bytes -= i * kGranularity;
+    }
+  }
+}
+
+void ElementPool::ResetStats() {
+  m_stats.hit_count = 0;
+  m_stats.miss_count = 0;
+}
+
+}  // namespace el
@@ -0,0 +1,105 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#ifndef EL_ELEMENT_POOL_H_
+#define EL_ELEMENT_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace el {
+
+// Recycles the memory of deleted elements.
+// Element overrides operator new and delete to go through the pool when one is
+// set, so elements created by ElementFactory inflation, by the built in
+// elements (menus, tooltips, message form buttons, list rows...) or directly
+// with new all reuse the memory of deleted elements of the same size class.
+// Construction always runs the element constructor, so a recycled element is
+// in exactly the same state as a newly allocated one.
+//
+// The pool is not thread safe, and must only be used from the UI thread.
+class ElementPool {
+ public:
+  static ElementPool* get() { return element_pool_singleton_.get(); }
+  static void set(std::unique_ptr<ElementPool> value) {
+    element_pool_singleton_ = std::move(value);
+  }
+
+  // Allocations are rounded up to a multiple of this.
+  static const size_t kGranularity = 16;
+  // Allocations larger than this are never pooled.
+  static const size_t kMaxPooledSize = 4096;
+
+  struct Stats {
+    // Number of allocations served from pooled memory.
+    uint64_t hit_count = 0;
+    // Number of allocations that had to allocate new memory.
+    uint64_t miss_count = 0;
+    // Number of blocks currently allocated through the pool.
+    size_t live_count = 0;
+    // Number of free blocks kept for reuse, and their total size.
+    size_t pooled_count = 0;
+    size_t pooled_bytes = 0;
+
+    // Gets the fraction of allocations served from pooled memory (0-1).
+    double hit_rate() const {
+      uint64_t total = hit_count + miss_count;
+      return total ? double(hit_count) / double(total) : 0.0;
+    }
+  };
+
+  ElementPool();
+  ~ElementPool();
+
+  // Gets the size of the block allocated for an object of the given size.
+  static size_t block_size(size_t size) {
+    return (size + kGranularity - 1) & ~(kGranularity - 1);
+  }
+
+  // Allocates memory for an object of the given size.
+  void* Allocate(size_t size);
+  // Releases memory allocated with Allocate for an object of the given size.
+  // It's kept for reuse unless the pool for its size class is full.
+  void Release(void* ptr, size_t size);
+
+  // Makes sure there are at least count free blocks for elements of type T,
+  // f.ex before inflating many list rows.
+  template <typename T>
+  void Reserve(size_t count) {
+    Reserve(sizeof(T), count);
+  }
+  void Reserve(size_t size, size_t count);
+
+  // Frees all pooled blocks.
+  void Trim();
+
+  // Gets the maximum number of free blocks kept per size class.
+  size_t max_pooled_per_size() const { return m_max_pooled_per_size; }
+  // Sets the maximum number of free blocks kept per size class. Blocks beyond
+  // the limit are freed.
+  void set_max_pooled_per_size(size_t count);
+
+  const Stats& stats() const { return m_stats; }
+  // Resets the hit and miss counts.
+  void ResetStats();
+
+ private:
+  static std::unique_ptr<ElementPool> element_pool_singleton_;
+
+  // Free blocks by size class (block_size / kGranularity).
+  std::vector<std::vector<void*>> m_free_lists;
+  size_t m_max_pooled_per_size = 256;
+  Stats m_stats;
+};
+
+}  // namespace el
+
+#endif  // EL_ELEMENT_POOL_H_
@@ -12,9 +12,9 @@
 
 #include <memory>
 #include <string>
-#include <unordered_map>
 
 #include "el/id.h"
+#include "el/util/id_map.h"
 #include "el/util/intrusive_list.h"
 #include "el/value.h"
 
@@ -150,7 +150,7 @@ class ElementValueGroup {
 
   static ElementValueGroup value_group_singleton_;
 
-  std::unordered_map<uint32_t, std::unique_ptr<ElementValue>> m_values;
+  util::IdMap<std::unique_ptr<ElementValue>> m_values;
   util::IntrusiveList<ElementValueGroupListener> m_listeners;
 };
 
@@ -12,7 +12,10 @@
 #include "el/animation_manager.h"
 #include "el/config.h"
 #include "el/element_animation_manager.h"
+#include "el/element_delete_queue.h"
+#include "el/element_pool.h"
 #include "el/elemental_forms.h"
+#include "el/frame_scheduler.h"
 #include "el/graphics/image_manager.h"
 #include "el/parsing/element_factory.h"
 #include "el/skin.h"
@@ -33,6 +36,9 @@ bool Initialize(Renderer* renderer) {
 
   Renderer::set(renderer);
 
+  ElementPool::set(std::make_unique<ElementPool>());
+  ElementDeleteQueue::set(std::make_unique<ElementDeleteQueue>());
+  FrameScheduler::set(std::make_unique<FrameScheduler>());
   util::StringTable::set(std::make_unique<util::StringTable>());
   text::FontManager::set(std::make_unique<text::FontManager>());
   Skin::set(std::make_unique<Skin>());
@@ -54,6 +60,10 @@ void Shutdown() {
     return;
   }
 
+  // Delete queued elements while everything they may use still exists.
+  ElementDeleteQueue::set(nullptr);
+  FrameScheduler::set(nullptr);
+
   AnimationManager::AbortAllAnimations();
   ElementAnimationManager::Shutdown();
 
@@ -64,6 +74,7 @@ void Shutdown() {
   text::FontManager::set(nullptr);
   util::StringTable::set(nullptr);
   Renderer::set(nullptr);
+  ElementPool::set(nullptr);
 }
 
 bool is_initialized() { return parsing::ElementFactory::get() != nullptr; }
@@ -12,14 +12,19 @@
 #include "el/elements/layout_box.h"
 #include "el/parsing/element_inflater.h"
 #include "el/skin.h"
+#include "el/util/counters.h"
 #include "el/util/debug.h"
 #include "el/util/metrics.h"
+#include "el/util/trace.h"
+#include "el/util/work_pool.h"
 
 namespace el {
 namespace elements {
 
 using graphics::Renderer;
 
+util::WorkPool* LayoutBox::parallel_measure_pool_ = nullptr;
+
 void LayoutBox::RegisterInflater() {
   EL_REGISTER_ELEMENT_INFLATER(LayoutBox, Value::Type::kNull, ElementZ::kTop);
 }
@@ -252,8 +257,45 @@ Element* LayoutBox::GetNextInLayoutOrder(Element* child) const {
   return m_packed.mode_reverse_order ? child->GetPrev() : child->GetNext();
 }
 
+void LayoutBox::MeasureChildrenInParallel(const SizeConstraints& inner_sc) {
+  // Layouts within subtrees already measured on the pool measure serially.
+  if (util::WorkPool::is_running_parallel()) {
+    return;
+  }
+  std::vector<Element*> children;
+  for (Element* child = GetFirstInLayoutOrder(); child;
+       child = GetNextInLayoutOrder(child)) {
+    if (child->visibility() != Visibility::kGone &&
+        !child->is_preferred_size_cached(inner_sc)) {
+      children.push_back(child);
+    }
+  }
+  // Only check thread safety (which walks the subtrees not checked since
+  // their children changed) if there's anything to run in parallel. Unsafe
+  // children are measured by the layout pass.
+  if (children.size() < 2) {
+    return;
+  }
+  children.erase(std::remove_if(children.begin(), children.end(),
+                                [](Element* child) {
+                                  return !child->IsSubtreeMeasureThreadSafe();
+                                }),
+                 children.end());
+  if (children.size() < 2) {
+    return;
+  }
+  EL_TRACE_ZONE("LayoutBox::MeasureChildrenInParallel");
+  // Update the cached inherited state of the ancestors, so elements asking for
+  // it while measuring only write to their own subtree.
+  computed_visibility();
+  parallel_measure_pool_->ParallelFor(
+      children.size(),
+      [&](size_t index) { children[index]->GetPreferredSize(inner_sc); });
+}
+
 void LayoutBox::ValidateLayout(const SizeConstraints& constraints,
                                PreferredSize* calculate_ps) {
+  EL_TRACE_ZONE("LayoutBox::ValidateLayout");
   // Layout notes:
   // - All layout code is written for Axis::kX layout.
   //   Instead of duplicating the layout code for both Axis::kX and Axis::kY, we
@@ -263,6 +305,7 @@ void LayoutBox::ValidateLayout(const SizeConstraints& constraints,
   if (!calculate_ps) {
     if (!m_packed.layout_is_invalid) return;
     m_packed.layout_is_invalid = 0;
+    util::Counters::Add(util::Counter::kLayouts);
   } else {
     // Maximum size will grow below depending of the childrens maximum size.
     calculate_ps->max_w = calculate_ps->max_h = 0;
@@ -275,6 +318,10 @@ void LayoutBox::ValidateLayout(const SizeConstraints& constraints,
   auto inner_sc = constraints.ConstrainByPadding(rect().w - padding_rect.w,
                                                  rect().h - padding_rect.h);
 
+  if (parallel_measure_pool_) {
+    MeasureChildrenInParallel(inner_sc);
+  }
+
   // Calculate totals for minimum and preferred width that we need for layout.
   int total_preferred_w = 0;
   int total_min_pref_diff_w = 0;
@@ -321,6 +368,7 @@ void LayoutBox::ValidateLayout(const SizeConstraints& constraints,
     *calculate_ps = GetRotatedPreferredSize(*calculate_ps, m_axis);
     return;
   }
+  m_layout_spacing = spacing;
 
   EL_IF_DEBUG_SETTING(util::DebugInfo::Setting::kLayoutSizing,
                       last_layout_time = util::GetTimeMS());
@@ -498,6 +546,12 @@ void LayoutBox::OnPaintChildren(const PaintProps& paint_props) {
   }
 }
 
+bool LayoutBox::may_children_overlap() const {
+  // Children are placed one after another along the axis, so they only
+  // overlap with negative spacing.
+  return m_layout_spacing < 0;
+}
+
 void LayoutBox::OnProcess() {
   SizeConstraints sc(rect().w, rect().h);
   ValidateLayout(sc);
@@ -16,6 +16,9 @@
 #include "el/types.h"
 
 namespace el {
+namespace util {
+class WorkPool;
+}  // namespace util
 namespace elements {
 
 // Specifies which height elements in a Axis::kX layout should have, or which
@@ -100,6 +103,19 @@ class LayoutBox : public Element {
 
   explicit LayoutBox(Axis axis = Axis::kX);
 
+  static util::WorkPool* parallel_measure_pool() {
+    return parallel_measure_pool_;
+  }
+  // Sets a pool used to measure the children of layouts in parallel, or
+  // nullptr to measure serially (the default). Children whose preferred size
+  // isn't cached are measured on the pool before the layout is calculated,
+  // if their subtrees are measure thread safe (See
+  // Element::is_measure_thread_safe). Measuring within those subtrees is
+  // serial. Does not take ownership.
+  static void set_parallel_measure_pool(util::WorkPool* pool) {
+    parallel_measure_pool_ = pool;
+  }
+
   Axis axis() const override { return m_axis; }
   // Sets along which axis the content should layout.
   void set_axis(Axis axis) override;
@@ -140,6 +156,7 @@ class LayoutBox : public Element {
   void OnInflate(const parsing::InflateInfo& info) override;
   bool OnEvent(const Event& ev) override;
   void OnPaintChildren(const PaintProps& paint_props) override;
+  bool may_children_overlap() const override;
   void OnProcess() override;
   void OnResized(int old_w, int old_h) override;
   void OnInflateChild(Element* child) override;
@@ -158,11 +175,18 @@ class LayoutBox : public Element {
   int CalculateSpacing();
   Element* GetFirstInLayoutOrder() const;
   Element* GetNextInLayoutOrder(Element* child) const;
+  // Measures the children that need it on the parallel measure pool, so the
+  // layout pass finds their preferred sizes cached.
+  void MeasureChildrenInParallel(const SizeConstraints& inner_sc);
+
+  static util::WorkPool* parallel_measure_pool_;
 
   Axis m_axis = Axis::kX;
   int m_spacing = kSpacingFromSkin;
   int m_overflow = 0;
   int m_overflow_scroll = 0;
+  // The spacing the children were placed with by the last layout.
+  int m_layout_spacing = 0;
   union {
     struct {
       uint32_t layout_is_invalid : 1;
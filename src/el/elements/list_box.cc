@@ -13,6 +13,7 @@
 #include "el/elements/label.h"
 #include "el/elements/list_box.h"
 #include "el/elements/menu_form.h"
+#include "el/frame_scheduler.h"
 #include "el/parsing/element_inflater.h"
 #include "el/util/string.h"
 #include "el/util/string_table.h"
@@ -133,8 +134,15 @@ void ListBox::InvalidateList() {
 }
 
 void ListBox::ValidateList() {
-  if (!m_list_is_invalid) return;
+  if (!m_list_is_invalid) {
+    if (is_populating()) {
+      CreatePendingItems();
+    }
+    return;
+  }
   m_list_is_invalid = false;
+  m_pending_items.clear();
+  m_next_pending_item = 0;
   // FIX: Could delete and create only the changed items (faster filter change).
 
   // Remove old items.
@@ -183,9 +191,28 @@ void ListBox::ValidateList() {
   }
 
   // Create new items.
-  for (int i = 0; i < num_sorted_items; ++i) {
-    CreateAndAddItemAfter(sorted_index[i], nullptr);
+  sorted_index.resize(num_sorted_items);
+  m_pending_items = std::move(sorted_index);
+  CreatePendingItems();
+}
+
+void ListBox::CreatePendingItems() {
+  // Always make some progress, but leave the rest for the next frame if the
+  // frame budget is used up.
+  const size_t kMinItemsPerFrame = 16;
+  FrameScheduler* scheduler = FrameScheduler::get();
+  size_t created_count = 0;
+  while (m_next_pending_item < m_pending_items.size()) {
+    if (created_count >= kMinItemsPerFrame && scheduler &&
+        scheduler->ShouldYield()) {
+      Invalidate();
+      return;
+    }
+    CreateAndAddItemAfter(m_pending_items[m_next_pending_item++], nullptr);
+    ++created_count;
   }
+  m_pending_items.clear();
+  m_next_pending_item = 0;
 
   ListItem(m_value, true);
 
@@ -243,7 +270,7 @@ Element* ListBox::GetItemElement(size_t index) {
 }
 
 void ListBox::ScrollToSelectedItem() {
-  if (m_list_is_invalid) {
+  if (m_list_is_invalid || is_populating()) {
     m_scroll_to_current = true;
     return;
   }
@@ -11,6 +11,7 @@
 #define EL_ELEMENTS_LIST_BOX_H_
 
 #include <string>
+#include <vector>
 
 #include "el/element.h"
 #include "el/elements/layout_box.h"
@@ -108,9 +109,19 @@ class ListBox : public Element, public ListItemObserver {
   bool m_list_is_invalid = false;
   bool m_scroll_to_current = false;
   TBID m_header_lng_string_id;
+  // Source indices of items that are still to be created, when the list is
+  // populated over several frames (See CreatePendingItems).
+  std::vector<int> m_pending_items;
+  size_t m_next_pending_item = 0;
 
  private:
   Element* CreateAndAddItemAfter(size_t index, Element* reference);
+  // Creates the pending items, or as many as fits in the frame budget of the
+  // FrameScheduler.
+  void CreatePendingItems();
+  bool is_populating() const {
+    return m_next_pending_item < m_pending_items.size();
+  }
 };
 
 }  // namespace elements
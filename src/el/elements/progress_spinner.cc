@@ -46,12 +46,13 @@ void ProgressSpinner::set_value(int value) {
 void ProgressSpinner::OnPaint(const PaintProps& paint_props) {
   if (is_animating()) {
     auto e = Skin::get()->GetSkinElementById(m_skin_fg);
-    if (e && e->bitmap) {
-      int size = e->bitmap->height();
-      int num_frames = e->bitmap->width() / e->bitmap->height();
+    auto bitmap = e ? Skin::get()->GetElementBitmap(e) : nullptr;
+    if (bitmap) {
+      int size = bitmap->height();
+      int num_frames = bitmap->width() / bitmap->height();
       int current_frame = m_frame % num_frames;
       graphics::Renderer::get()->DrawBitmap(
-          padding_rect(), Rect(current_frame * size, 0, size, size), e->bitmap);
+          padding_rect(), Rect(current_frame * size, 0, size, size), bitmap);
     }
   }
 }
@@ -153,6 +153,8 @@ class TextBox : public Element,
 
   PreferredSize OnCalculatePreferredContentSize(
       const SizeConstraints& constraints) override;
+  // Measuring may reformat the text and update the scrollbars.
+  bool is_measure_thread_safe() const override { return false; }
 
   void OnMessageReceived(Message* msg) override;
 
@@ -0,0 +1,154 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <algorithm>
+
+#include "el/animation_manager.h"
+#include "el/element.h"
+#include "el/frame_scheduler.h"
+#include "el/message_handler.h"
+#include "el/util/metrics.h"
+
+namespace el {
+
+std::unique_ptr<FrameScheduler> FrameScheduler::frame_scheduler_singleton_;
+
+FrameScheduler::FrameScheduler() = default;
+
+FrameScheduler::~FrameScheduler() = default;
+
+FrameScheduler::TaskId FrameScheduler::Post(FramePriority priority,
+                                            Task task) {
+  TaskId id = m_next_task_id++;
+  if (!m_next_task_id) {
+    m_next_task_id = 1;
+  }
+  m_tasks[size_t(priority)].push_back({id, std::move(task)});
+  return id;
+}
+
+bool FrameScheduler::Cancel(TaskId id) {
+  for (auto& tasks : m_tasks) {
+    for (auto& entry : tasks) {
+      if (entry.id == id) {
+        // Removed by RunTasks, since the entry may be running right now.
+        entry.id = 0;
+        entry.task = nullptr;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+size_t FrameScheduler::pending_task_count(FramePriority priority) const {
+  auto& tasks = m_tasks[size_t(priority)];
+  return std::count_if(tasks.begin(), tasks.end(),
+                       [](const Entry& entry) { return entry.id != 0; });
+}
+
+bool FrameScheduler::has_pending_tasks() const {
+  for (size_t i = 0; i < kPriorityCount; ++i) {
+    if (pending_task_count(FramePriority(i))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool FrameScheduler::ShouldYield() const {
+  return is_in_frame() &&
+         util::GetTimeUS() - m_frame_start_us >= m_budget_us;
+}
+
+void FrameScheduler::RunFrame(Element* root) {
+  uint64_t frame_start_us = util::GetTimeUS();
+  // Never 0 while in a frame, see is_in_frame.
+  m_frame_start_us = std::max<uint64_t>(frame_start_us, 1);
+
+  uint64_t start_us = frame_start_us;
+  auto end_category = [&](FramePriority priority) {
+    uint64_t end_us = util::GetTimeUS();
+    AddTiming(&m_timings[size_t(priority)], end_us - start_us);
+    start_us = end_us;
+  };
+
+  MessageHandler::ProcessMessages();
+  RunTasks(FramePriority::kInput, false, 0);
+  end_category(FramePriority::kInput);
+
+  AnimationManager::Update();
+  RunTasks(FramePriority::kAnimation, false, 0);
+  end_category(FramePriority::kAnimation);
+
+  if (root) {
+    root->InvokeProcessStates();
+    root->InvokeProcess();
+  }
+  RunTasks(FramePriority::kLayout, true, 1);
+  end_category(FramePriority::kLayout);
+
+  RunTasks(FramePriority::kIdle, true, 0);
+  end_category(FramePriority::kIdle);
+
+  AddTiming(&m_frame_timing, start_us - frame_start_us);
+  m_frame_start_us = 0;
+}
+
+void FrameScheduler::RunTasks(FramePriority priority, bool budgeted,
+                              size_t min_count) {
+  auto& tasks = m_tasks[size_t(priority)];
+  // Tasks posted while running are left for the next frame, so a task that
+  // posts itself can't keep the frame going.
+  size_t count = tasks.size();
+  size_t run_count = 0;
+  for (size_t i = 0; i < count; ++i) {
+    if (!tasks[i].id) {
+      continue;
+    }
+    if (budgeted && run_count >= min_count && ShouldYield()) {
+      break;
+    }
+    // The task is moved out while running since posting may reallocate the
+    // task list.
+    TaskId id = tasks[i].id;
+    Task task = std::move(tasks[i].task);
+    tasks[i].task = nullptr;
+    bool finished = task();
+    ++run_count;
+    if (tasks[i].id != id) {
+      // Cancelled while running.
+      continue;
+    }
+    if (finished) {
+      tasks[i].id = 0;
+    } else {
+      tasks[i].task = std::move(task);
+    }
+  }
+  tasks.erase(std::remove_if(tasks.begin(), tasks.end(),
+                             [](const Entry& entry) { return !entry.id; }),
+              tasks.end());
+}
+
+void FrameScheduler::AddTiming(Timing* timing, uint64_t time_us) {
+  timing->last_us = time_us;
+  timing->max_us = std::max(timing->max_us, time_us);
+  timing->total_us += time_us;
+  ++timing->frame_count;
+}
+
+void FrameScheduler::ResetTimings() {
+  for (auto& timing : m_timings) {
+    timing = Timing();
+  }
+  m_frame_timing = Timing();
+}
+
+}  // namespace el
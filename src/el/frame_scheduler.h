@@ -0,0 +1,143 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#ifndef EL_FRAME_SCHEDULER_H_
+#define EL_FRAME_SCHEDULER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace el {
+
+class Element;
+
+// Priority of work run by the FrameScheduler, in the order it runs in a frame.
+enum class FramePriority {
+  // Messages and input handling. Never deferred.
+  kInput,
+  // Stepping animations. Never deferred.
+  kAnimation,
+  // Element states, processing and layout. Posted layout tasks run while the
+  // frame budget lasts, but at least one runs each frame.
+  kLayout,
+  // Background work that only runs while there's budget left.
+  kIdle,
+};
+
+// Runs the per frame work of the library (messages, animations and element
+// processing) followed by posted tasks, within a time budget per frame.
+//
+// Deferrable work is cooperative: a posted task returns false when it has more
+// to do and is called again in a later frame, and long loops (such as ListBox
+// populating a huge list) check ShouldYield and continue in the next frame
+// when the budget is exhausted.
+//
+// The time spent in each priority category is measured for every frame (See
+// timing).
+class FrameScheduler {
+ public:
+  static FrameScheduler* get() { return frame_scheduler_singleton_.get(); }
+  static void set(std::unique_ptr<FrameScheduler> value) {
+    frame_scheduler_singleton_ = std::move(value);
+  }
+
+  static const size_t kPriorityCount = 4;
+
+  // A posted task. Returns true when finished, or false to be called again in
+  // the next frame.
+  using Task = std::function<bool()>;
+  using TaskId = uint32_t;
+
+  // Time spent in one priority category, in microseconds.
+  struct Timing {
+    uint64_t last_us = 0;
+    uint64_t max_us = 0;
+    uint64_t total_us = 0;
+    uint64_t frame_count = 0;
+
+    uint64_t average_us() const {
+      return frame_count ? total_us / frame_count : 0;
+    }
+  };
+
+  FrameScheduler();
+  ~FrameScheduler();
+
+  // Gets the time budget per frame in microseconds.
+  uint64_t budget_us() const { return m_budget_us; }
+  // Sets the time budget per frame in microseconds (8 ms by default).
+  void set_budget_us(uint64_t budget_us) { m_budget_us = budget_us; }
+
+  // Posts a task to run in the next frame with the given priority.
+  // Returns an id that can be used to cancel the task.
+  TaskId Post(FramePriority priority, Task task);
+
+  // Cancels a posted task that hasn't finished. Safe to call from any task,
+  // including the task itself. Returns true if the task was found.
+  bool Cancel(TaskId id);
+
+  // Gets the number of tasks waiting to run with the given priority.
+  size_t pending_task_count(FramePriority priority) const;
+  // Returns true if there are posted tasks waiting, so another frame should be
+  // run even if nothing else needs updating.
+  bool has_pending_tasks() const;
+
+  // Runs one frame of work for the given root element:
+  // kInput:     MessageHandler::ProcessMessages and input tasks.
+  // kAnimation: AnimationManager::Update and animation tasks.
+  // kLayout:    InvokeProcessStates and InvokeProcess on root, and layout
+  //             tasks.
+  // kIdle:      Idle tasks.
+  // Painting is left to the caller.
+  void RunFrame(Element* root);
+
+  // Returns true if RunFrame is currently running.
+  bool is_in_frame() const { return m_frame_start_us != 0; }
+
+  // Returns true if the budget of the current frame is used up, so deferrable
+  // work should stop and continue in the next frame.
+  // Always returns false outside of RunFrame.
+  bool ShouldYield() const;
+
+  // Gets the time spent in the given category.
+  const Timing& timing(FramePriority priority) const {
+    return m_timings[size_t(priority)];
+  }
+  // Gets the time spent in all categories.
+  const Timing& frame_timing() const { return m_frame_timing; }
+
+  void ResetTimings();
+
+ private:
+  struct Entry {
+    TaskId id;
+    Task task;
+  };
+
+  // Runs the tasks of a category. If budgeted, it stops when the frame budget
+  // is used up, after running at least min_count tasks.
+  void RunTasks(FramePriority priority, bool budgeted, size_t min_count);
+  void AddTiming(Timing* timing, uint64_t time_us);
+
+  static std::unique_ptr<FrameScheduler> frame_scheduler_singleton_;
+
+  std::vector<Entry> m_tasks[kPriorityCount];
+  TaskId m_next_task_id = 1;
+  uint64_t m_budget_us = 8000;
+  uint64_t m_frame_start_us = 0;
+  Timing m_timings[kPriorityCount];
+  Timing m_frame_timing;
+};
+
+}  // namespace el
+
+#endif  // EL_FRAME_SCHEDULER_H_
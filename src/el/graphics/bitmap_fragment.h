@@ -68,6 +68,10 @@ class BitmapFragment {
   BitmapFragmentSpaceAllocator::Space* m_space = nullptr;
   TBID m_id;
   int m_row_height = 0;
+  // The smallest inset from the edges of the fragment such that all pixels
+  // inside it were fully opaque when created (0 if all pixels are opaque), or
+  // -1 if there's no such inset.
+  int m_opaque_inset = -1;
 
   // Reserved for batching renderer backends. It's not used internally, but
   // always initialized to 0xffffffff for all new fragments.
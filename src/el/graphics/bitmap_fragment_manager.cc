@@ -20,6 +20,32 @@
 namespace el {
 namespace graphics {
 
+namespace {
+
+// Gets the opaque inset of the BGRA32 data (See
+// BitmapFragment::m_opaque_inset).
+int GetOpaqueInset(int data_w, int data_h, int data_stride,
+                   const uint32_t* data) {
+  if (!data || data_w <= 0 || data_h <= 0) {
+    return -1;
+  }
+  // Each pixel that isn't opaque must be outside of the inset.
+  int inset = 0;
+  for (int y = 0; y < data_h; ++y) {
+    const uint32_t* row = data + y * data_stride;
+    for (int x = 0; x < data_w; ++x) {
+      if ((row[x] >> 24) != 0xff) {
+        int edge_distance =
+            std::min(std::min(x, data_w - 1 - x), std::min(y, data_h - 1 - y));
+        inset = std::max(inset, edge_distance + 1);
+      }
+    }
+  }
+  return inset * 2 < data_w && inset * 2 < data_h ? inset : -1;
+}
+
+}  // namespace
+
 BitmapFragmentManager::BitmapFragmentManager() = default;
 
 BitmapFragmentManager::~BitmapFragmentManager() = default;
@@ -85,6 +111,8 @@ BitmapFragment* BitmapFragmentManager::CreateNewFragment(const TBID& id,
   // Finally, add the new fragment to the hash.
   if (fragment) {
     fragment->m_id = id;
+    fragment->m_opaque_inset = GetOpaqueInset(data_w, data_h, data_stride,
+                                              data);
     auto fragment_ptr = fragment.get();
     m_fragments.emplace(id, std::move(fragment));
     return fragment_ptr;
@@ -12,10 +12,10 @@
 
 #include <memory>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "el/id.h"
+#include "el/util/id_map.h"
 
 namespace el {
 namespace graphics {
@@ -100,7 +100,7 @@ class BitmapFragmentManager {
 
  private:
   std::vector<std::unique_ptr<BitmapFragmentMap>> m_fragment_maps;
-  std::unordered_map<uint32_t, std::unique_ptr<BitmapFragment>> m_fragments;
+  util::IdMap<std::unique_ptr<BitmapFragment>> m_fragments;
   int m_num_maps_limit = 0;
   bool m_add_border = false;
   int m_default_map_w = 512;
@@ -11,6 +11,7 @@
 
 #include "el/graphics/bitmap_fragment_map.h"
 #include "el/graphics/renderer.h"
+#include "el/util/counters.h"
 #include "el/util/math.h"
 #include "el/util/space_allocator.h"
 
@@ -162,6 +163,18 @@ void BitmapFragmentMap::FreeFragmentSpace(BitmapFragment* frag) {
   }
 }
 
+void BitmapFragmentMap::ReadFragmentData(const BitmapFragment* frag,
+                                         uint32_t* data) const {
+  assert(frag->m_map == this);
+  const uint32_t* src =
+      m_bitmap_data + frag->m_rect.x + frag->m_rect.y * m_bitmap_w;
+  for (int i = 0; i < frag->m_rect.h; ++i) {
+    std::memcpy(data, src, frag->m_rect.w * sizeof(uint32_t));
+    data += frag->m_rect.w;
+    src += m_bitmap_w;
+  }
+}
+
 void BitmapFragmentMap::CopyData(BitmapFragment* frag, int data_stride,
                                  uint32_t* frag_data, int border) {
   // Copy the bitmap data.
@@ -208,6 +221,9 @@ Bitmap* BitmapFragmentMap::GetBitmap(Validate validate_type) {
 
 bool BitmapFragmentMap::ValidateBitmap() {
   if (m_need_update) {
+    util::Counters::Add(util::Counter::kAtlasUploads);
+    util::Counters::Add(util::Counter::kAtlasUploadBytes,
+                        uint64_t(m_bitmap_w) * m_bitmap_h * sizeof(uint32_t));
     if (m_bitmap) {
       m_bitmap->set_data(m_bitmap_data);
     } else {
@@ -47,6 +47,10 @@ class BitmapFragmentMap {
   // take its place.
   void FreeFragmentSpace(BitmapFragment* frag);
 
+  // Copies the pixels (in BGRA32 format) of the given fragment in this map to
+  // data, which must have room for the width * height of the fragment.
+  void ReadFragmentData(const BitmapFragment* frag, uint32_t* data) const;
+
   // Returns the bitmap for this map.
   // By default, the bitmap is validated if needed before returning (See
   // Validate).
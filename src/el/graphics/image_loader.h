@@ -26,6 +26,12 @@ class ImageLoader {
   static std::unique_ptr<ImageLoader> CreateFromFile(
       const std::string& filename);
 
+  // The system must implement this function too. Gets the size of the image
+  // in the given file by reading its header, without decoding the pixels.
+  // Returns false if the file can't be read.
+  static bool ReadImageSize(const std::string& filename, int* out_width,
+                            int* out_height);
+
   virtual ~ImageLoader() = default;
 
   virtual int width() = 0;
@@ -49,8 +49,8 @@ class StbiImageLoader : public ImageLoader {
 
 std::unique_ptr<ImageLoader> ImageLoader::CreateFromFile(
     const std::string& filename) {
-  // Load directly from file.
-  auto buffer = io::FileManager::ReadContents(filename);
+  // Decode directly from the file contents.
+  auto buffer = io::FileManager::OpenContents(filename);
   if (!buffer) {
     return nullptr;
   }
@@ -66,5 +66,17 @@ std::unique_ptr<ImageLoader> ImageLoader::CreateFromFile(
   return std::unique_ptr<ImageLoader>(img.release());
 }
 
+bool ImageLoader::ReadImageSize(const std::string& filename, int* out_width,
+                                int* out_height) {
+  auto buffer = io::FileManager::OpenContents(filename);
+  if (!buffer) {
+    return false;
+  }
+  int comp;
+  return stbi_info_from_memory(buffer->data(),
+                               static_cast<int>(buffer->size()), out_width,
+                               out_height, &comp) != 0;
+}
+
 }  // namespace graphics
 }  // namespace el
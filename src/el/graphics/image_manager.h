@@ -11,10 +11,10 @@
 #define EL_GRAPHICS_IMAGE_MANAGER_H_
 
 #include <memory>
-#include <unordered_map>
 
 #include "el/graphics/bitmap_fragment_manager.h"
 #include "el/graphics/renderer.h"
+#include "el/util/id_map.h"
 
 namespace el {
 namespace graphics {
@@ -115,7 +115,7 @@ class ImageManager : private RendererListener {
   static std::unique_ptr<ImageManager> image_manager_singleton_;
 
   BitmapFragmentManager m_frag_manager;
-  std::unordered_map<uint32_t, ImageRep*> m_image_rep_hash;
+  util::IdMap<ImageRep*> m_image_rep_hash;
 };
 
 }  // namespace graphics
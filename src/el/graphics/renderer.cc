@@ -7,9 +7,12 @@
  ******************************************************************************
  */
 
+#include <algorithm>
+
 #include "el/graphics/bitmap_fragment.h"
 #include "el/graphics/renderer.h"
 #include "el/util/debug.h"
+#include "el/util/trace.h"
 
 namespace el {
 namespace graphics {
@@ -47,10 +50,13 @@ void Renderer::BeginPaint(int render_target_w, int render_target_h) {
 
   screen_rect_.reset(0, 0, render_target_w, render_target_h);
   clip_rect_ = screen_rect_;
+  set_clip_rect(clip_rect_);
 }
 
 void Renderer::EndPaint() {
+  assert(render_targets_.empty());
   FlushAllInternal();
+  util::Counters::get()->EndFrame();
 
 #ifdef EL_RUNTIME_DEBUG_INFO
   if (EL_DEBUG_SETTING(util::DebugInfo::Setting::kDrawRenderBatches)) {
@@ -83,14 +89,27 @@ Rect Renderer::set_clip_rect(const Rect& rect, bool add_to_current) {
     clip_rect_ = clip_rect_.Clip(old_clip_rect);
   }
 
-  FlushAllInternal();
-  set_clip_rect(clip_rect_);
+  // With CPU clipping the quads are clipped as they are added, so the batch
+  // can continue with the new clip rect.
+  if (!cpu_clipping_) {
+    FlushBatch(util::Counter::kBatchFlushClipChange);
+    set_clip_rect(clip_rect_);
+  }
 
   old_clip_rect.x -= translation_x_;
   old_clip_rect.y -= translation_y_;
   return old_clip_rect;
 }
 
+void Renderer::set_cpu_clipping(bool cpu_clipping) {
+  if (cpu_clipping_ == cpu_clipping) {
+    return;
+  }
+  FlushBatch(util::Counter::kBatchFlushClipChange);
+  cpu_clipping_ = cpu_clipping;
+  set_clip_rect(cpu_clipping_ ? screen_rect_ : clip_rect_);
+}
+
 Rect Renderer::clip_rect() {
   Rect curr_clip_rect = clip_rect_;
   curr_clip_rect.x -= translation_x_;
@@ -133,12 +152,63 @@ void Renderer::DrawBitmapColored(const Rect& dst_rect, const Rect& src_rect,
                   VER_COL(color.r, color.g, color.b, a), bitmap, nullptr);
 }
 
+void Renderer::DrawBitmapDistanceField(const Rect& dst_rect,
+                                       const Rect& src_rect,
+                                       const Color& color,
+                                       BitmapFragment* bitmap_fragment) {
+  assert(supports_distance_field());
+  if (auto bitmap = bitmap_fragment->GetBitmap(Validate::kFirstTime)) {
+    uint32_t a = (color.a * opacity_) / 255;
+    AddQuadInternal(
+        dst_rect.Offset(translation_x_, translation_y_),
+        src_rect.Offset(bitmap_fragment->m_rect.x, bitmap_fragment->m_rect.y),
+        VER_COL(color.r, color.g, color.b, a), bitmap, bitmap_fragment, true);
+  }
+}
+
 void Renderer::DrawBitmapTile(const Rect& dst_rect, Bitmap* bitmap) {
   AddQuadInternal(dst_rect.Offset(translation_x_, translation_y_),
                   Rect(0, 0, dst_rect.w, dst_rect.h), VER_COL_OPACITY(opacity_),
                   bitmap, nullptr);
 }
 
+void Renderer::BeginRenderTarget(Bitmap* target) {
+  FlushBatch(util::Counter::kBatchFlushRenderTarget);
+  RenderTargetState state = {target,         screen_rect_,   clip_rect_,
+                             translation_x_, translation_y_, opacity_};
+  render_targets_.push_back(state);
+  screen_rect_.reset(0, 0, target->width(), target->height());
+  clip_rect_ = screen_rect_;
+  translation_x_ = translation_y_ = 0;
+  opacity_ = 255;
+  set_render_target(target, true);
+  set_clip_rect(clip_rect_);
+}
+
+void Renderer::EndRenderTarget() {
+  assert(!render_targets_.empty());
+  FlushBatch(util::Counter::kBatchFlushRenderTarget);
+  const RenderTargetState& state = render_targets_.back();
+  screen_rect_ = state.screen_rect;
+  clip_rect_ = state.clip_rect;
+  translation_x_ = state.translation_x;
+  translation_y_ = state.translation_y;
+  opacity_ = state.opacity;
+  render_targets_.pop_back();
+  set_render_target(
+      render_targets_.empty() ? nullptr : render_targets_.back().target,
+      false);
+  set_clip_rect(cpu_clipping_ ? screen_rect_ : clip_rect_);
+}
+
+void Renderer::DrawRenderTarget(const Rect& dst_rect, const Rect& src_rect,
+                                Bitmap* target) {
+  // The colors are premultiplied, so the opacity applies to all channels.
+  AddQuadInternal(dst_rect.Offset(translation_x_, translation_y_), src_rect,
+                  VER_COL(opacity_, opacity_, opacity_, opacity_), target,
+                  nullptr, false, true);
+}
+
 void Renderer::DrawRect(const Rect& dst_rect, const Color& color) {
   if (dst_rect.empty()) return;
   // Top.
@@ -163,10 +233,43 @@ void Renderer::DrawRectFill(const Rect& dst_rect, const Color& color) {
 
 void Renderer::AddQuadInternal(const Rect& dst_rect, const Rect& src_rect,
                                uint32_t color, Bitmap* bitmap,
-                               BitmapFragment* fragment) {
+                               BitmapFragment* fragment,
+                               bool is_distance_field,
+                               bool is_premultiplied) {
+  // Positions and texture coordinates of the quad edges. Left/right or
+  // top/bottom are swapped if dst_rect is flipped.
+  int x0 = dst_rect.x;
+  int y0 = dst_rect.y;
+  int x1 = dst_rect.x + dst_rect.w;
+  int y1 = dst_rect.y + dst_rect.h;
+  if (bitmap) {
+    float bitmap_w = static_cast<float>(bitmap->width());
+    float bitmap_h = static_cast<float>(bitmap->height());
+    m_u = src_rect.x / bitmap_w;
+    m_v = src_rect.y / bitmap_h;
+    m_uu = (src_rect.x + src_rect.w) / bitmap_w;
+    m_vv = (src_rect.y + src_rect.h) / bitmap_h;
+  }
+  float u0 = m_u;
+  float v0 = m_v;
+  float u1 = m_uu;
+  float v1 = m_vv;
+
+  if (cpu_clipping_) {
+    if (!ClipEdges(&x0, &x1, &u0, &u1, clip_rect_.x,
+                   clip_rect_.x + clip_rect_.w) ||
+        !ClipEdges(&y0, &y1, &v0, &v1, clip_rect_.y,
+                   clip_rect_.y + clip_rect_.h)) {
+      // Entirely clipped away.
+      return;
+    }
+  }
+
   // On state change force flush.
-  if (batch_.bitmap != bitmap) {
-    FlushBatch();
+  if (batch_.bitmap != bitmap ||
+      batch_.is_distance_field != is_distance_field ||
+      batch_.is_premultiplied != is_premultiplied) {
+    FlushBatch(util::Counter::kBatchFlushBitmapChange);
   }
 
   // Reserve vertices for our quad.
@@ -175,57 +278,78 @@ void Renderer::AddQuadInternal(const Rect& dst_rect, const Rect& src_rect,
 
   // Setup batch textures (if any).
   batch_.bitmap = bitmap;
-  if (bitmap) {
-    int bitmap_w = bitmap->width();
-    int bitmap_h = bitmap->height();
-    m_u = static_cast<float>(src_rect.x) / bitmap_w;
-    m_v = static_cast<float>(src_rect.y) / bitmap_h;
-    m_uu = static_cast<float>(src_rect.x + src_rect.w) / bitmap_w;
-    m_vv = static_cast<float>(src_rect.y + src_rect.h) / bitmap_h;
-  }
+  batch_.is_distance_field = is_distance_field;
+  batch_.is_premultiplied = is_premultiplied;
   batch_.fragment = fragment;
   if (fragment) {
     // Update fragments batch id (See FlushBitmapFragment).
     fragment->m_batch_id = batch_.batch_id;
   }
 
-  v[0].x = static_cast<float>(dst_rect.x);
-  v[0].y = static_cast<float>(dst_rect.y + dst_rect.h);
-  v[0].u = m_u;
-  v[0].v = m_vv;
+  const float left = static_cast<float>(x0);
+  const float top = static_cast<float>(y0);
+  const float right = static_cast<float>(x1);
+  const float bottom = static_cast<float>(y1);
+  v[0].x = left;
+  v[0].y = bottom;
+  v[0].u = u0;
+  v[0].v = v1;
   v[0].color = color;
-  v[1].x = static_cast<float>(dst_rect.x + dst_rect.w);
-  v[1].y = static_cast<float>(dst_rect.y + dst_rect.h);
-  v[1].u = m_uu;
-  v[1].v = m_vv;
+  v[1].x = right;
+  v[1].y = bottom;
+  v[1].u = u1;
+  v[1].v = v1;
   v[1].color = color;
-  v[2].x = static_cast<float>(dst_rect.x);
-  v[2].y = static_cast<float>(dst_rect.y);
-  v[2].u = m_u;
-  v[2].v = m_v;
+  v[2].x = left;
+  v[2].y = top;
+  v[2].u = u0;
+  v[2].v = v0;
   v[2].color = color;
 
-  v[3].x = static_cast<float>(dst_rect.x);
-  v[3].y = static_cast<float>(dst_rect.y);
-  v[3].u = m_u;
-  v[3].v = m_v;
+  v[3].x = left;
+  v[3].y = top;
+  v[3].u = u0;
+  v[3].v = v0;
   v[3].color = color;
-  v[4].x = static_cast<float>(dst_rect.x + dst_rect.w);
-  v[4].y = static_cast<float>(dst_rect.y + dst_rect.h);
-  v[4].u = m_uu;
-  v[4].v = m_vv;
+  v[4].x = right;
+  v[4].y = bottom;
+  v[4].u = u1;
+  v[4].v = v1;
   v[4].color = color;
-  v[5].x = static_cast<float>(dst_rect.x + dst_rect.w);
-  v[5].y = static_cast<float>(dst_rect.y);
-  v[5].u = m_uu;
-  v[5].v = m_v;
+  v[5].x = right;
+  v[5].y = top;
+  v[5].u = u1;
+  v[5].v = v0;
   v[5].color = color;
 }
 
+bool Renderer::ClipEdges(int* p0, int* p1, float* t0, float* t1, int clip_min,
+                         int clip_max) {
+  int lo = std::min(*p0, *p1);
+  int hi = std::max(*p0, *p1);
+  if (lo >= clip_max || hi <= clip_min || clip_max <= clip_min) {
+    return false;
+  }
+  if (lo >= clip_min && hi <= clip_max) {
+    return true;
+  }
+  // Move the edges inside the clip range, and the texture coordinates
+  // proportionally, so the visible part maps to the same texels.
+  float scale = (*t1 - *t0) / (*p1 - *p0);
+  int new_p0 = std::min(std::max(*p0, clip_min), clip_max);
+  int new_p1 = std::min(std::max(*p1, clip_min), clip_max);
+  float t = *t0;
+  *t0 = t + (new_p0 - *p0) * scale;
+  *t1 = t + (new_p1 - *p0) * scale;
+  *p0 = new_p0;
+  *p1 = new_p1;
+  return true;
+}
+
 Renderer::Vertex* Renderer::ReserveVertices(size_t vertex_count) {
   assert(vertex_count < max_vertex_batch_size());
   if (batch_.vertex_count + vertex_count > max_vertex_batch_size()) {
-    FlushBatch();
+    FlushBatch(util::Counter::kBatchFlushBufferFull);
   }
   Vertex* ret = &batch_.vertices[batch_.vertex_count];
   batch_.vertex_count += vertex_count;
@@ -236,6 +360,7 @@ void Renderer::FlushBatch() {
   if (!batch_.vertex_count || batch_.is_flushing) {
     return;
   }
+  EL_TRACE_ZONE("Renderer::FlushBatch");
 
   // Prevent re-entrancy. Calling fragment->GetBitmap may end up calling
   // Bitmap::SetData which will end up flushing any existing batch with that
@@ -251,6 +376,8 @@ void Renderer::FlushBatch() {
   }
 
   RenderBatch(&batch_);
+  util::Counters::Add(util::Counter::kDrawCalls);
+  util::Counters::Add(util::Counter::kVertices, batch_.vertex_count);
 
 #ifdef EL_RUNTIME_DEBUG_INFO
   if (EL_DEBUG_SETTING(util::DebugInfo::Setting::kDrawRenderBatches)) {
@@ -279,13 +406,20 @@ void Renderer::FlushBatch() {
   batch_.is_flushing = false;
 }
 
+void Renderer::FlushBatch(util::Counter reason) {
+  if (batch_.vertex_count && !batch_.is_flushing) {
+    util::Counters::Add(reason);
+    FlushBatch();
+  }
+}
+
 void Renderer::FlushAllInternal() { FlushBatch(); }
 
 void Renderer::FlushBitmap(Bitmap* bitmap) {
   // Flush the batch if it's using this bitmap (that is about to change or be
   // deleted).
   if (batch_.vertex_count && bitmap == batch_.bitmap) {
-    FlushBatch();
+    FlushBatch(util::Counter::kBatchFlushFragment);
   }
 }
 
@@ -297,7 +431,7 @@ void Renderer::FlushBitmapFragment(BitmapFragment* bitmap_fragment) {
   // If we switch to a more advance batching system with multiple batches, we
   // need to solve this a bit differently.
   if (batch_.vertex_count && bitmap_fragment->m_batch_id == batch_.batch_id) {
-    FlushBatch();
+    FlushBatch(util::Counter::kBatchFlushFragment);
   }
 }
 
@@ -12,9 +12,11 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "el/color.h"
 #include "el/rect.h"
+#include "el/util/counters.h"
 #include "el/util/intrusive_list.h"
 
 namespace el {
@@ -91,6 +93,18 @@ class Renderer {
   // this call.
   Rect set_clip_rect(const Rect& rect, bool add_to_current);
 
+  // Returns true if quads are clipped on the CPU (the default).
+  bool is_cpu_clipping() const { return cpu_clipping_; }
+  // Sets if quads should be clipped to the clip rect on the CPU, by trimming
+  // their positions and texture coordinates, instead of by the renderer
+  // implementation (f.ex with a scissor rect). With CPU clipping, changing the
+  // clip rect doesn't flush the batch, so nested clipped areas (scroll
+  // containers, text boxes...) don't break batching. The implementation clip
+  // rect is then kept at the whole render target.
+  // Disable it while drawing other content than quads directly with the
+  // renderer implementation, if it should be clipped.
+  void set_cpu_clipping(bool cpu_clipping);
+
   // Draws the src_rect part of the fragment stretched to dst_rect.
   // dst_rect or src_rect can have negative width and height to achieve
   // horizontal and vertical flip.
@@ -116,15 +130,60 @@ class Renderer {
   void DrawBitmapColored(const Rect& dst_rect, const Rect& src_rect,
                          const Color& color, Bitmap* bitmap);
 
+  // Draws the src_rect part of the fragment stretched to dst_rect.
+  // The bitmap alpha holds a signed distance field (128 on the outline, see
+  // text::GenerateDistanceField) which is thresholded to a mask for the color.
+  // Only valid if supports_distance_field() returns true.
+  void DrawBitmapDistanceField(const Rect& dst_rect, const Rect& src_rect,
+                               const Color& color,
+                               BitmapFragment* bitmap_fragment);
+
+  // Returns true if the renderer implementation can draw distance field
+  // bitmaps (See DrawBitmapDistanceField). Text will then be drawn from one
+  // distance field glyph for all font sizes, if enabled in the FontManager.
+  virtual bool supports_distance_field() const { return false; }
+
   // Draws the bitmap tiled into dst_rect.
   void DrawBitmapTile(const Rect& dst_rect, Bitmap* bitmap);
 
+  // Creates an offscreen render target that can be drawn into (See
+  // BeginRenderTarget) and then drawn with DrawRenderTarget. The bitmap size
+  // is the given size rounded up to a power of two.
+  // Returns nullptr if the renderer implementation doesn't support render
+  // targets (the default).
+  virtual std::unique_ptr<Bitmap> CreateRenderTarget(int /*width*/,
+                                                     int /*height*/) {
+    return nullptr;
+  }
+
+  // Redirects all drawing into the render target (created with
+  // CreateRenderTarget), cleared to transparent, until EndRenderTarget is
+  // called. Translation, clipping and opacity start over as after
+  // BeginPaint, with the render target size. Calls may be nested.
+  // The render target holds the colors premultiplied with alpha, so the
+  // translucent parts blend like they would have if drawn directly.
+  void BeginRenderTarget(Bitmap* target);
+
+  // Ends drawing into the render target and restores the render target,
+  // translation, clipping and opacity from before BeginRenderTarget.
+  void EndRenderTarget();
+
+  // Draws the src_rect part of the render target (See CreateRenderTarget)
+  // stretched to dst_rect, with the current opacity applied to all of it.
+  void DrawRenderTarget(const Rect& dst_rect, const Rect& src_rect,
+                        Bitmap* target);
+
   // Draws a 1px thick rectangle outline.
   void DrawRect(const Rect& dst_rect, const Color& color);
 
   // Draws a filled rectangle.
   void DrawRectFill(const Rect& dst_rect, const Color& color);
 
+  // Gets the number of batches rendered since BeginPaint.
+  size_t frame_batch_count() const {
+    return batch_.batch_id - uint32_t(begin_paint_batch_id_);
+  }
+
   // Makes sure the given bitmap fragment is flushed from any batching, because
   // it may be changed or deleted after this call.
   void FlushBitmapFragment(BitmapFragment* bitmap_fragment);
@@ -154,8 +213,8 @@ class Renderer {
 
   // Defines the hint given to BeginBatchHint.
   enum class BatchHint {
-    // All calls are either DrawBitmap or DrawBitmapColored with the same bitmap
-    // fragment.
+    // All calls are either DrawBitmap, DrawBitmapColored or
+    // DrawBitmapDistanceField with the same bitmap fragment.
     kDrawBitmapFragment,
   };
 
@@ -184,6 +243,11 @@ class Renderer {
 
     Bitmap* bitmap = nullptr;
     BitmapFragment* fragment = nullptr;
+    // True if the bitmap alpha should be read as a distance field.
+    bool is_distance_field = false;
+    // True if the bitmap colors are premultiplied with alpha (a render
+    // target), so they should be blended with (one, one minus source alpha).
+    bool is_premultiplied = false;
 
     uint32_t batch_id = 0;
     bool is_flushing = false;
@@ -196,6 +260,9 @@ class Renderer {
 
   // Flushes the current batch.
   void FlushBatch();
+  // Flushes the current batch, counting it as a flush for the given reason
+  // (one of the util::Counter::kBatchFlush* counters) if it isn't empty.
+  void FlushBatch(util::Counter reason);
   // Flushes the current batch if the given bitmap is used.
   void FlushBitmap(Bitmap* bitmap);
   // Reserves a block of vertices for use within the current batch.
@@ -206,10 +273,24 @@ class Renderer {
   virtual void RenderBatch(Batch* batch) = 0;
   // Sets the clipping rectangle used when rendering.
   virtual void set_clip_rect(const Rect& rect) = 0;
+  // Makes the renderer implementation render into the render target (See
+  // CreateRenderTarget), or to the render target given to BeginPaint if
+  // nullptr. It should be cleared to transparent if clear is true.
+  // screen_rect_ is already set to the size of the new target.
+  // While drawing into a render target, colors should be blended with
+  // (source alpha, one minus source alpha) and alpha with (one, one minus
+  // source alpha) to keep them premultiplied.
+  virtual void set_render_target(Bitmap* /*target*/, bool /*clear*/) {}
 
   void AddQuadInternal(const Rect& dst_rect, const Rect& src_rect,
-                       uint32_t color, Bitmap* bitmap,
-                       BitmapFragment* fragment);
+                       uint32_t color, Bitmap* bitmap, BitmapFragment* fragment,
+                       bool is_distance_field = false,
+                       bool is_premultiplied = false);
+  // Clips the edges p0 and p1 (in any order) with texture coordinates t0 and
+  // t1 to the range clip_min - clip_max, along one axis.
+  // Returns false if nothing is left.
+  static bool ClipEdges(int* p0, int* p1, float* t0, float* t1, int clip_min,
+                        int clip_max);
   void FlushAllInternal();
 
   static Renderer* renderer_singleton_;
@@ -219,12 +300,25 @@ class Renderer {
   uint8_t opacity_ = 255;
   Rect screen_rect_;
   Rect clip_rect_;
+  bool cpu_clipping_ = true;
   int translation_x_ = 0;
   int translation_y_ = 0;
 
   Batch batch_;
   float m_u = 0, m_v = 0, m_uu = 0, m_vv = 0;
 
+  // State to restore when ending the render targets begun with
+  // BeginRenderTarget, innermost last.
+  struct RenderTargetState {
+    Bitmap* target;
+    Rect screen_rect;
+    Rect clip_rect;
+    int translation_x;
+    int translation_y;
+    uint8_t opacity;
+  };
+  std::vector<RenderTargetState> render_targets_;
+
   size_t begin_paint_batch_id_ = 0;
   size_t frame_triangle_count_ = 0;
 };
@@ -0,0 +1,898 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "el/graphics/software_renderer.h"
+#include "el/util/math.h"
+#include "el/util/work_pool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EL_SOFTWARE_RENDERER_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define EL_SOFTWARE_RENDERER_AVX2
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define EL_TARGET_AVX2
+#else
+#define EL_TARGET_AVX2 __attribute__((target("avx2")))
+#endif  // _MSC_VER
+#endif  // __GNUC__ || _MSC_VER
+#endif  // __SSE2__ || _M_X64 || _M_IX86_FP >= 2
+
+namespace el {
+namespace graphics {
+
+namespace {
+
+// Swaps the red and blue channels, converting between the RGBA byte order of
+// vertex colors and bitmap data and the BGRA byte order of the framebuffer.
+inline uint32_t SwapRedBlue(uint32_t color) {
+  return (color & 0xFF00FF00) | ((color >> 16) & 0xFF) |
+         ((color & 0xFF) << 16);
+}
+
+// Divides x (0 - 255 * 255) by 255, rounded to nearest.
+inline uint32_t Div255(uint32_t x) {
+  x += 128;
+  return (x + (x >> 8)) >> 8;
+}
+
+// Multiplies the channels of a and b.
+inline uint32_t Modulate(uint32_t a, uint32_t b) {
+  uint32_t result = 0;
+  for (int shift = 0; shift < 32; shift += 8) {
+    result |= Div255(((a >> shift) & 0xFF) * ((b >> shift) & 0xFF)) << shift;
+  }
+  return result;
+}
+
+// Blends src over dst using the src alpha, for all channels (like
+// glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA)).
+inline uint32_t Blend(uint32_t dst, uint32_t src) {
+  uint32_t alpha = src >> 24;
+  uint32_t inv_alpha = 255 - alpha;
+  uint32_t result = 0;
+  for (int shift = 0; shift < 32; shift += 8) {
+    result |= Div255(((src >> shift) & 0xFF) * alpha +
+                     ((dst >> shift) & 0xFF) * inv_alpha)
+              << shift;
+  }
+  return result;
+}
+
+// Blends src over dst like Blend, but weights the src alpha by one (like
+// glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE,
+// GL_ONE_MINUS_SRC_ALPHA)), so colors drawn into a transparent render target
+// end up premultiplied with alpha.
+inline uint32_t BlendOffscreen(uint32_t dst, uint32_t src) {
+  uint32_t alpha = src >> 24;
+  uint32_t inv_alpha = 255 - alpha;
+  uint32_t result = 0;
+  for (int shift = 0; shift < 24; shift += 8) {
+    result |= Div255(((src >> shift) & 0xFF) * alpha +
+                     ((dst >> shift) & 0xFF) * inv_alpha)
+              << shift;
+  }
+  return result | (Div255(alpha * 255 + (dst >> 24) * inv_alpha) << 24);
+}
+
+// Blends src with colors premultiplied with alpha over dst (like
+// glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA)). Colors above the alpha are
+// clamped to it.
+inline uint32_t BlendPremultiplied(uint32_t dst, uint32_t src) {
+  uint32_t alpha = src >> 24;
+  uint32_t inv_alpha = 255 - alpha;
+  uint32_t result = 0;
+  for (int shift = 0; shift < 32; shift += 8) {
+    result |= Div255(std::min((src >> shift) & 0xFF, alpha) * 255 +
+                     ((dst >> shift) & 0xFF) * inv_alpha)
+              << shift;
+  }
+  return result;
+}
+
+void BlendColorScalar(uint32_t* dst, int count, uint32_t color) {
+  if ((color >> 24) == 255) {
+    std::fill_n(dst, count, color);
+    return;
+  }
+  for (int i = 0; i < count; ++i) {
+    dst[i] = Blend(dst[i], color);
+  }
+}
+
+void BlendTexelsScalar(uint32_t* dst, const uint32_t* src, int count,
+                       uint32_t color) {
+  for (int i = 0; i < count; ++i) {
+    dst[i] = Blend(dst[i], Modulate(src[i], color));
+  }
+}
+
+void BlendColorOffscreenScalar(uint32_t* dst, int count, uint32_t color) {
+  if ((color >> 24) == 255) {
+    std::fill_n(dst, count, color);
+    return;
+  }
+  for (int i = 0; i < count; ++i) {
+    dst[i] = BlendOffscreen(dst[i], color);
+  }
+}
+
+void BlendTexelsOffscreenScalar(uint32_t* dst, const uint32_t* src,
+                                int count, uint32_t color) {
+  for (int i = 0; i < count; ++i) {
+    dst[i] = BlendOffscreen(dst[i], Modulate(src[i], color));
+  }
+}
+
+void BlendColorPremultipliedScalar(uint32_t* dst, int count, uint32_t color) {
+  for (int i = 0; i < count; ++i) {
+    dst[i] = BlendPremultiplied(dst[i], color);
+  }
+}
+
+void BlendTexelsPremultipliedScalar(uint32_t* dst, const uint32_t* src,
+                                    int count, uint32_t color) {
+  for (int i = 0; i < count; ++i) {
+    dst[i] = BlendPremultiplied(dst[i], Modulate(src[i], color));
+  }
+}
+
+#ifdef EL_SOFTWARE_RENDERER_SSE2
+
+// The SIMD kernels unpack pixels to 16 bit channels and do exactly the same
+// math as the scalar ones, so all paths draw identical pixels.
+
+inline __m128i Div255Sse2(__m128i x) {
+  x = _mm_add_epi16(x, _mm_set1_epi16(128));
+  return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+inline __m128i AlphaSse2(__m128i x) {
+  x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(3, 3, 3, 3));
+  return _mm_shufflehi_epi16(x, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+inline __m128i BlendSse2(__m128i dst, __m128i src) {
+  __m128i alpha = AlphaSse2(src);
+  __m128i inv_alpha = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+  return Div255Sse2(_mm_add_epi16(_mm_mullo_epi16(src, alpha),
+                                  _mm_mullo_epi16(dst, inv_alpha)));
+}
+
+void BlendColorSse2(uint32_t* dst, int count, uint32_t color) {
+  if ((color >> 24) == 255) {
+    std::fill_n(dst, count, color);
+    return;
+  }
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i src = _mm_unpacklo_epi8(_mm_set1_epi32(int(color)), zero);
+  const __m128i alpha = AlphaSse2(src);
+  const __m128i src_alpha = _mm_mullo_epi16(src, alpha);
+  const __m128i inv_alpha = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128i d = _mm_loadu_si128(reinterpret_cast<__m128i*>(dst + i));
+    __m128i lo = _mm_unpacklo_epi8(d, zero);
+    __m128i hi = _mm_unpackhi_epi8(d, zero);
+    lo = Div255Sse2(_mm_add_epi16(src_alpha, _mm_mullo_epi16(lo, inv_alpha)));
+    hi = Div255Sse2(_mm_add_epi16(src_alpha, _mm_mullo_epi16(hi, inv_alpha)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_packus_epi16(lo, hi));
+  }
+  for (; i < count; ++i) {
+    dst[i] = Blend(dst[i], color);
+  }
+}
+
+void BlendTexelsSse2(uint32_t* dst, const uint32_t* src, int count,
+                     uint32_t color) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i color16 = _mm_unpacklo_epi8(_mm_set1_epi32(int(color)), zero);
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i d = _mm_loadu_si128(reinterpret_cast<__m128i*>(dst + i));
+    __m128i s_lo = Div255Sse2(
+        _mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), color16));
+    __m128i s_hi = Div255Sse2(
+        _mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), color16));
+    __m128i lo = BlendSse2(_mm_unpacklo_epi8(d, zero), s_lo);
+    __m128i hi = BlendSse2(_mm_unpackhi_epi8(d, zero), s_hi);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_packus_epi16(lo, hi));
+  }
+  for (; i < count; ++i) {
+    dst[i] = Blend(dst[i], Modulate(src[i], color));
+  }
+}
+
+// Blends src premultiplied with alpha over dst (See BlendPremultiplied).
+inline __m128i BlendPremultipliedSse2(__m128i dst, __m128i src) {
+  __m128i alpha = AlphaSse2(src);
+  __m128i inv_alpha = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+  src = _mm_min_epi16(src, alpha);
+  return Div255Sse2(_mm_add_epi16(_mm_mullo_epi16(src, _mm_set1_epi16(255)),
+                                  _mm_mullo_epi16(dst, inv_alpha)));
+}
+
+void BlendTexelsPremultipliedSse2(uint32_t* dst, const uint32_t* src,
+                                  int count, uint32_t color) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i color16 = _mm_unpacklo_epi8(_mm_set1_epi32(int(color)), zero);
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i d = _mm_loadu_si128(reinterpret_cast<__m128i*>(dst + i));
+    __m128i s_lo = Div255Sse2(
+        _mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), color16));
+    __m128i s_hi = Div255Sse2(
+        _mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), color16));
+    __m128i lo = BlendPremultipliedSse2(_mm_unpacklo_epi8(d, zero), s_lo);
+    __m128i hi = BlendPremultipliedSse2(_mm_unpackhi_epi8(d, zero), s_hi);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                     _mm_packus_epi16(lo, hi));
+  }
+  for (; i < count; ++i) {
+    dst[i] = BlendPremultiplied(dst[i], Modulate(src[i], color));
+  }
+}
+
+#endif  // EL_SOFTWARE_RENDERER_SSE2
+
+#ifdef EL_SOFTWARE_RENDERER_AVX2
+
+bool CpuSupportsAvx2() {
+#ifdef _MSC_VER
+  int info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) {
+    return false;
+  }
+  // AVX2 also needs the OS to save the ymm registers.
+  __cpuid(info, 1);
+  const int kOsxsaveAndAvx = (1 << 27) | (1 << 28);
+  if ((info[2] & kOsxsaveAndAvx) != kOsxsaveAndAvx ||
+      (_xgetbv(0) & 6) != 6) {
+    return false;
+  }
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  return __builtin_cpu_supports("avx2") != 0;
+#endif  // _MSC_VER
+}
+
+EL_TARGET_AVX2 inline __m256i Div255Avx2(__m256i x) {
+  x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+  return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+EL_TARGET_AVX2 inline __m256i AlphaAvx2(__m256i x) {
+  x = _mm256_shufflelo_epi16(x, _MM_SHUFFLE(3, 3, 3, 3));
+  return _mm256_shufflehi_epi16(x, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+EL_TARGET_AVX2 inline __m256i BlendAvx2(__m256i dst, __m256i src) {
+  __m256i alpha = AlphaAvx2(src);
+  __m256i inv_alpha = _mm256_sub_epi16(_mm256_set1_epi16(255), alpha);
+  return Div255Avx2(_mm256_add_epi16(_mm256_mullo_epi16(src, alpha),
+                                     _mm256_mullo_epi16(dst, inv_alpha)));
+}
+
+// Unpacking and packing works within 128 bit lanes, so the pixel order is
+// preserved without any permutes.
+
+EL_TARGET_AVX2 void BlendColorAvx2(uint32_t* dst, int count, uint32_t color) {
+  if ((color >> 24) == 255) {
+    std::fill_n(dst, count, color);
+    return;
+  }
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i src =
+      _mm256_unpacklo_epi8(_mm256_set1_epi32(int(color)), zero);
+  const __m256i alpha = AlphaAvx2(src);
+  const __m256i src_alpha = _mm256_mullo_epi16(src, alpha);
+  const __m256i inv_alpha = _mm256_sub_epi16(_mm256_set1_epi16(255), alpha);
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256i d = _mm256_loadu_si256(reinterpret_cast<__m256i*>(dst + i));
+    __m256i lo = _mm256_unpacklo_epi8(d, zero);
+    __m256i hi = _mm256_unpackhi_epi8(d, zero);
+    lo = Div255Avx2(
+        _mm256_add_epi16(src_alpha, _mm256_mullo_epi16(lo, inv_alpha)));
+    hi = Div255Avx2(
+        _mm256_add_epi16(src_alpha, _mm256_mullo_epi16(hi, inv_alpha)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                        _mm256_packus_epi16(lo, hi));
+  }
+  for (; i < count; ++i) {
+    dst[i] = Blend(dst[i], color);
+  }
+}
+
+EL_TARGET_AVX2 void BlendTexelsAvx2(uint32_t* dst, const uint32_t* src,
+                                    int count, uint32_t color) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i color16 =
+      _mm256_unpacklo_epi8(_mm256_set1_epi32(int(color)), zero);
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256i s =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    __m256i d = _mm256_loadu_si256(reinterpret_cast<__m256i*>(dst + i));
+    __m256i s_lo = Div255Avx2(
+        _mm256_mullo_epi16(_mm256_unpacklo_epi8(s, zero), color16));
+    __m256i s_hi = Div255Avx2(
+        _mm256_mullo_epi16(_mm256_unpackhi_epi8(s, zero), color16));
+    __m256i lo = BlendAvx2(_mm256_unpacklo_epi8(d, zero), s_lo);
+    __m256i hi = BlendAvx2(_mm256_unpackhi_epi8(d, zero), s_hi);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                        _mm256_packus_epi16(lo, hi));
+  }
+  for (; i < count; ++i) {
+    dst[i] = Blend(dst[i], Modulate(src[i], color));
+  }
+}
+
+EL_TARGET_AVX2 inline __m256i BlendPremultipliedAvx2(__m256i dst,
+                                                     __m256i src) {
+  __m256i alpha = AlphaAvx2(src);
+  __m256i inv_alpha = _mm256_sub_epi16(_mm256_set1_epi16(255), alpha);
+  src = _mm256_min_epi16(src, alpha);
+  return Div255Avx2(
+      _mm256_add_epi16(_mm256_mullo_epi16(src, _mm256_set1_epi16(255)),
+                       _mm256_mullo_epi16(dst, inv_alpha)));
+}
+
+EL_TARGET_AVX2 void BlendTexelsPremultipliedAvx2(uint32_t* dst,
+                                                 const uint32_t* src,
+                                                 int count, uint32_t color) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i color16 =
+      _mm256_unpacklo_epi8(_mm256_set1_epi32(int(color)), zero);
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256i s =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    __m256i d = _mm256_loadu_si256(reinterpret_cast<__m256i*>(dst + i));
+    __m256i s_lo = Div255Avx2(
+        _mm256_mullo_epi16(_mm256_unpacklo_epi8(s, zero), color16));
+    __m256i s_hi = Div255Avx2(
+        _mm256_mullo_epi16(_mm256_unpackhi_epi8(s, zero), color16));
+    __m256i lo = BlendPremultipliedAvx2(_mm256_unpacklo_epi8(d, zero), s_lo);
+    __m256i hi = BlendPremultipliedAvx2(_mm256_unpackhi_epi8(d, zero), s_hi);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i),
+                        _mm256_packus_epi16(lo, hi));
+  }
+  for (; i < count; ++i) {
+    dst[i] = BlendPremultiplied(dst[i], Modulate(src[i], color));
+  }
+}
+
+#endif  // EL_SOFTWARE_RENDERER_AVX2
+
+inline float SmoothStep(float edge0, float edge1, float x) {
+  float t = std::min(std::max((x - edge0) / (edge1 - edge0), 0.0f), 1.0f);
+  return t * t * (3.0f - 2.0f * t);
+}
+
+}  // namespace
+
+// Span drawing functions for one instruction set.
+struct SoftwareRenderer::Kernels {
+  // Blends the color over count pixels.
+  void (*blend_color)(uint32_t* dst, int count, uint32_t color);
+  // Blends count texels modulated by the color over the pixels.
+  void (*blend_texels)(uint32_t* dst, const uint32_t* src, int count,
+                       uint32_t color);
+  // Blends count texels premultiplied with alpha, modulated by the color,
+  // over the pixels.
+  void (*blend_texels_premultiplied)(uint32_t* dst, const uint32_t* src,
+                                     int count, uint32_t color);
+};
+
+class SoftwareRenderer::SoftwareBitmap : public Bitmap {
+ public:
+  SoftwareBitmap(SoftwareRenderer* renderer, int width, int height)
+      : renderer_(renderer),
+        width_(width),
+        height_(height),
+        texels_(width * height) {
+    assert(width == util::GetNearestPowerOfTwo(width));
+    assert(height == util::GetNearestPowerOfTwo(height));
+  }
+  ~SoftwareBitmap() override {
+    assert(renderer_->render_target_ != this);
+    renderer_->FlushBitmap(this);
+    renderer_->FlushCommands();
+  }
+
+  int width() override { return width_; }
+  int height() override { return height_; }
+
+  void set_data(uint32_t* data) override {
+    renderer_->FlushBitmap(this);
+    renderer_->FlushCommands();
+    if (!data) {
+      std::fill(texels_.begin(), texels_.end(), 0);
+      return;
+    }
+    for (size_t i = 0; i < texels_.size(); ++i) {
+      texels_[i] = SwapRedBlue(data[i]);
+    }
+  }
+
+  // Gets the texel at x, y, wrapping coordinates outside the bitmap.
+  uint32_t texel(int x, int y) const {
+    return texels_[(x & (width_ - 1)) + (y & (height_ - 1)) * width_];
+  }
+
+  SoftwareRenderer* renderer_;
+  int width_;
+  int height_;
+  // BGRA32 like the framebuffer (premultiplied with alpha in render targets).
+  std::vector<uint32_t> texels_;
+};
+
+SoftwareRenderer::SoftwareRenderer() {
+  batch_.vertices = vertices_;
+  set_simd_level(supported_simd_level());
+}
+
+SoftwareRenderer::~SoftwareRenderer() = default;
+
+void SoftwareRenderer::BeginPaint(int render_target_w, int render_target_h) {
+  if (render_target_w != width_ || render_target_h != height_) {
+    set_size(render_target_w, render_target_h);
+  }
+  Renderer::BeginPaint(render_target_w, render_target_h);
+}
+
+void SoftwareRenderer::EndPaint() {
+  Renderer::EndPaint();
+  FlushCommands();
+}
+
+std::unique_ptr<Bitmap> SoftwareRenderer::CreateBitmap(int width, int height,
+                                                       uint32_t* data) {
+  auto bitmap = std::make_unique<SoftwareBitmap>(this, width, height);
+  bitmap->set_data(data);
+  return std::unique_ptr<Bitmap>(std::move(bitmap));
+}
+
+std::unique_ptr<Bitmap> SoftwareRenderer::CreateRenderTarget(int width,
+                                                             int height) {
+  // The texels start out transparent.
+  auto target = std::make_unique<SoftwareBitmap>(
+      this, util::GetNearestPowerOfTwo(std::max(width, 1)),
+      util::GetNearestPowerOfTwo(std::max(height, 1)));
+  return std::unique_ptr<Bitmap>(std::move(target));
+}
+
+void SoftwareRenderer::set_size(int width, int height) {
+  FlushCommands();
+  width_ = std::max(width, 0);
+  height_ = std::max(height, 0);
+  pixels_.assign(size_t(width_) * height_, 0);
+  scissor_rect_.reset(0, 0, width_, height_);
+}
+
+void SoftwareRenderer::Clear(const Color& color) {
+  FlushCommands();
+  // Color is stored in BGRA order, like the framebuffer.
+  std::fill(pixels_.begin(), pixels_.end(), uint32_t(color));
+}
+
+SoftwareRenderer::SimdLevel SoftwareRenderer::supported_simd_level() {
+#ifdef EL_SOFTWARE_RENDERER_AVX2
+  static const bool avx2 = CpuSupportsAvx2();
+  if (avx2) {
+    return SimdLevel::kAvx2;
+  }
+#endif  // EL_SOFTWARE_RENDERER_AVX2
+#ifdef EL_SOFTWARE_RENDERER_SSE2
+  return SimdLevel::kSse2;
+#else
+  return SimdLevel::kScalar;
+#endif  // EL_SOFTWARE_RENDERER_SSE2
+}
+
+void SoftwareRenderer::set_simd_level(SimdLevel level) {
+  FlushCommands();
+  simd_level_ = std::min(level, supported_simd_level());
+  switch (simd_level_) {
+#ifdef EL_SOFTWARE_RENDERER_AVX2
+    case SimdLevel::kAvx2: {
+      static const Kernels kAvx2Kernels = {BlendColorAvx2, BlendTexelsAvx2,
+                                           BlendTexelsPremultipliedAvx2};
+      kernels_ = &kAvx2Kernels;
+      break;
+    }
+#endif  // EL_SOFTWARE_RENDERER_AVX2
+#ifdef EL_SOFTWARE_RENDERER_SSE2
+    case SimdLevel::kSse2: {
+      static const Kernels kSse2Kernels = {BlendColorSse2, BlendTexelsSse2,
+                                           BlendTexelsPremultipliedSse2};
+      kernels_ = &kSse2Kernels;
+      break;
+    }
+#endif  // EL_SOFTWARE_RENDERER_SSE2
+    default: {
+      static const Kernels kScalarKernels = {
+          BlendColorScalar, BlendTexelsScalar, BlendTexelsPremultipliedScalar};
+      kernels_ = &kScalarKernels;
+      break;
+    }
+  }
+}
+
+void SoftwareRenderer::set_thread_count(int thread_count) {
+  FlushCommands();
+  thread_count_ = std::max(thread_count, 1);
+  workers_.reset();
+  if (thread_count_ > 1) {
+    workers_ = std::make_unique<util::WorkPool>(thread_count_);
+  }
+}
+
+void SoftwareRenderer::RenderBatch(Batch* batch) {
+  auto bitmap = static_cast<SoftwareBitmap*>(batch->bitmap);
+  const Vertex* v = batch->vertices;
+  size_t i = 0;
+  while (i + 3 <= batch->vertex_count) {
+    Command command;
+    command.bitmap = bitmap;
+    command.is_distance_field = batch->is_distance_field;
+    command.is_premultiplied = batch->is_premultiplied;
+    // Quads from AddQuadInternal are two triangles with the vertices 2 and 1
+    // as the top left and bottom right corners.
+    const Vertex* q = v + i;
+    if (i + 6 <= batch->vertex_count && q[0].x == q[2].x &&
+        q[0].y == q[1].y && q[5].x == q[1].x && q[5].y == q[2].y &&
+        q[3].x == q[2].x && q[3].y == q[2].y && q[4].x == q[1].x &&
+        q[4].y == q[1].y && q[0].u == q[2].u && q[0].v == q[1].v &&
+        q[5].u == q[1].u && q[5].v == q[2].v && q[3].u == q[2].u &&
+        q[3].v == q[2].v && q[4].u == q[1].u && q[4].v == q[1].v &&
+        q[0].color == q[2].color && q[1].color == q[2].color &&
+        q[5].color == q[2].color) {
+      command.left = q[2].x;
+      command.top = q[2].y;
+      command.right = q[1].x;
+      command.bottom = q[1].y;
+      command.u0 = q[2].u;
+      command.v0 = q[2].v;
+      command.u1 = q[1].u;
+      command.v1 = q[1].v;
+      command.color = SwapRedBlue(q[2].color);
+      command.triangle = -1;
+      // Pixels with their center inside the quad.
+      command.x0 = int(std::ceil(std::min(q[2].x, q[1].x) - 0.5f));
+      command.x1 = int(std::ceil(std::max(q[2].x, q[1].x) - 0.5f));
+      command.y0 = int(std::ceil(std::min(q[2].y, q[1].y) - 0.5f));
+      command.y1 = int(std::ceil(std::max(q[2].y, q[1].y) - 0.5f));
+      i += 6;
+    } else {
+      command.triangle = int(triangles_.size() / 3);
+      triangles_.insert(triangles_.end(), q, q + 3);
+      command.x0 = int(std::floor(std::min({q[0].x, q[1].x, q[2].x})));
+      command.x1 = int(std::ceil(std::max({q[0].x, q[1].x, q[2].x})));
+      command.y0 = int(std::floor(std::min({q[0].y, q[1].y, q[2].y})));
+      command.y1 = int(std::ceil(std::max({q[0].y, q[1].y, q[2].y})));
+      i += 3;
+    }
+    command.x0 = std::max(command.x0, scissor_rect_.x);
+    command.y0 = std::max(command.y0, scissor_rect_.y);
+    command.x1 = std::min(command.x1, scissor_rect_.x + scissor_rect_.w);
+    command.y1 = std::min(command.y1, scissor_rect_.y + scissor_rect_.h);
+    if (command.x0 < command.x1 && command.y0 < command.y1) {
+      commands_.push_back(command);
+    }
+  }
+  if (thread_count_ == 1) {
+    FlushCommands();
+  }
+}
+
+void SoftwareRenderer::set_clip_rect(const Rect& rect) {
+  scissor_rect_ = rect.Clip(Rect(0, 0, width_, height_));
+}
+
+void SoftwareRenderer::set_render_target(Bitmap* target, bool clear) {
+  FlushCommands();
+  if (render_target_) {
+    pixels_.swap(render_target_->texels_);
+  }
+  render_target_ = static_cast<SoftwareBitmap*>(target);
+  if (render_target_) {
+    pixels_.swap(render_target_->texels_);
+    if (clear) {
+      std::fill(pixels_.begin(), pixels_.end(), 0);
+    }
+  }
+  width_ = screen_rect_.w;
+  height_ = screen_rect_.h;
+}
+
+void SoftwareRenderer::FlushCommands() {
+  if (commands_.empty()) {
+    return;
+  }
+  if (!workers_) {
+    DrawTile(0, height_, &scratch_);
+  } else {
+    int tile_count = (height_ + kTileHeight - 1) / kTileHeight;
+    workers_->ParallelFor(size_t(tile_count), [this](size_t tile) {
+      std::vector<uint32_t> scratch;
+      int y0 = int(tile) * kTileHeight;
+      DrawTile(y0, std::min(y0 + kTileHeight, height_), &scratch);
+    });
+  }
+  commands_.clear();
+  triangles_.clear();
+}
+
+void SoftwareRenderer::DrawTile(int y0, int y1,
+                                std::vector<uint32_t>* scratch) {
+  for (const Command& command : commands_) {
+    int tile_y0 = std::max(command.y0, y0);
+    int tile_y1 = std::min(command.y1, y1);
+    if (tile_y0 >= tile_y1) {
+      continue;
+    }
+    if (command.triangle >= 0) {
+      DrawTriangle(command, tile_y0, tile_y1);
+    } else if (command.bitmap && command.is_distance_field) {
+      DrawDistanceFieldQuad(command, tile_y0, tile_y1);
+    } else {
+      DrawQuad(command, tile_y0, tile_y1, scratch);
+    }
+  }
+}
+
+void SoftwareRenderer::DrawQuad(const Command& command, int y0, int y1,
+                                std::vector<uint32_t>* scratch) {
+  const int count = command.x1 - command.x0;
+  uint32_t* dst = &pixels_[size_t(y0) * width_ + command.x0];
+  auto blend_color = kernels_->blend_color;
+  auto blend_texels = kernels_->blend_texels;
+  if (command.is_premultiplied) {
+    blend_color = BlendColorPremultipliedScalar;
+    blend_texels = kernels_->blend_texels_premultiplied;
+  } else if (render_target_) {
+    blend_color = BlendColorOffscreenScalar;
+    blend_texels = BlendTexelsOffscreenScalar;
+  }
+  if (!command.bitmap) {
+    for (int y = y0; y < y1; ++y, dst += width_) {
+      blend_color(dst, count, command.color);
+    }
+    return;
+  }
+
+  // Nearest texel columns, stepped in 16.16 fixed point from the pixel
+  // centers.
+  const SoftwareBitmap* bitmap = command.bitmap;
+  const int mask_x = bitmap->width_ - 1;
+  const double texels_per_x = double(command.u1 - command.u0) *
+                              bitmap->width_ / (command.right - command.left);
+  const double texels_per_y = double(command.v1 - command.v0) *
+                              bitmap->height_ / (command.bottom - command.top);
+  const int64_t step_u = std::llround(texels_per_x * 65536);
+  const int64_t start_u = int64_t(
+      std::floor((double(command.u0) * bitmap->width_ +
+                  (command.x0 + 0.5 - command.left) * texels_per_x) *
+                 65536));
+  const int first_column = int(start_u >> 16) & mask_x;
+  // 1:1 mapped spans that don't wrap are read directly from the bitmap.
+  const bool contiguous =
+      step_u == 65536 && first_column + count <= bitmap->width_;
+  uint32_t* columns = nullptr;
+  uint32_t* texels = nullptr;
+  if (!contiguous) {
+    scratch->resize(size_t(count) * 2);
+    columns = scratch->data();
+    texels = columns + count;
+    int64_t u = start_u;
+    for (int i = 0; i < count; ++i, u += step_u) {
+      columns[i] = uint32_t(u >> 16) & mask_x;
+    }
+  }
+
+  for (int y = y0; y < y1; ++y, dst += width_) {
+    const double v = double(command.v0) * bitmap->height_ +
+                     (y + 0.5 - command.top) * texels_per_y;
+    const int row = int(std::floor(v)) & (bitmap->height_ - 1);
+    const uint32_t* src = &bitmap->texels_[size_t(row) * bitmap->width_];
+    if (contiguous) {
+      src += first_column;
+    } else {
+      for (int i = 0; i < count; ++i) {
+        texels[i] = src[columns[i]];
+      }
+      src = texels;
+    }
+    blend_texels(dst, src, count, command.color);
+  }
+}
+
+namespace {
+
+// Gets the coverage (0 - 1) of a distance field bitmap at the texel
+// coordinate u, v, smoothed over the change of the field per pixel like the
+// fwidth() in the GL renderer shader. du_dx... is the change of the texel
+// coordinates per pixel.
+template <typename BitmapType>
+float SampleDistanceField(const BitmapType* bitmap, float u, float v,
+                          float du_dx, float dv_dx, float du_dy,
+                          float dv_dy) {
+  // Bilinear filtering between the four closest texel centers.
+  const float x = u - 0.5f;
+  const float y = v - 0.5f;
+  const int ix = int(std::floor(x));
+  const int iy = int(std::floor(y));
+  const float fx = x - ix;
+  const float fy = y - iy;
+  const float a00 = (bitmap->texel(ix, iy) >> 24) / 255.0f;
+  const float a10 = (bitmap->texel(ix + 1, iy) >> 24) / 255.0f;
+  const float a01 = (bitmap->texel(ix, iy + 1) >> 24) / 255.0f;
+  const float a11 = (bitmap->texel(ix + 1, iy + 1) >> 24) / 255.0f;
+  const float top = a00 + (a10 - a00) * fx;
+  const float bottom = a01 + (a11 - a01) * fx;
+  const float alpha = top + (bottom - top) * fy;
+
+  const float da_du = (a10 - a00) + ((a11 - a01) - (a10 - a00)) * fy;
+  const float da_dv = (a01 - a00) + ((a11 - a10) - (a01 - a00)) * fx;
+  const float fwidth = std::abs(da_du * du_dx + da_dv * dv_dx) +
+                       std::abs(da_du * du_dy + da_dv * dv_dy);
+  const float w = std::min(std::max(fwidth * 0.7f, 0.001f), 0.5f);
+  return SmoothStep(0.5f - w, 0.5f + w, alpha);
+}
+
+using BlendFunction = uint32_t (*)(uint32_t dst, uint32_t src);
+
+// Gets the function blending a pixel of a command (See Blend).
+inline BlendFunction GetBlendFunction(bool is_premultiplied,
+                                      bool is_render_target) {
+  if (is_premultiplied) {
+    return BlendPremultiplied;
+  }
+  return is_render_target ? BlendOffscreen : Blend;
+}
+
+// Scales the alpha of the color with the coverage.
+inline uint32_t ApplyCoverage(uint32_t color, float coverage) {
+  uint32_t alpha = uint32_t((color >> 24) * coverage + 0.5f);
+  return (color & 0x00FFFFFF) | (alpha << 24);
+}
+
+}  // namespace
+
+void SoftwareRenderer::DrawDistanceFieldQuad(const Command& command, int y0,
+                                             int y1) {
+  const SoftwareBitmap* bitmap = command.bitmap;
+  const float texels_per_x = (command.u1 - command.u0) * bitmap->width_ /
+                             (command.right - command.left);
+  const float texels_per_y = (command.v1 - command.v0) * bitmap->height_ /
+                             (command.bottom - command.top);
+  const auto blend =
+      GetBlendFunction(command.is_premultiplied, render_target_ != nullptr);
+  for (int y = y0; y < y1; ++y) {
+    uint32_t* dst = &pixels_[size_t(y) * width_];
+    const float v = command.v0 * bitmap->height_ +
+                    (y + 0.5f - command.top) * texels_per_y;
+    for (int x = command.x0; x < command.x1; ++x) {
+      const float u = command.u0 * bitmap->width_ +
+                      (x + 0.5f - command.left) * texels_per_x;
+      float coverage =
+          SampleDistanceField(bitmap, u, v, texels_per_x, 0, 0, texels_per_y);
+      dst[x] = blend(dst[x], ApplyCoverage(command.color, coverage));
+    }
+  }
+}
+
+void SoftwareRenderer::DrawTriangle(const Command& command, int y0, int y1) {
+  const Vertex* t = &triangles_[size_t(command.triangle) * 3];
+  // Edge function: positive on the left side of a -> b.
+  auto edge = [](const Vertex& a, const Vertex& b, float x, float y) {
+    return (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+  };
+  const Vertex* v[3] = {&t[0], &t[1], &t[2]};
+  float area = edge(*v[0], *v[1], v[2]->x, v[2]->y);
+  if (area == 0) {
+    return;
+  }
+  if (area < 0) {
+    std::swap(v[1], v[2]);
+    area = -area;
+  }
+  // Pixels exactly on an edge shared by two triangles are only drawn by one
+  // of them, so they aren't blended twice.
+  bool owns_edge[3];
+  for (int i = 0; i < 3; ++i) {
+    const Vertex& a = *v[(i + 1) % 3];
+    const Vertex& b = *v[(i + 2) % 3];
+    owns_edge[i] = b.y - a.y > 0 || (b.y == a.y && b.x - a.x < 0);
+  }
+
+  // Interpolation is affine, so the change per pixel is constant.
+  float db_dx[3];
+  float db_dy[3];
+  for (int i = 0; i < 3; ++i) {
+    const Vertex& a = *v[(i + 1) % 3];
+    const Vertex& b = *v[(i + 2) % 3];
+    db_dx[i] = (a.y - b.y) / area;
+    db_dy[i] = (b.x - a.x) / area;
+  }
+  const SoftwareBitmap* bitmap = command.bitmap;
+  const float bitmap_w = bitmap ? float(bitmap->width_) : 0;
+  const float bitmap_h = bitmap ? float(bitmap->height_) : 0;
+  float du_dx = 0, dv_dx = 0, du_dy = 0, dv_dy = 0;
+  for (int i = 0; i < 3; ++i) {
+    du_dx += v[i]->u * bitmap_w * db_dx[i];
+    dv_dx += v[i]->v * bitmap_h * db_dx[i];
+    du_dy += v[i]->u * bitmap_w * db_dy[i];
+    dv_dy += v[i]->v * bitmap_h * db_dy[i];
+  }
+
+  const auto blend =
+      GetBlendFunction(command.is_premultiplied, render_target_ != nullptr);
+  for (int y = y0; y < y1; ++y) {
+    uint32_t* dst = &pixels_[size_t(y) * width_];
+    const float py = y + 0.5f;
+    for (int x = command.x0; x < command.x1; ++x) {
+      const float px = x + 0.5f;
+      float b[3];
+      bool inside = true;
+      for (int i = 0; i < 3 && inside; ++i) {
+        float e = edge(*v[(i + 1) % 3], *v[(i + 2) % 3], px, py);
+        inside = e > 0 || (e == 0 && owns_edge[i]);
+        b[i] = e / area;
+      }
+      if (!inside) {
+        continue;
+      }
+      uint32_t color = 0;
+      for (int shift = 0; shift < 32; shift += 8) {
+        float channel = 0;
+        for (int i = 0; i < 3; ++i) {
+          channel += ((v[i]->color >> shift) & 0xFF) * b[i];
+        }
+        color |= uint32_t(std::min(std::max(channel + 0.5f, 0.0f), 255.0f))
+                 << shift;
+      }
+      color = SwapRedBlue(color);
+      if (bitmap) {
+        float u = 0, tv = 0;
+        for (int i = 0; i < 3; ++i) {
+          u += v[i]->u * bitmap_w * b[i];
+          tv += v[i]->v * bitmap_h * b[i];
+        }
+        if (command.is_distance_field) {
+          float coverage = SampleDistanceField(bitmap, u, tv, du_dx, dv_dx,
+                                               du_dy, dv_dy);
+          color = ApplyCoverage(color, coverage);
+        } else {
+          color = Modulate(
+              bitmap->texel(int(std::floor(u)), int(std::floor(tv))), color);
+        }
+      }
+      dst[x] = blend(dst[x], color);
+    }
+  }
+}
+
+}  // namespace graphics
+}  // namespace el
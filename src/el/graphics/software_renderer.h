@@ -0,0 +1,160 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#ifndef EL_GRAPHICS_SOFTWARE_RENDERER_H_
+#define EL_GRAPHICS_SOFTWARE_RENDERER_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "el/color.h"
+#include "el/graphics/renderer.h"
+
+namespace el {
+namespace util {
+class WorkPool;
+}  // namespace util
+}  // namespace el
+
+namespace el {
+namespace graphics {
+
+// A renderer drawing into a BGRA32 framebuffer in memory, for hosts without a
+// GPU (headless servers streaming frames, CI, unit tests).
+//
+// The batches are drawn as axis-aligned quads (which is all the library
+// draws) with SSE2 or AVX2 span kernels when supported by the CPU, and any
+// other triangles with a slower scalar path. Colors are blended the same way
+// as the GL renderers (source alpha, one minus source alpha), but bitmaps are
+// sampled with nearest filtering. Bitmap data is read with the same byte order
+// as the GL renderers.
+//
+// With more than one thread (See set_thread_count), draw commands are queued
+// and the framebuffer is split into tiles of rows that are drawn in parallel
+// when the frame ends (or a bitmap in use changes).
+//
+// Render targets (See Renderer::CreateRenderTarget) are bitmaps in memory.
+// Drawing into them uses the scalar span functions, while drawing them uses
+// the SIMD ones.
+class SoftwareRenderer : public Renderer {
+ public:
+  // Vector instruction sets used to draw spans.
+  enum class SimdLevel {
+    kScalar,
+    kSse2,
+    kAvx2,
+  };
+
+  SoftwareRenderer();
+  ~SoftwareRenderer() override;
+
+  // Resizes the framebuffer to the render target size if needed.
+  void BeginPaint(int render_target_w, int render_target_h) override;
+  void EndPaint() override;
+
+  std::unique_ptr<Bitmap> CreateBitmap(int width, int height,
+                                       uint32_t* data) override;
+  std::unique_ptr<Bitmap> CreateRenderTarget(int width, int height) override;
+
+  bool supports_distance_field() const override { return true; }
+
+  using Renderer::set_clip_rect;
+
+  // Gets the framebuffer pixels in BGRA32 format (blue in the lowest byte),
+  // width() * height() pixels without padding between rows.
+  // Valid after EndPaint.
+  const uint32_t* pixels() const { return pixels_.data(); }
+  int width() const { return width_; }
+  int height() const { return height_; }
+
+  // Sets the size of the framebuffer. It's also resized by BeginPaint.
+  void set_size(int width, int height);
+
+  // Fills the framebuffer with the given color.
+  void Clear(const Color& color);
+
+  // Returns the best instruction set supported by this CPU (and build).
+  static SimdLevel supported_simd_level();
+  SimdLevel simd_level() const { return simd_level_; }
+  // Sets the instruction set to use, limited to what's supported. Mostly
+  // useful for benchmarking and for comparing against the scalar path.
+  void set_simd_level(SimdLevel level);
+
+  int thread_count() const { return thread_count_; }
+  // Sets the number of threads drawing tiles (including the calling thread).
+  // The default is 1, which draws each batch immediately on the calling
+  // thread.
+  void set_thread_count(int thread_count);
+
+ protected:
+  class SoftwareBitmap;
+  struct Kernels;
+
+  // A quad (or triangle) waiting to be drawn.
+  struct Command {
+    // Destination edges of the quad, with swapped edges if flipped.
+    float left, top, right, bottom;
+    // Texture coordinates at the edges above.
+    float u0, v0, u1, v1;
+    // Pixels to fill, already clipped.
+    int x0, y0, x1, y1;
+    uint32_t color;  // BGRA
+    SoftwareBitmap* bitmap;
+    bool is_distance_field;
+    // True if the bitmap colors are premultiplied with alpha (See
+    // Renderer::DrawRenderTarget).
+    bool is_premultiplied;
+    // Index of the vertices in triangles_ or -1 for quads.
+    int triangle;
+  };
+
+  static const uint32_t kMaxVertexBatchSize = 6 * 2048;
+  // Height of the tiles drawn in parallel.
+  static const int kTileHeight = 32;
+
+  size_t max_vertex_batch_size() const override { return kMaxVertexBatchSize; }
+  void RenderBatch(Batch* batch) override;
+  void set_clip_rect(const Rect& rect) override;
+  void set_render_target(Bitmap* target, bool clear) override;
+
+  // Draws all queued commands.
+  void FlushCommands();
+  // Draws the queued commands within the rows y0 - y1.
+  void DrawTile(int y0, int y1, std::vector<uint32_t>* scratch);
+  void DrawQuad(const Command& command, int y0, int y1,
+                std::vector<uint32_t>* scratch);
+  void DrawDistanceFieldQuad(const Command& command, int y0, int y1);
+  void DrawTriangle(const Command& command, int y0, int y1);
+
+  std::vector<uint32_t> pixels_;
+  int width_ = 0;
+  int height_ = 0;
+  Rect scissor_rect_;
+
+  SimdLevel simd_level_;
+  const Kernels* kernels_ = nullptr;
+
+  // The render target drawn into, or nullptr for the framebuffer. Its texels
+  // are swapped with pixels_ while it's bound, so all drawing goes to pixels_.
+  SoftwareBitmap* render_target_ = nullptr;
+
+  int thread_count_ = 1;
+  std::unique_ptr<util::WorkPool> workers_;
+
+  std::vector<Command> commands_;
+  std::vector<Vertex> triangles_;
+  std::vector<uint32_t> scratch_;
+  Vertex vertices_[kMaxVertexBatchSize];
+};
+
+}  // namespace graphics
+}  // namespace el
+
+#endif  // EL_GRAPHICS_SOFTWARE_RENDERER_H_
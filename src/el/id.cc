@@ -7,72 +7,88 @@
  ******************************************************************************
  */
 
-#include <unordered_map>
-
 #include "el/id.h"
 #include "el/util/debug.h"
 #include "el/util/hash.h"
 
 namespace el {
 
-#ifdef EL_RUNTIME_DEBUG_INFO
+// static
+IdRegistry* IdRegistry::get() {
+  // Function local so it's available to TBIDs constructed during static
+  // initialization.
+  static IdRegistry registry;
+  return &registry;
+}
+
+bool IdRegistry::Register(const char* string) {
+  uint32_t id = util::hash(string);
+  if (!id) {
+    return true;
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto result = m_strings.emplace(id, std::unique_ptr<std::string>());
+  if (result.second) {
+    result.first->second = std::make_unique<std::string>(string);
+    return true;
+  }
+  if (result.first->second->compare(string) == 0) {
+    return true;
+  }
+  ++m_collision_count;
+  TBDebugOut("TBID collision: \"%s\" and \"%s\" both hash to %u.\n",
+             result.first->second->c_str(), string, id);
+  // If this happens, 2 different strings result in the same hash.
+  // Change one of them so they don't alias.
+  assert(!m_verifying || !"TBID collision detected");
+  return false;
+}
+
+const char* IdRegistry::GetString(uint32_t id) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_strings.find(id);
+  return it != m_strings.end() ? it->second->c_str() : nullptr;
+}
+
+size_t IdRegistry::size() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_strings.size();
+}
+
+size_t IdRegistry::collision_count() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_collision_count;
+}
 
-#if CHECKED
-// Hash table for checking if we get any collisions (same hash value for TBID's
-// created from different strings).
-std::unordered_map<uint32_t, std::unique_ptr<TBID>> all_observed_ids_;
-#endif  // CHECKED
-
-std::unique_ptr<TBID> TBID::UnsafeClone(TBID* source) {
-  auto clone = std::make_unique<TBID>(0);
-  clone->id_ = source->id_;
-  clone->debug_string = source->debug_string;
-  return clone;
+void IdRegistry::Clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_strings.clear();
 }
 
+// static
+TBID TBID::Intern(const char* string) {
+  IdRegistry::get()->Register(string);
+  return TBID(string);
+}
+
+#ifdef EL_RUNTIME_DEBUG_INFO
+
 void TBID::reset(uint32_t newid) {
   id_ = newid;
   debug_string.clear();
-
-#ifdef CHECKED
-  if (id_ && !all_observed_ids_.count(id_)) {
-    all_observed_ids_.emplace(id_, UnsafeClone(this));
-  }
-#endif  // CHECKED
 }
 
 void TBID::reset(const TBID& newid) {
   id_ = newid;
   debug_string = newid.debug_string;
-
-#ifdef CHECKED
-  if (id_) {
-    auto& other_id = all_observed_ids_.find(id_);
-    if (other_id != all_observed_ids_.end()) {
-      // If this happens, 2 different strings result in the same hash.
-      // It might be a good idea to change one of them, but it might not matter.
-      assert(other_id->second->debug_string.compare(debug_string) == 0);
-    } else {
-      all_observed_ids_.emplace(id_, UnsafeClone(this));
-    }
-  }
-#endif  // CHECKED
 }
 
 void TBID::reset(const char* string) {
   id_ = util::hash(string);
-  debug_string = string;
-
-#ifdef CHECKED
-  if (id_) {
-    auto& other_id = all_observed_ids_.find(id_);
-    if (other_id != all_observed_ids_.end()) {
-      assert(other_id->second->debug_string.compare(debug_string) == 0);
-    } else {
-      all_observed_ids_.emplace(id_, UnsafeClone(this));
-    }
+  debug_string = string ? string : "";
+  if (IdRegistry::get()->is_verifying()) {
+    IdRegistry::get()->Register(string);
   }
-#endif  // CHECKED
 }
 
 #else
@@ -13,10 +13,12 @@
 #include <cassert>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "el/config.h"
 #include "el/util/hash.h"
+#include "el/util/id_map.h"
 
 namespace el {
 
@@ -42,6 +44,11 @@ class TBID {
   void reset(const char* string);
 #endif  // EL_RUNTIME_DEBUG_INFO
 
+  // Creates a TBID from the string and registers the string in the
+  // IdRegistry, so it can be looked up from the id and any hash collision with
+  // a different string is detected.
+  static TBID Intern(const char* string);
+
   operator uint32_t() const { return id_; }
   const TBID& operator=(const TBID& id) {
     reset(id);
@@ -51,8 +58,6 @@ class TBID {
  private:
   uint32_t id_;
 
-  std::unique_ptr<TBID> UnsafeClone(TBID* source);
-
  public:
 #ifdef EL_RUNTIME_DEBUG_INFO
   // This string is here to aid debugging (Only in debug builds!)
@@ -64,6 +69,54 @@ class TBID {
 static_assert(sizeof(TBID) == sizeof(uint32_t), "Treated as uint32_t");
 #endif  // !EL_RUNTIME_DEBUG_INFO
 
+// Global registry of the strings TBIDs have been created from.
+// It maps ids back to their strings, and detects when two different strings
+// hash to the same id (which would make them silently alias each other).
+//
+// Strings are registered with TBID::Intern or Register. With verification
+// enabled, every TBID created from a string in EL_RUNTIME_DEBUG_INFO builds is
+// also registered, and a collision will assert at registration time.
+// Verification is enabled by default in CHECKED builds.
+// It's safe to use from several threads (TBIDs may be created while elements
+// are measured in parallel).
+class IdRegistry {
+ public:
+  static IdRegistry* get();
+
+  // Registers the string.
+  // Returns false if a different string is already registered with the same
+  // id. The first string registered stays registered.
+  bool Register(const char* string);
+
+  // Gets the string registered for the id, or nullptr if there is none.
+  // The string stays valid until Clear is called.
+  const char* GetString(uint32_t id) const;
+
+  bool is_verifying() const { return m_verifying; }
+  // Sets whether collisions should assert when registered.
+  void set_verifying(bool verifying) { m_verifying = verifying; }
+
+  // Gets the number of registered strings.
+  size_t size() const;
+  // Gets the number of collisions detected since created.
+  size_t collision_count() const;
+
+  // Removes all registered strings.
+  void Clear();
+
+ private:
+  mutable std::mutex m_mutex;
+  // Strings are allocated separately, so the pointers returned by GetString
+  // stay valid when the map moves its entries.
+  util::IdMap<std::unique_ptr<std::string>> m_strings;
+  size_t m_collision_count = 0;
+#ifdef CHECKED
+  bool m_verifying = true;
+#else
+  bool m_verifying = false;
+#endif  // CHECKED
+};
+
 }  // namespace el
 
 #endif  // EL_ID_H_
@@ -0,0 +1,357 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "el/io/archive_file_system.h"
+#include "el/util/lz4.h"
+
+namespace el {
+namespace io {
+
+// Archive layout (native byte order, since the index is read in place):
+//   Header
+//   uint32_t buckets[bucket_count + 1]  First entry index of each bucket.
+//   Entry entries[entry_count]          Sorted by name hash, 8 byte aligned.
+//   char names[]                        Entry names, not null terminated.
+//   File data                           Stored entries are 16 byte aligned.
+// An entry is found by hashing its name, mapping the hash to a bucket by its
+// top bits and comparing the (usually single) entry in that bucket.
+// Archives must be packed on a machine with the same byte order as the one
+// reading them. Others are rejected since their magic doesn't match.
+struct ArchiveFileSystem::Header {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t entry_count;
+  uint32_t bucket_count;
+  uint32_t names_offset;
+  uint32_t names_length;
+};
+
+struct ArchiveFileSystem::Entry {
+  uint32_t name_hash;
+  uint32_t name_offset;
+  uint32_t name_length;
+  uint32_t compression;
+  uint64_t data_offset;
+  uint32_t stored_size;
+  uint32_t size;
+};
+
+namespace {
+
+const uint32_t kArchiveMagic = 0x4B504C45;  // 'ELPK'
+const uint32_t kArchiveVersion = 1;
+const size_t kDataAlignment = 16;
+
+enum Compression : uint32_t {
+  kCompressionStored = 0,
+  kCompressionLz4 = 1,
+};
+
+// FNV-1a of the name. Unlike util::hash, this must be the same in all builds
+// since it's stored in the archive.
+uint32_t HashName(const char* name, size_t length) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < length; ++i) {
+    hash = (hash ^ uint8_t(name[i])) * 16777619u;
+  }
+  return hash;
+}
+
+uint32_t BucketIndex(uint32_t hash, uint32_t bucket_count) {
+  return uint32_t((uint64_t(hash) * bucket_count) >> 32);
+}
+
+
+std::string NormalizeName(std::string filename) {
+  std::replace(filename.begin(), filename.end(), '\\', '/');
+  while (filename.compare(0, 2, "./") == 0) {
+    filename.erase(0, 2);
+  }
+  return filename;
+}
+
+// A file in the archive. Stored files are read in place, and compressed files
+// are decompressed on first access.
+class ArchiveFile : public File {
+ public:
+  ArchiveFile(const uint8_t* stored_data, size_t stored_size, size_t size,
+              bool is_compressed)
+      : stored_data_(stored_data),
+        stored_size_(stored_size),
+        size_(size),
+        is_compressed_(is_compressed) {}
+
+  size_t size() const override { return size_; }
+
+  size_t Read(void* buffer, size_t length) override {
+    const uint8_t* contents = data();
+    if (!contents) {
+      return 0;
+    }
+    size_t to_read = std::min(size_ - position_, length);
+    std::memcpy(buffer, contents + position_, to_read);
+    position_ += to_read;
+    return to_read;
+  }
+
+  const uint8_t* data() const override {
+    if (!is_compressed_) {
+      return stored_data_;
+    }
+    if (decompressed_.empty() && size_) {
+      decompressed_.resize(size_);
+      if (!util::Lz4Decompress(stored_data_, stored_size_,
+                               decompressed_.data(), size_)) {
+        decompressed_.clear();
+        return nullptr;
+      }
+    }
+    return decompressed_.data();
+  }
+
+ private:
+  const uint8_t* stored_data_;
+  size_t stored_size_;
+  size_t size_;
+  bool is_compressed_;
+  size_t position_ = 0;
+  mutable std::vector<uint8_t> decompressed_;
+};
+
+}  // namespace
+
+// static
+size_t ArchiveFileSystem::EntriesOffset(uint32_t bucket_count) {
+  size_t offset =
+      sizeof(Header) + (size_t(bucket_count) + 1) * sizeof(uint32_t);
+  return (offset + 7) & ~size_t(7);
+}
+
+std::unique_ptr<ArchiveFileSystem> ArchiveFileSystem::Create(
+    std::unique_ptr<File> archive_file) {
+  if (!archive_file) {
+    return nullptr;
+  }
+  std::unique_ptr<ArchiveFileSystem> file_system(new ArchiveFileSystem());
+  file_system->size_ = archive_file->size();
+  file_system->data_ = archive_file->data();
+  if (!file_system->data_) {
+    file_system->buffer_.resize(file_system->size_);
+    file_system->size_ = archive_file->Read(file_system->buffer_.data(),
+                                            file_system->size_);
+    file_system->data_ = file_system->buffer_.data();
+  }
+  file_system->archive_file_ = std::move(archive_file);
+  if (!file_system->Init()) {
+    return nullptr;
+  }
+  return file_system;
+}
+
+bool ArchiveFileSystem::Init() {
+  if (size_ < sizeof(Header)) {
+    return false;
+  }
+  header_ = reinterpret_cast<const Header*>(data_);
+  if (header_->magic != kArchiveMagic || header_->version != kArchiveVersion ||
+      !header_->bucket_count) {
+    return false;
+  }
+  // Validate the index so lookups don't need to.
+  size_t buckets_offset = sizeof(Header);
+  size_t entries_offset = EntriesOffset(header_->bucket_count);
+  size_t entries_end =
+      entries_offset + size_t(header_->entry_count) * sizeof(Entry);
+  if (entries_end > size_ || header_->names_offset < entries_end ||
+      size_t(header_->names_offset) + header_->names_length > size_) {
+    return false;
+  }
+  buckets_ = reinterpret_cast<const uint32_t*>(data_ + buckets_offset);
+  entries_ = reinterpret_cast<const Entry*>(data_ + entries_offset);
+  names_ = reinterpret_cast<const char*>(data_ + header_->names_offset);
+  for (uint32_t i = 0; i <= header_->bucket_count; ++i) {
+    if (buckets_[i] > header_->entry_count ||
+        (i && buckets_[i] < buckets_[i - 1])) {
+      return false;
+    }
+  }
+  for (uint32_t i = 0; i < header_->entry_count; ++i) {
+    const Entry& entry = entries_[i];
+    if (size_t(entry.name_offset) + entry.name_length > header_->names_length ||
+        entry.data_offset > size_ ||
+        entry.stored_size > size_ - entry.data_offset ||
+        (entry.compression != kCompressionStored &&
+         entry.compression != kCompressionLz4) ||
+        (entry.compression == kCompressionStored &&
+         entry.stored_size != entry.size)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+size_t ArchiveFileSystem::file_count() const { return header_->entry_count; }
+
+const ArchiveFileSystem::Entry* ArchiveFileSystem::FindEntry(
+    const std::string& filename) const {
+  uint32_t hash = HashName(filename.c_str(), filename.size());
+  uint32_t bucket = BucketIndex(hash, header_->bucket_count);
+  for (uint32_t i = buckets_[bucket]; i < buckets_[bucket + 1]; ++i) {
+    const Entry& entry = entries_[i];
+    if (entry.name_hash == hash && entry.name_length == filename.size() &&
+        std::memcmp(names_ + entry.name_offset, filename.c_str(),
+                    filename.size()) == 0) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+std::unique_ptr<File> ArchiveFileSystem::OpenRead(std::string filename) {
+  const Entry* entry = FindEntry(NormalizeName(std::move(filename)));
+  if (!entry) {
+    return nullptr;
+  }
+  return std::make_unique<ArchiveFile>(
+      data_ + entry->data_offset, entry->stored_size, entry->size,
+      entry->compression == kCompressionLz4);
+}
+
+ArchiveWriter::ArchiveWriter() = default;
+
+ArchiveWriter::~ArchiveWriter() = default;
+
+bool ArchiveWriter::AddFile(std::string filename, const void* data,
+                            size_t length, bool compress) {
+  filename = NormalizeName(std::move(filename));
+  if (!names_.insert(filename).second) {
+    return false;
+  }
+  PendingFile file;
+  file.name_hash = HashName(filename.c_str(), filename.size());
+  file.name = std::move(filename);
+  file.size = uint32_t(length);
+  file.is_compressed = false;
+  auto bytes = reinterpret_cast<const uint8_t*>(data);
+  if (compress && length) {
+    file.data.resize(util::Lz4CompressBound(length));
+    size_t compressed_size =
+        util::Lz4Compress(bytes, length, file.data.data(), file.data.size());
+    // Only keep it compressed if it saves at least 1/8.
+    if (compressed_size && compressed_size < length - length / 8) {
+      file.data.resize(compressed_size);
+      file.is_compressed = true;
+    }
+  }
+  if (!file.is_compressed) {
+    file.data.assign(bytes, bytes + length);
+  }
+  files_.emplace_back(std::move(file));
+  return true;
+}
+
+void ArchiveWriter::Write(std::vector<uint8_t>* out) const {
+  using Header = ArchiveFileSystem::Header;
+  using Entry = ArchiveFileSystem::Entry;
+
+  std::vector<const PendingFile*> files;
+  for (auto& file : files_) {
+    files.push_back(&file);
+  }
+  std::sort(files.begin(), files.end(),
+            [](const PendingFile* a, const PendingFile* b) {
+              return a->name_hash != b->name_hash ? a->name_hash < b->name_hash
+                                                  : a->name < b->name;
+            });
+
+  Header header;
+  header.magic = kArchiveMagic;
+  header.version = kArchiveVersion;
+  header.entry_count = uint32_t(files.size());
+  header.bucket_count = 1;
+  while (header.bucket_count < header.entry_count) {
+    header.bucket_count *= 2;
+  }
+
+  std::vector<uint32_t> buckets(header.bucket_count + 1);
+  std::string names;
+  std::vector<Entry> entries(files.size());
+  for (size_t i = 0; i < files.size(); ++i) {
+    entries[i].name_hash = files[i]->name_hash;
+    entries[i].name_offset = uint32_t(names.size());
+    entries[i].name_length = uint32_t(files[i]->name.size());
+    entries[i].compression =
+        files[i]->is_compressed ? kCompressionLz4 : kCompressionStored;
+    entries[i].stored_size = uint32_t(files[i]->data.size());
+    entries[i].size = files[i]->size;
+    names += files[i]->name;
+  }
+  // Each bucket starts at the first entry hashing to it or a later bucket.
+  size_t entry_index = 0;
+  for (uint32_t bucket = 0; bucket <= header.bucket_count; ++bucket) {
+    while (entry_index < entries.size() &&
+           BucketIndex(entries[entry_index].name_hash, header.bucket_count) <
+               bucket) {
+      ++entry_index;
+    }
+    buckets[bucket] = uint32_t(entry_index);
+  }
+  buckets[header.bucket_count] = header.entry_count;
+
+  size_t offset = ArchiveFileSystem::EntriesOffset(header.bucket_count) +
+                  entries.size() * sizeof(Entry);
+  header.names_offset = uint32_t(offset);
+  header.names_length = uint32_t(names.size());
+  offset += names.size();
+  for (size_t i = 0; i < files.size(); ++i) {
+    if (!files[i]->is_compressed) {
+      offset = (offset + kDataAlignment - 1) & ~(kDataAlignment - 1);
+    }
+    entries[i].data_offset = offset;
+    offset += files[i]->data.size();
+  }
+
+  out->clear();
+  out->resize(offset);
+  uint8_t* dst = out->data();
+  std::memcpy(dst, &header, sizeof(Header));
+  dst += sizeof(Header);
+  std::memcpy(dst, buckets.data(), buckets.size() * sizeof(uint32_t));
+  if (!entries.empty()) {
+    std::memcpy(out->data() +
+                    ArchiveFileSystem::EntriesOffset(header.bucket_count),
+                entries.data(), entries.size() * sizeof(Entry));
+  }
+  std::memcpy(out->data() + header.names_offset, names.data(), names.size());
+  for (size_t i = 0; i < files.size(); ++i) {
+    if (!files[i]->data.empty()) {
+      std::memcpy(out->data() + entries[i].data_offset, files[i]->data.data(),
+                  files[i]->data.size());
+    }
+  }
+}
+
+bool ArchiveWriter::WriteToFile(const std::string& filename) const {
+  std::vector<uint8_t> data;
+  Write(&data);
+  FILE* file = fopen(filename.c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+  bool success = fwrite(data.data(), 1, data.size(), file) == data.size();
+  fclose(file);
+  return success;
+}
+
+}  // namespace io
+}  // namespace el
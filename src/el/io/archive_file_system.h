@@ -0,0 +1,103 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#ifndef EL_IO_ARCHIVE_FILE_SYSTEM_H_
+#define EL_IO_ARCHIVE_FILE_SYSTEM_H_
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "el/io/file_system.h"
+
+namespace el {
+namespace io {
+
+// Reads files from a single archive file packed with ArchiveWriter (f.ex by
+// the elemental-forms-packer tool), so a whole resource tree can be opened
+// with one file open instead of one per resource.
+//
+// Files are found through a hash index in constant time. Stored files are
+// read directly from the archive memory, and compressed files are decompressed
+// the first time they are read.
+// Files opened from the archive must be closed before the archive file system
+// is destroyed.
+class ArchiveFileSystem : public FileSystem {
+ public:
+  // Creates a file system reading from the given archive file.
+  // The archive is used in place if the file provides File::data() (f.ex if
+  // opened from a memory mapping PosixFileSystem), and otherwise read into
+  // memory.
+  // Returns nullptr if the file is not a valid archive.
+  static std::unique_ptr<ArchiveFileSystem> Create(
+      std::unique_ptr<File> archive_file);
+
+  // Gets the number of files in the archive.
+  size_t file_count() const;
+
+  std::unique_ptr<File> OpenRead(std::string filename) override;
+
+ private:
+  struct Header;
+  struct Entry;
+
+  ArchiveFileSystem() = default;
+  // Gets the offset of the entries in an archive with bucket_count buckets.
+  static size_t EntriesOffset(uint32_t bucket_count);
+  bool Init();
+  const Entry* FindEntry(const std::string& filename) const;
+
+  std::unique_ptr<File> archive_file_;
+  std::vector<uint8_t> buffer_;
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  const Header* header_ = nullptr;
+  const uint32_t* buckets_ = nullptr;
+  const Entry* entries_ = nullptr;
+  const char* names_ = nullptr;
+
+  friend class ArchiveWriter;
+};
+
+// Packs files into an archive read by ArchiveFileSystem.
+class ArchiveWriter {
+ public:
+  ArchiveWriter();
+  ~ArchiveWriter();
+
+  // Adds a file with the given name (using '/' as path separator).
+  // If compress is true, the file is stored LZ4 compressed unless that doesn't
+  // make it notably smaller (f.ex for images that are already compressed).
+  // Returns false if there already is a file with the name.
+  bool AddFile(std::string filename, const void* data, size_t length,
+               bool compress = true);
+
+  // Writes the archive with all added files to out.
+  void Write(std::vector<uint8_t>* out) const;
+
+  // Writes the archive to the given file. Returns false on fail.
+  bool WriteToFile(const std::string& filename) const;
+
+ private:
+  struct PendingFile {
+    std::string name;
+    uint32_t name_hash;
+    bool is_compressed;
+    uint32_t size;
+    std::vector<uint8_t> data;
+  };
+  std::vector<PendingFile> files_;
+  std::unordered_set<std::string> names_;
+};
+
+}  // namespace io
+}  // namespace el
+
+#endif  // EL_IO_ARCHIVE_FILE_SYSTEM_H_
@@ -44,5 +44,22 @@ std::unique_ptr<std::vector<uint8_t>> FileManager::ReadContents(
   return buffer;
 }
 
+std::unique_ptr<FileContents> FileManager::OpenContents(std::string filename) {
+  auto file = OpenRead(filename);
+  if (!file) {
+    return nullptr;
+  }
+  std::unique_ptr<FileContents> contents(new FileContents());
+  contents->size_ = file->size();
+  contents->data_ = file->data();
+  if (!contents->data_) {
+    contents->buffer_.resize(contents->size_);
+    contents->size_ = file->Read(contents->buffer_.data(), contents->size_);
+    contents->data_ = contents->buffer_.data();
+  }
+  contents->file_ = std::move(file);
+  return contents;
+}
+
 }  // namespace io
 }  // namespace el
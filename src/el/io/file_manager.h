@@ -20,6 +20,24 @@
 namespace el {
 namespace io {
 
+// The contents of a file, opened with FileManager::OpenContents.
+// Views the file contents directly if the file system provides File::data(),
+// and otherwise holds a copy read from the file.
+class FileContents {
+ public:
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+
+ private:
+  friend class FileManager;
+  FileContents() = default;
+
+  std::unique_ptr<File> file_;
+  std::vector<uint8_t> buffer_;
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+};
+
 // Manages runtime-specified file systems to provide file IO.
 //
 // Hosts should register file systems at startup immediately after calling
@@ -35,6 +53,11 @@ class FileManager {
   static std::unique_ptr<File> OpenRead(std::string filename);
   static std::unique_ptr<std::vector<uint8_t>> ReadContents(
       std::string filename);
+  // Opens the file and gets its whole contents, without copying them if the
+  // file system supports it (See File::data). Prefer this over ReadContents
+  // when the contents are only read.
+  // Returns nullptr if the file is not found.
+  static std::unique_ptr<FileContents> OpenContents(std::string filename);
 
   ~FileManager();
 
@@ -10,6 +10,7 @@
 #ifndef EL_IO_FILE_SYSTEM_H_
 #define EL_IO_FILE_SYSTEM_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -25,12 +26,20 @@ class File {
   virtual size_t size() const = 0;
   virtual size_t Read(void* buffer, size_t length) = 0;
 
+  // Gets the whole file contents (size() bytes) if the file system can provide
+  // them without copying, such as files mapped into memory or embedded in the
+  // executable. The pointer is valid as long as the file is open.
+  // Returns nullptr if the contents must be read with Read.
+  virtual const uint8_t* data() const { return nullptr; }
+
  protected:
   File() = default;
 };
 
 class FileSystem {
  public:
+  virtual ~FileSystem() = default;
+
   virtual std::unique_ptr<File> OpenRead(std::string filename) = 0;
 };
 
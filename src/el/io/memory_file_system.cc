@@ -33,6 +33,8 @@ class MemoryFile : public File {
     return to_read;
   }
 
+  const uint8_t* data() const override { return data_; }
+
  private:
   std::string filename_;
   const uint8_t* data_;
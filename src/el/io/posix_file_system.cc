@@ -7,8 +7,19 @@
  ******************************************************************************
  */
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
 #include "el/io/posix_file_system.h"
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // !_WIN32
+
 namespace el {
 namespace io {
 
@@ -33,10 +44,59 @@ class PosixFile : public File {
  private:
   FILE* file_handle_;
 };
+
+#ifndef _WIN32
+class MappedFile : public File {
+ public:
+  MappedFile(const uint8_t* data, size_t length)
+      : data_(data), length_(length) {}
+  ~MappedFile() override {
+    munmap(const_cast<uint8_t*>(data_), length_);
+  }
+
+  size_t size() const override { return length_; }
+
+  size_t Read(void* buffer, size_t length) override {
+    size_t to_read = std::min(length_ - position_, length);
+    std::memcpy(buffer, data_ + position_, to_read);
+    position_ += to_read;
+    return to_read;
+  }
+
+  const uint8_t* data() const override { return data_; }
+
+ private:
+  const uint8_t* data_;
+  size_t length_;
+  size_t position_ = 0;
+};
+
+// Maps the file at path into memory.
+// Returns nullptr if the file can't be mapped (f.ex if it's empty), in which
+// case it should be opened with stdio instead.
+std::unique_ptr<File> OpenMapped(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return nullptr;
+  }
+  struct stat st;
+  void* data = MAP_FAILED;
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+    data = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+  if (data == MAP_FAILED) {
+    return nullptr;
+  }
+  return std::make_unique<MappedFile>(reinterpret_cast<const uint8_t*>(data),
+                                      size_t(st.st_size));
+}
+#endif  // !_WIN32
 }  // namespace
 
-PosixFileSystem::PosixFileSystem(std::string root_path)
-    : root_path_(std::move(root_path)) {
+PosixFileSystem::PosixFileSystem(std::string root_path, bool memory_map)
+    : root_path_(std::move(root_path)), memory_map_(memory_map) {
   auto last_char = root_path_[root_path_.size() - 1];
   if (last_char != '/' && last_char != '\\') {
     root_path_ += '/';
@@ -45,6 +105,14 @@ PosixFileSystem::PosixFileSystem(std::string root_path)
 
 std::unique_ptr<File> PosixFileSystem::OpenRead(std::string filename) {
   auto full_path = root_path_ + filename;
+#ifndef _WIN32
+  if (memory_map_) {
+    auto file = OpenMapped(full_path);
+    if (file) {
+      return file;
+    }
+  }
+#endif  // !_WIN32
   FILE* file_handle = fopen(full_path.c_str(), "rb");
   if (!file_handle) {
     return nullptr;
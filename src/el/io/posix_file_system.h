@@ -18,14 +18,20 @@
 namespace el {
 namespace io {
 
+// Reads files from a directory.
+// If memory mapping is enabled, files are mapped into memory so their contents
+// can be used directly through File::data() without being copied. Memory
+// mapping is only available on POSIX platforms, elsewhere files are always
+// read with stdio.
 class PosixFileSystem : public FileSystem {
  public:
-  explicit PosixFileSystem(std::string root_path);
+  explicit PosixFileSystem(std::string root_path, bool memory_map = false);
 
   std::unique_ptr<File> OpenRead(std::string filename) override;
 
  private:
   std::string root_path_;
+  bool memory_map_;
 };
 
 }  // namespace io
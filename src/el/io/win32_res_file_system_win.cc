@@ -42,6 +42,8 @@ class Win32ResFile : public File {
     return to_read;
   }
 
+  const uint8_t* data() const override { return data_; }
+
  private:
   std::string filename_;
   const uint8_t* data_;
@@ -10,8 +10,10 @@
 #include <cstddef>
 
 #include "el/message_handler.h"
+#include "el/util/counters.h"
 #include "el/util/metrics.h"
 #include "el/util/timer.h"
+#include "el/util/trace.h"
 
 namespace el {
 
@@ -123,6 +125,7 @@ void MessageHandler::DeleteAllMessages() {
 
 // static
 void MessageHandler::ProcessMessages() {
+  EL_TRACE_ZONE("MessageHandler::ProcessMessages");
   // Handle delayed messages.
   auto iter = g_all_delayed_messages.IterateForward();
   while (Message* msg = static_cast<Message*>(iter.GetAndStep())) {
@@ -132,6 +135,7 @@ void MessageHandler::ProcessMessages() {
       // Remove from local list.
       msg->message_handler()->m_messages.Remove(msg);
 
+      util::Counters::Add(util::Counter::kMessagesDispatched);
       msg->message_handler()->OnMessageReceived(msg);
 
       delete msg;
@@ -149,6 +153,7 @@ void MessageHandler::ProcessMessages() {
     // Remove from local list.
     msg->message_handler()->m_messages.Remove(msg);
 
+    util::Counters::Add(util::Counter::kMessagesDispatched);
     msg->message_handler()->OnMessageReceived(msg);
 
     delete msg;
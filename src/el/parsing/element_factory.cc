@@ -7,9 +7,12 @@
  ******************************************************************************
  */
 
+#include <cstring>
+
 #include "el/element.h"
 #include "el/parsing/element_factory.h"
 #include "el/parsing/element_inflater.h"
+#include "el/parsing/element_template.h"
 #include "el/parsing/parse_node.h"
 
 namespace el {
@@ -22,9 +25,22 @@ ElementFactory::~ElementFactory() = default;
 
 void ElementFactory::RegisterInflater(
     std::unique_ptr<ElementInflater> inflater) {
+  // The first inflater registered for a name is used.
+  inflater_lookup_.emplace(TBID(inflater->name()), inflater.get());
   inflaters_.emplace_back(std::move(inflater));
 }
 
+ElementInflater* ElementFactory::GetInflater(const char* name) const {
+  auto it = inflater_lookup_.find(TBID(name));
+  if (it == inflater_lookup_.end()) {
+    return nullptr;
+  }
+  // Names of property nodes are looked up too, so make sure a hash collision
+  // doesn't turn a property into an element.
+  ElementInflater* inflater = it->second;
+  return std::strcmp(inflater->name(), name) == 0 ? inflater : nullptr;
+}
+
 bool ElementFactory::LoadFile(Element* target, const char* filename) {
   ParseNode node;
   if (!node.ReadFile(filename)) {
@@ -52,23 +68,40 @@ void ElementFactory::LoadNodeTree(Element* target, ParseNode* node) {
 
 bool ElementFactory::CreateElement(Element* target, ParseNode* node) {
   // Find a element creator from the node name.
-  ElementInflater* source_factory = nullptr;
-  for (auto& inflater : inflaters_) {
-    if (std::strcmp(inflater->name(), node->name()) == 0) {
-      source_factory = inflater.get();
-      break;
-    }
+  ElementInflater* inflater = GetInflater(node->name());
+  if (!inflater) {
+    return false;
   }
-  if (!source_factory) {
+
+  InflateProperties properties;
+  properties.Parse(node, inflater->sync_type());
+  Element* new_element = InflateElement(target, inflater, node, &properties);
+  if (!new_element) {
     return false;
   }
 
+  // Iterate through all nodes and create elements.
+  for (ParseNode* n = node->first_child(); n; n = n->GetNext()) {
+    CreateElement(new_element, n);
+  }
+
+  if (properties.autofocus) {
+    new_element->set_focus(FocusReason::kUnknown);
+  }
+
+  return true;
+}
+
+Element* ElementFactory::InflateElement(Element* target,
+                                        ElementInflater* inflater,
+                                        ParseNode* node,
+                                        const InflateProperties* properties) {
   // Create the element.
-  InflateInfo info(this, target->content_root(), node,
-                   source_factory->sync_type());
-  Element* new_element = source_factory->Create(&info);
+  InflateInfo info(this, target->content_root(), node, inflater->sync_type(),
+                   properties);
+  Element* new_element = inflater->Create(&info);
   if (!new_element) {
-    return false;
+    return nullptr;
   }
 
   // Read properties and add i to the hierarchy.
@@ -78,16 +111,58 @@ bool ElementFactory::CreateElement(Element* target, ParseNode* node) {
   // from an overridden version.
   assert(new_element->parent());
 
-  // Iterate through all nodes and create elements.
-  for (ParseNode* n = node->first_child(); n; n = n->GetNext()) {
-    CreateElement(new_element, n);
+  return new_element;
+}
+
+std::unique_ptr<ElementTemplate> ElementFactory::CompileTemplate(
+    ParseNode* node) {
+  auto element_template = std::make_unique<ElementTemplate>();
+  element_template->m_root.CloneChildren(node);
+  CompileTemplateEntries(element_template.get(), &element_template->m_root);
+  return element_template;
+}
+
+void ElementFactory::CompileTemplateEntries(ElementTemplate* element_template,
+                                            ParseNode* node) {
+  auto& entries = element_template->m_entries;
+  for (ParseNode* child = node->first_child(); child;
+       child = child->GetNext()) {
+    ElementInflater* inflater = GetInflater(child->name());
+    if (!inflater) {
+      continue;
+    }
+    size_t index = entries.size();
+    entries.push_back({inflater, child, InflateProperties(), 0});
+    entries.back().properties.Parse(child, inflater->sync_type());
+    CompileTemplateEntries(element_template, child);
+    entries[index].descendant_count = entries.size() - index - 1;
   }
+}
 
-  if (node->GetValueInt("autofocus", 0)) {
-    new_element->set_focus(FocusReason::kUnknown);
+void ElementFactory::LoadTemplate(Element* target,
+                                  const ElementTemplate* element_template) {
+  size_t index = 0;
+  while (index < element_template->m_entries.size()) {
+    index = LoadTemplateEntry(target, element_template, index);
   }
+}
 
-  return true;
+size_t ElementFactory::LoadTemplateEntry(
+    Element* target, const ElementTemplate* element_template, size_t index) {
+  auto& entry = element_template->m_entries[index];
+  size_t end_index = index + 1 + entry.descendant_count;
+  Element* new_element =
+      InflateElement(target, entry.inflater, entry.node, &entry.properties);
+  if (!new_element) {
+    return end_index;
+  }
+  for (size_t i = index + 1; i < end_index;) {
+    i = LoadTemplateEntry(new_element, element_template, i);
+  }
+  if (entry.properties.autofocus) {
+    new_element->set_focus(FocusReason::kUnknown);
+  }
+  return end_index;
 }
 
 }  // namespace parsing
@@ -15,6 +15,7 @@
 #include <vector>
 
 #include "el/parsing/parse_node.h"
+#include "el/util/id_map.h"
 #include "el/value.h"
 
 namespace el {
@@ -25,6 +26,8 @@ namespace el {
 namespace parsing {
 
 class ElementInflater;
+class ElementTemplate;
+struct InflateProperties;
 
 // Parses a resource file (or buffer) into a ParseNode tree and turn it into a
 // hierarchy of elements.
@@ -84,6 +87,12 @@ class ElementInflater;
 //                  first time its Form is activated.
 // font>name        Font name
 // font>size        Font size
+//
+// When the same resource is inflated many times, compile it into an
+// ElementTemplate with CompileTemplate and inflate it with LoadTemplate. That
+// only looks up inflaters and parses the generic properties once.
+// Inflated elements are allocated through the ElementPool, so inflating a
+// resource again after deleting its elements reuses their memory.
 class ElementFactory {
  public:
   static ElementFactory* get() { return element_reader_singleton_.get(); }
@@ -96,16 +105,41 @@ class ElementFactory {
 
   void RegisterInflater(std::unique_ptr<ElementInflater> inflater);
 
+  // Gets the inflater registered for the given element class name, or nullptr
+  // if there is none.
+  ElementInflater* GetInflater(const char* name) const;
+
   bool LoadFile(Element* target, const char* filename);
   bool LoadData(Element* target, const char* data,
                 size_t data_length = std::string::npos);
   void LoadNodeTree(Element* target, ParseNode* node);
 
+  // Compiles the elements in the children of node into a template that can be
+  // inflated many times with LoadTemplate. The template keeps a copy of the
+  // nodes, so node may be deleted afterwards.
+  // NOTE: References in the generic properties are resolved, and dimensions
+  // converted to px, at compile time.
+  std::unique_ptr<ElementTemplate> CompileTemplate(ParseNode* node);
+
+  // Inflates the elements of the template into target, like LoadNodeTree would
+  // do with the node the template was compiled from.
+  void LoadTemplate(Element* target, const ElementTemplate* element_template);
+
  private:
   bool CreateElement(Element* target, ParseNode* node);
+  Element* InflateElement(Element* target, ElementInflater* inflater,
+                          ParseNode* node,
+                          const InflateProperties* properties);
+  void CompileTemplateEntries(ElementTemplate* element_template,
+                              ParseNode* node);
+  size_t LoadTemplateEntry(Element* target,
+                           const ElementTemplate* element_template,
+                           size_t index);
 
   static std::unique_ptr<ElementFactory> element_reader_singleton_;
   std::vector<std::unique_ptr<ElementInflater>> inflaters_;
+  // Inflaters by the TBID of their name.
+  util::IdMap<ElementInflater*> inflater_lookup_;
 };
 
 }  // namespace parsing
@@ -26,12 +26,18 @@ namespace parsing {
 
 class ElementInflater;
 class ElementFactory;
+struct InflateProperties;
 
 // Contains info passed to Element::OnInflate during resource loading.
 struct InflateInfo {
   InflateInfo(ElementFactory* reader, Element* target, ParseNode* node,
-              Value::Type sync_type)
-      : reader(reader), target(target), node(node), sync_type(sync_type) {}
+              Value::Type sync_type,
+              const InflateProperties* properties = nullptr)
+      : reader(reader),
+        target(target),
+        node(node),
+        sync_type(sync_type),
+        properties(properties) {}
 
   ElementFactory* reader;
   // The element that that will be parent to the inflated element.
@@ -40,6 +46,9 @@ struct InflateInfo {
   ParseNode* node;
   // The data type that should be synchronized through ElementValue.
   Value::Type sync_type;
+  // The generic properties already parsed from node, or nullptr if they
+  // should be parsed by Element::OnInflate.
+  const InflateProperties* properties;
 };
 
 // Creates a element from a ParseNode.
@@ -0,0 +1,137 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <cstring>
+
+#include "el/parsing/element_template.h"
+#include "el/skin.h"
+#include "el/util/dimension_converter.h"
+
+namespace el {
+namespace parsing {
+
+namespace {
+
+int GetPxValue(ParseNode* node, const char* request) {
+  const char* str = node->GetValueString(request, nullptr);
+  if (!str) {
+    return InflateProperties::kNotSpecified;
+  }
+  return Skin::get()->dimension_converter()->GetPxFromString(
+      str, LayoutParams::kUnspecified);
+}
+
+}  // namespace
+
+void InflateProperties::Parse(ParseNode* node, Value::Type sync_type) {
+  if (auto id_node = node->GetNode("id")) {
+    has_id = true;
+    Element::SetIdFromNode(&id, id_node);
+  }
+  if (auto group_id_node = node->GetNode("group-id")) {
+    has_group_id = true;
+    Element::SetIdFromNode(&group_id, group_id_node);
+  }
+
+  if (sync_type == Value::Type::kFloat) {
+    float_value = node->GetValueFloat("value", 0);
+  } else {
+    int_value = node->GetValueInt("value", 0);
+  }
+
+  if (auto data_node = node->GetNode("data")) {
+    has_data = true;
+    data.Copy(data_node->value());
+  }
+
+  is_group_root = node->GetValueInt("is-group-root", kNotSpecified);
+  is_focusable = node->GetValueInt("is-focusable", kNotSpecified);
+  want_long_click = node->GetValueInt("want-long-click", kNotSpecified);
+  ignore_input = node->GetValueInt("ignore-input", kNotSpecified);
+  opacity = node->GetValueFloat("opacity", -1);
+
+  if (const char* str = node->GetValueString("text", nullptr)) {
+    has_text = true;
+    text = str;
+  }
+  if (const char* str = node->GetValueStringRaw("connection", nullptr)) {
+    has_connection = true;
+    connection = str;
+  }
+  if (const char* str = node->GetValueString("axis", nullptr)) {
+    has_axis = true;
+    axis = el::from_string(str, Axis::kY);
+  }
+  if (const char* str = node->GetValueString("gravity", nullptr)) {
+    Gravity g = Gravity::kNone;
+    if (strstr(str, "left")) g |= Gravity::kLeft;
+    if (strstr(str, "top")) g |= Gravity::kTop;
+    if (strstr(str, "right")) g |= Gravity::kRight;
+    if (strstr(str, "bottom")) g |= Gravity::kBottom;
+    if (strstr(str, "all")) g |= Gravity::kAll;
+    if (!any(g & Gravity::kLeftRight)) g |= Gravity::kLeft;
+    if (!any(g & Gravity::kTopBottom)) g |= Gravity::kTop;
+    has_gravity = true;
+    gravity = g;
+  }
+  if (const char* str = node->GetValueString("visibility", nullptr)) {
+    // Unknown strings leave the visibility unchanged. The string is known if
+    // the result doesn't depend on the default value.
+    visibility = from_string(str, Visibility::kVisible);
+    has_visibility = visibility == from_string(str, Visibility::kGone);
+  }
+  if (const char* str = node->GetValueString("state", nullptr)) {
+    is_disabled = strstr(str, "disabled") != nullptr;
+  }
+  if (const char* str = node->GetValueString("skin", nullptr)) {
+    has_skin = true;
+    skin = str;
+  }
+  if (auto lp = node->GetNode("lp")) {
+    has_layout_params = true;
+    lp_width = GetPxValue(lp, "width");
+    lp_height = GetPxValue(lp, "height");
+    lp_min_width = GetPxValue(lp, "min-width");
+    lp_max_width = GetPxValue(lp, "max-width");
+    lp_pref_width = GetPxValue(lp, "pref-width");
+    lp_min_height = GetPxValue(lp, "min-height");
+    lp_max_height = GetPxValue(lp, "max-height");
+    lp_pref_height = GetPxValue(lp, "pref-height");
+  }
+  if (const char* str = node->GetValueString("tooltip", nullptr)) {
+    has_tooltip = true;
+    tooltip = str;
+  }
+  if (auto font = node->GetNode("font")) {
+    has_font = true;
+    if (const char* size = font->GetValueString("size", nullptr)) {
+      font_size = Skin::get()->dimension_converter()->GetPxFromString(
+          size, kNotSpecified);
+    }
+    if (const char* name = font->GetValueString("name", nullptr)) {
+      has_font_name = true;
+      font_name = name;
+    }
+  }
+  if (auto rect_node = node->GetNode("rect")) {
+    auto dc = Skin::get()->dimension_converter();
+    Value& val = rect_node->value();
+    if (val.array_size() == 4) {
+      has_rect = true;
+      rect.reset(dc->GetPxFromValue(val.as_array()->at(0), 0),
+                 dc->GetPxFromValue(val.as_array()->at(1), 0),
+                 dc->GetPxFromValue(val.as_array()->at(2), 0),
+                 dc->GetPxFromValue(val.as_array()->at(3), 0));
+    }
+  }
+  autofocus = node->GetValueInt("autofocus", 0) != 0;
+}
+
+}  // namespace parsing
+}  // namespace el
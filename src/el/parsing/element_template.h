@@ -0,0 +1,120 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#ifndef EL_PARSING_ELEMENT_TEMPLATE_H_
+#define EL_PARSING_ELEMENT_TEMPLATE_H_
+
+#include <climits>
+#include <string>
+#include <vector>
+
+#include "el/element.h"
+#include "el/id.h"
+#include "el/parsing/parse_node.h"
+#include "el/rect.h"
+#include "el/value.h"
+
+namespace el {
+namespace parsing {
+
+class ElementInflater;
+
+// The generic element properties (See ElementFactory) read from a ParseNode.
+// Element::OnInflate applies these instead of looking each of them up in the
+// node, so they can be parsed once by an ElementTemplate and applied to many
+// elements.
+// References to ParseNodeTree nodes and language strings, and dimensions, are
+// resolved when parsing.
+struct InflateProperties {
+  // The value of integer properties that wasn't specified.
+  static const int kNotSpecified = INT_MIN;
+
+  // Reads the properties from the given node. The sync_type decides if the
+  // value is read as integer or float.
+  void Parse(ParseNode* node, Value::Type sync_type);
+
+  bool has_id = false;
+  TBID id;
+  bool has_group_id = false;
+  TBID group_id;
+  int int_value = 0;
+  float float_value = 0;
+  bool has_data = false;
+  Value data;
+  int is_group_root = kNotSpecified;
+  int is_focusable = kNotSpecified;
+  int want_long_click = kNotSpecified;
+  int ignore_input = kNotSpecified;
+  float opacity = -1;  // Negative if not specified.
+  bool has_text = false;
+  std::string text;
+  bool has_connection = false;
+  std::string connection;
+  bool has_axis = false;
+  Axis axis = Axis::kY;
+  bool has_gravity = false;
+  Gravity gravity = Gravity::kNone;
+  bool has_visibility = false;
+  Visibility visibility = Visibility::kVisible;
+  bool is_disabled = false;
+  bool has_skin = false;
+  TBID skin;
+  bool has_tooltip = false;
+  std::string tooltip;
+  // The "lp" node. Dimensions are in px, or kNotSpecified.
+  bool has_layout_params = false;
+  int lp_width = kNotSpecified;
+  int lp_height = kNotSpecified;
+  int lp_min_width = kNotSpecified;
+  int lp_max_width = kNotSpecified;
+  int lp_pref_width = kNotSpecified;
+  int lp_min_height = kNotSpecified;
+  int lp_max_height = kNotSpecified;
+  int lp_pref_height = kNotSpecified;
+  // The "font" node. The size is in px, or kNotSpecified.
+  bool has_font = false;
+  int font_size = kNotSpecified;
+  bool has_font_name = false;
+  TBID font_name;
+  bool has_rect = false;
+  Rect rect;
+  bool autofocus = false;
+};
+
+// A ParseNode tree compiled for inflating the same elements many times (See
+// ElementFactory::CompileTemplate and ElementFactory::LoadTemplate).
+// The inflater for each element is resolved and its generic properties are
+// parsed once when compiling, so inflating only creates the elements and
+// applies the properties. Properties specific to an element type are still
+// read from a copy of the nodes owned by the template.
+class ElementTemplate {
+ public:
+  // Gets the number of elements created by each inflation of the template.
+  size_t element_count() const { return m_entries.size(); }
+
+ private:
+  friend class ElementFactory;
+
+  // An element to inflate. Entries are stored in tree order, with the
+  // descendants of each entry directly following it.
+  struct Entry {
+    ElementInflater* inflater;
+    ParseNode* node;
+    InflateProperties properties;
+    size_t descendant_count;
+  };
+
+  ParseNode m_root;
+  std::vector<Entry> m_entries;
+};
+
+}  // namespace parsing
+}  // namespace el
+
+#endif  // EL_PARSING_ELEMENT_TEMPLATE_H_
@@ -9,10 +9,14 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
+#include "el/io/file_manager.h"
 #include "el/parsing/parse_node.h"
 #include "el/parsing/parse_node_tree.h"
 #include "el/parsing/text_parser.h"
@@ -35,7 +39,14 @@ ParseNode* ParseNode::Create(const char* name) {
 }
 
 // static
-ParseNode* ParseNode::Create(const char* name, size_t name_len) {
+ParseNode* ParseNode::Create(const char* name, size_t name_len,
+                             util::Arena* arena) {
+  if (arena) {
+    ParseNode* n = arena->New<ParseNode>();
+    n->m_name = arena->CopyString(name, name_len);
+    n->m_is_arena_allocated = true;
+    return n;
+  }
   ParseNode* n = new ParseNode();
   n->m_name = reinterpret_cast<char*>(malloc(name_len + 1));
   std::memcpy(n->m_name, name, name_len);
@@ -43,6 +54,16 @@ ParseNode* ParseNode::Create(const char* name, size_t name_len) {
   return n;
 }
 
+// static
+void ParseNode::Destroy(ParseNode* node) {
+  if (node->m_is_arena_allocated) {
+    // The memory is freed with the arena.
+    node->~ParseNode();
+  } else {
+    delete node;
+  }
+}
+
 // static
 const char* ParseNode::GetNextNodeSeparator(const char* request) {
   while (*request != 0 && *request != '>') {
@@ -93,12 +114,22 @@ void ParseNode::Clone(ParseNode* source) {
 }
 
 void ParseNode::CloneChildren(ParseNode* source) {
+  CloneChildren(source, nullptr);
+}
+
+void ParseNode::CloneChildren(ParseNode* source, util::Arena* arena) {
   ParseNode* item = source->first_child();
   while (item) {
-    ParseNode* new_child = Create(item->m_name);
-    new_child->m_value.Copy(item->m_value);
+    ParseNode* new_child = Create(item->m_name, strlen(item->m_name), arena);
+    if (arena && item->m_value.is_string()) {
+      const char* str = item->m_value.as_string();
+      new_child->m_value.set_string(arena->CopyString(str, strlen(str)),
+                                    Value::Set::kAsStatic);
+    } else {
+      new_child->m_value.Copy(item->m_value);
+    }
     Add(new_child);
-    new_child->CloneChildren(item);
+    new_child->CloneChildren(item, arena);
     item = item->GetNext();
   }
 }
@@ -144,8 +175,12 @@ const char* ParseNode::GetValueStringRaw(const char* request, const char* def) {
 
 class ParseNodeTarget : public TextParserTarget {
  public:
-  ParseNodeTarget(ParseNode* root, const std::string& filename)
-      : m_root_node(root), m_target_node(root), m_filename(filename) {}
+  ParseNodeTarget(ParseNode* root, const std::string& filename,
+                  util::Arena* arena)
+      : m_root_node(root),
+        m_target_node(root),
+        m_filename(filename),
+        m_arena(arena) {}
   void OnError(int line_nr, const std::string& error) override {
     TBDebugOut("%s(%d):Parse error: %s\n", m_filename.c_str(), line_nr,
                error.c_str());
@@ -158,8 +193,15 @@ class ParseNodeTarget : public TextParserTarget {
     } else if (strcmp(name, "@include") == 0) {
       IncludeRef(line_nr, value->as_string());
     } else {
-      ParseNode* n = ParseNode::Create(name);
-      n->TakeValue(value);
+      ParseNode* n = ParseNode::Create(name, strlen(name), m_arena);
+      if (m_arena && value->is_string()) {
+        // Keep the string in the arena too. The parser still owns value.
+        const char* str = value->as_string();
+        n->m_value.set_string(m_arena->CopyString(str, strlen(str)),
+                              Value::Set::kAsStatic);
+      } else {
+        n->TakeValue(value);
+      }
       m_target_node->Add(n);
     }
   }
@@ -182,7 +224,7 @@ class ParseNodeTarget : public TextParserTarget {
     include_filename.AppendPath(m_filename);
     include_filename.AppendString(filename);
     ParseNode content;
-    if (content.ReadFile(include_filename.c_str())) {
+    if (content.ReadFile(include_filename.c_str(), m_arena)) {
       while (ParseNode* content_n = content.first_child()) {
         content.Remove(content_n);
         m_target_node->Add(content_n);
@@ -216,7 +258,7 @@ class ParseNodeTarget : public TextParserTarget {
       }
     }
     if (refnode) {
-      m_target_node->CloneChildren(refnode);
+      m_target_node->CloneChildren(refnode, m_arena);
     } else {
       OnError(line_nr,
               el::util::format_string("Include \"%s\" was not found!", refstr));
@@ -227,19 +269,42 @@ class ParseNodeTarget : public TextParserTarget {
   ParseNode* m_root_node;
   ParseNode* m_target_node;
   std::string m_filename;
+  util::Arena* m_arena;
 };
 
 void ParseNode::TakeValue(Value* value) { m_value.TakeOver(value); }
 
 void ParseNode::EmplaceValue(Value value) { m_value.TakeOver(&value); }
 
-bool ParseNode::ReadFile(const std::string& filename, ReadFlags flags) {
+util::Arena* ParseNode::PrepareRead(ReadFlags flags) {
   if (!any(flags & ReadFlags::kAppend)) {
     Clear();
   }
-  FileTextParserStream p;
-  ParseNodeTarget t(this, filename);
-  if (p.Read(filename, &t)) {
+  if (!any(flags & ReadFlags::kArena)) {
+    return nullptr;
+  }
+  if (!m_arena) {
+    m_arena = std::make_unique<util::Arena>();
+  }
+  return m_arena.get();
+}
+
+bool ParseNode::ReadFile(const std::string& filename, ReadFlags flags) {
+  return ReadFile(filename, PrepareRead(flags));
+}
+
+bool ParseNode::ReadFile(const std::string& filename, util::Arena* arena) {
+  auto contents = io::FileManager::OpenContents(filename);
+  if (!contents) {
+    return false;
+  }
+  if (IsBinary(contents->data(), contents->size())) {
+    return ReadBinary(contents->data(), contents->size(), arena);
+  }
+  DataTextParserStream p;
+  ParseNodeTarget t(this, filename, arena);
+  if (p.Read(reinterpret_cast<const char*>(contents->data()), contents->size(),
+             &t)) {
     ParseNodeTree::ResolveConditions(this);
     return true;
   }
@@ -252,19 +317,337 @@ void ParseNode::ReadData(const char* data, ReadFlags flags) {
 
 void ParseNode::ReadData(const char* data, size_t data_length,
                          ReadFlags flags) {
-  if (!any(flags & ReadFlags::kAppend)) {
-    Clear();
+  util::Arena* arena = PrepareRead(flags);
+  if (IsBinary(data, data_length)) {
+    ReadBinary(data, data_length, arena);
+    return;
   }
   DataTextParserStream p;
-  ParseNodeTarget t(this, "{data}");
+  ParseNodeTarget t(this, "{data}", arena);
   p.Read(data, data_length, &t);
   ParseNodeTree::ResolveConditions(this);
 }
 
+// Binary format (native byte order, all fields 32 bit):
+//   BinaryHeader
+//   BinaryNode nodes[node_count]     Depth first order.
+//   uint32_t string_offsets[string_count]
+//   char strings[]                   Null terminated, at the offsets.
+//   uint32_t arrays[array_words]     Array values.
+// The children of a node are the nodes following it, up to its subtree_end.
+// A value is a type (Value::Type) and a value word, which is the integer, the
+// float bits, a string index or the index of an array in arrays. An array is
+// stored as its size followed by a type and value word per item.
+// Data written on a machine with the other byte order is rejected, since the
+// magic doesn't match.
+namespace {
+
+const uint32_t kBinaryMagic = 0x4E504C45;  // 'ELPN'
+const uint32_t kBinaryVersion = 1;
+// Nodes are read recursively, so limit the nesting to stay within the stack.
+const int kMaxBinaryNodeDepth = 256;
+
+struct BinaryHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t node_count;
+  uint32_t string_count;
+  uint32_t strings_length;
+  uint32_t array_words;
+};
+
+struct BinaryNode {
+  uint32_t name;
+  uint32_t value_type;
+  uint32_t value;
+  uint32_t subtree_end;
+};
+
+}  // namespace
+
+class ParseNodeBinaryWriter {
+ public:
+  void Write(ParseNode* root, std::vector<uint8_t>* out) {
+    for (ParseNode* n = root->first_child(); n; n = n->GetNext()) {
+      AddNode(n);
+    }
+    BinaryHeader header;
+    header.magic = kBinaryMagic;
+    header.version = kBinaryVersion;
+    header.node_count = uint32_t(nodes_.size());
+    header.string_count = uint32_t(string_offsets_.size());
+    header.strings_length = uint32_t(strings_.size());
+    header.array_words = uint32_t(arrays_.size());
+    // Pad the strings so the arrays are aligned.
+    strings_.resize((strings_.size() + 3) & ~size_t(3));
+    out->clear();
+    Append(out, &header, sizeof(header));
+    Append(out, nodes_.data(), nodes_.size() * sizeof(BinaryNode));
+    Append(out, string_offsets_.data(),
+           string_offsets_.size() * sizeof(uint32_t));
+    Append(out, strings_.data(), strings_.size());
+    Append(out, arrays_.data(), arrays_.size() * sizeof(uint32_t));
+  }
+
+ private:
+  static void Append(std::vector<uint8_t>* out, const void* data,
+                     size_t size) {
+    auto bytes = reinterpret_cast<const uint8_t*>(data);
+    out->insert(out->end(), bytes, bytes + size);
+  }
+
+  void AddNode(ParseNode* node) {
+    size_t index = nodes_.size();
+    nodes_.emplace_back();
+    BinaryNode binary_node;
+    binary_node.name = AddString(node->name() ? node->name() : "");
+    EncodeValue(node->value(), &binary_node.value_type, &binary_node.value);
+    for (ParseNode* n = node->first_child(); n; n = n->GetNext()) {
+      AddNode(n);
+    }
+    binary_node.subtree_end = uint32_t(nodes_.size());
+    nodes_[index] = binary_node;
+  }
+
+  uint32_t AddString(const char* str) {
+    auto it = string_indices_.find(str);
+    if (it != string_indices_.end()) {
+      return it->second;
+    }
+    uint32_t index = uint32_t(string_offsets_.size());
+    string_offsets_.push_back(uint32_t(strings_.size()));
+    strings_.insert(strings_.end(), str, str + strlen(str) + 1);
+    string_indices_.emplace(str, index);
+    return index;
+  }
+
+  void EncodeValue(Value& value, uint32_t* out_type, uint32_t* out_value) {
+    *out_type = uint32_t(value.type());
+    *out_value = 0;
+    switch (value.type()) {
+      case Value::Type::kString:
+        *out_value = AddString(value.as_string());
+        break;
+      case Value::Type::kFloat: {
+        float f = value.as_float();
+        std::memcpy(out_value, &f, sizeof(f));
+        break;
+      }
+      case Value::Type::kInt:
+        *out_value = uint32_t(value.as_integer());
+        break;
+      case Value::Type::kArray: {
+        ValueArray* array = value.as_array();
+        size_t offset = arrays_.size();
+        arrays_.resize(offset + 1 + array->size() * 2);
+        arrays_[offset] = uint32_t(array->size());
+        for (size_t i = 0; i < array->size(); ++i) {
+          // Encode into locals since nested arrays may grow arrays_.
+          uint32_t item_type, item_value;
+          EncodeValue(*array->at(i), &item_type, &item_value);
+          arrays_[offset + 1 + i * 2] = item_type;
+          arrays_[offset + 2 + i * 2] = item_value;
+        }
+        *out_value = uint32_t(offset);
+        break;
+      }
+      default:
+        *out_type = uint32_t(Value::Type::kNull);
+        break;
+    }
+  }
+
+  std::vector<BinaryNode> nodes_;
+  std::vector<uint32_t> string_offsets_;
+  std::vector<char> strings_;
+  std::unordered_map<std::string, uint32_t> string_indices_;
+  std::vector<uint32_t> arrays_;
+};
+
+class ParseNodeBinaryReader {
+ public:
+  ParseNodeBinaryReader(const uint8_t* data, size_t data_length,
+                        util::Arena* arena)
+      : data_(data), data_length_(data_length), arena_(arena) {}
+
+  bool Read(ParseNode* root) {
+    if (data_length_ < sizeof(BinaryHeader)) {
+      return false;
+    }
+    std::memcpy(&header_, data_, sizeof(header_));
+    if (header_.magic != kBinaryMagic || header_.version != kBinaryVersion) {
+      return false;
+    }
+    uint64_t nodes_offset = sizeof(BinaryHeader);
+    uint64_t string_offsets_offset =
+        nodes_offset + uint64_t(header_.node_count) * sizeof(BinaryNode);
+    uint64_t strings_offset = string_offsets_offset +
+                              uint64_t(header_.string_count) * sizeof(uint32_t);
+    uint64_t arrays_offset =
+        strings_offset + ((uint64_t(header_.strings_length) + 3) & ~3ull);
+    uint64_t end_offset =
+        arrays_offset + uint64_t(header_.array_words) * sizeof(uint32_t);
+    if (end_offset > data_length_) {
+      return false;
+    }
+    nodes_ = reinterpret_cast<const BinaryNode*>(data_ + nodes_offset);
+    string_offsets_ =
+        reinterpret_cast<const uint32_t*>(data_ + string_offsets_offset);
+    strings_ = reinterpret_cast<const char*>(data_ + strings_offset);
+    arrays_ = reinterpret_cast<const uint32_t*>(data_ + arrays_offset);
+    if (header_.strings_length && strings_[header_.strings_length - 1]) {
+      return false;
+    }
+    for (uint32_t i = 0; i < header_.string_count; ++i) {
+      if (string_offsets_[i] >= header_.strings_length) {
+        return false;
+      }
+    }
+    if (!ReadNodes(root, 0, header_.node_count, 0)) {
+      return false;
+    }
+    ParseNodeTree::ResolveConditions(root);
+    return true;
+  }
+
+ private:
+  bool ReadNodes(ParseNode* parent, uint32_t begin, uint32_t end, int depth) {
+    if (depth > kMaxBinaryNodeDepth) {
+      return false;
+    }
+    uint32_t index = begin;
+    while (index < end) {
+      const BinaryNode& binary_node = nodes_[index];
+      if (binary_node.name >= header_.string_count ||
+          binary_node.subtree_end <= index || binary_node.subtree_end > end) {
+        return false;
+      }
+      const char* name = GetString(binary_node.name);
+      ParseNode* node = ParseNode::Create(name, strlen(name), arena_);
+      parent->Add(node);
+      if (!DecodeValue(binary_node.value_type, binary_node.value,
+                       &node->value(), 0) ||
+          !ReadNodes(node, index + 1, binary_node.subtree_end, depth + 1)) {
+        return false;
+      }
+      index = binary_node.subtree_end;
+    }
+    return true;
+  }
+
+  const char* GetString(uint32_t index) const {
+    return strings_ + string_offsets_[index];
+  }
+
+  bool DecodeValue(uint32_t type, uint32_t value, Value* out_value,
+                   int depth) {
+    switch (Value::Type(type)) {
+      case Value::Type::kNull:
+        break;
+      case Value::Type::kString: {
+        if (value >= header_.string_count) {
+          return false;
+        }
+        const char* str = GetString(value);
+        if (arena_) {
+          out_value->set_string(arena_->CopyString(str, strlen(str)),
+                                Value::Set::kAsStatic);
+        } else {
+          out_value->set_string(str, Value::Set::kNewCopy);
+        }
+        break;
+      }
+      case Value::Type::kFloat: {
+        float f;
+        std::memcpy(&f, &value, sizeof(f));
+        out_value->set_float(f);
+        break;
+      }
+      case Value::Type::kInt:
+        out_value->set_integer(int32_t(value));
+        break;
+      case Value::Type::kArray: {
+        if (depth > 16 || value >= header_.array_words ||
+            arrays_[value] > (header_.array_words - value - 1) / 2) {
+          return false;
+        }
+        uint32_t count = arrays_[value];
+        auto array = new ValueArray();
+        out_value->set_array(array, Value::Set::kTakeOwnership);
+        for (uint32_t i = 0; i < count; ++i) {
+          if (!DecodeValue(arrays_[value + 1 + i * 2],
+                           arrays_[value + 2 + i * 2], array->AddValue(),
+                           depth + 1)) {
+            return false;
+          }
+        }
+        break;
+      }
+      default:
+        return false;
+    }
+    return true;
+  }
+
+  const uint8_t* data_;
+  size_t data_length_;
+  util::Arena* arena_;
+  BinaryHeader header_;
+  const BinaryNode* nodes_ = nullptr;
+  const uint32_t* string_offsets_ = nullptr;
+  const char* strings_ = nullptr;
+  const uint32_t* arrays_ = nullptr;
+};
+
+// static
+bool ParseNode::IsBinary(const void* data, size_t data_length) {
+  uint32_t magic;
+  if (data_length < sizeof(magic)) {
+    return false;
+  }
+  std::memcpy(&magic, data, sizeof(magic));
+  return magic == kBinaryMagic;
+}
+
+bool ParseNode::ReadBinary(const void* data, size_t data_length,
+                           ReadFlags flags) {
+  return ReadBinary(data, data_length, PrepareRead(flags));
+}
+
+bool ParseNode::ReadBinary(const void* data, size_t data_length,
+                           util::Arena* arena) {
+  ParseNodeBinaryReader reader(reinterpret_cast<const uint8_t*>(data),
+                               data_length, arena);
+  return reader.Read(this);
+}
+
+void ParseNode::WriteBinary(std::vector<uint8_t>* out) {
+  ParseNodeBinaryWriter writer;
+  writer.Write(this, out);
+}
+
+bool ParseNode::WriteBinaryFile(const std::string& filename) {
+  std::vector<uint8_t> data;
+  WriteBinary(&data);
+  FILE* file = fopen(filename.c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+  bool success = fwrite(data.data(), 1, data.size(), file) == data.size();
+  fclose(file);
+  return success;
+}
+
 void ParseNode::Clear() {
-  free(m_name);
+  if (!m_is_arena_allocated) {
+    free(m_name);
+  }
   m_name = nullptr;
-  m_children.DeleteAll();
+  while (ParseNode* n = m_children.GetFirst()) {
+    m_children.Remove(n);
+    Destroy(n);
+  }
+  m_arena.reset();
 }
 
 }  // namespace parsing
@@ -10,9 +10,12 @@
 #ifndef EL_PARSING_PARSE_NODE_H_
 #define EL_PARSING_PARSE_NODE_H_
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "el/types.h"
+#include "el/util/arena.h"
 #include "el/util/intrusive_list.h"
 #include "el/value.h"
 
@@ -24,6 +27,12 @@ enum class ReadFlags {
   // Read nodes without clearing first. Can be used to append data from multiple
   // sources, or inject dependencies.
   kAppend = 1,
+  // Allocate the read nodes, names and string values from an arena owned by
+  // the node reading, instead of one heap allocation each. The arena is freed
+  // when the node is cleared or deleted, so the read nodes must not be moved
+  // to another tree. Reading many nodes this way is faster and avoids heap
+  // fragmentation.
+  kArena = 2,
 };
 MAKE_ENUM_FLAG_COMBO(ReadFlags);
 
@@ -47,6 +56,8 @@ class ParseNode : public util::IntrusiveListEntry<ParseNode> {
   void EmplaceValue(Value value);
 
   // Reads a tree of nodes from file into this node.
+  // The file may be in the text format, or the binary format written by
+  // WriteBinary (detected automatically).
   // Returns true on success.
   bool ReadFile(const std::string& filename,
                 ReadFlags flags = ReadFlags::kNone);
@@ -55,15 +66,32 @@ class ParseNode : public util::IntrusiveListEntry<ParseNode> {
   void ReadData(const char* data, ReadFlags flags = ReadFlags::kNone);
 
   // Reads a tree of nodes from a buffer with a known length.
+  // The data may be in the text or binary format (detected automatically).
   void ReadData(const char* data, size_t data_length,
                 ReadFlags flags = ReadFlags::kNone);
 
+  // Returns true if data starts like the binary format written by WriteBinary.
+  static bool IsBinary(const void* data, size_t data_length);
+
+  // Reads a tree of nodes written by WriteBinary.
+  // Returns false if the data is not valid or the nodes are nested too deep,
+  // in which case the nodes read so far are kept.
+  bool ReadBinary(const void* data, size_t data_length,
+                  ReadFlags flags = ReadFlags::kNone);
+
+  // Writes all child nodes (recursively) to out in a compact binary format,
+  // that can be read again without parsing. Names and string values are
+  // stored once in a string table, and values keep their type.
+  // Object values are not supported and are written as null.
+  void WriteBinary(std::vector<uint8_t>* out);
+
+  // Writes the child nodes in binary format (See WriteBinary) to the given
+  // file. Returns false on fail.
+  bool WriteBinaryFile(const std::string& filename);
+
   // Clears the contents of this node.
   void Clear();
 
-  // FIX: Add write support!
-  // bool WriteFile(const char *filename);
-
   // Adds node as child to this node.
   void Add(ParseNode* n) {
     m_children.AddLast(n);
@@ -89,7 +117,10 @@ class ParseNode : public util::IntrusiveListEntry<ParseNode> {
   }
 
   // Removes and deletes child node n from this node.
-  void Delete(ParseNode* n) { m_children.Delete(n); }
+  void Delete(ParseNode* n) {
+    m_children.Remove(n);
+    Destroy(n);
+  }
 
   // Creates duplicates of the source node and all child nodes.
   // NOTE: nodes do not replace existing nodes with the same name. Cloned nodes
@@ -152,19 +183,33 @@ class ParseNode : public util::IntrusiveListEntry<ParseNode> {
   inline ParseNode* last_child() const { return m_children.GetLast(); }
 
  private:
+  friend class ParseNodeBinaryReader;
   friend class ParseNodeTarget;
   friend class ParseNodeTree;
 
   ParseNode* GetNodeFollowRef(const char* request,
                               MissingPolicy mp = MissingPolicy::kNull);
   ParseNode* GetNodeInternal(const char* name, size_t name_len) const;
-  static ParseNode* Create(const char* name, size_t name_len);
+  // Creates a new node, allocated from arena if not nullptr.
+  static ParseNode* Create(const char* name, size_t name_len,
+                           util::Arena* arena = nullptr);
+  // Deletes a node created by Create.
+  static void Destroy(ParseNode* node);
+  void CloneChildren(ParseNode* source, util::Arena* arena);
+  bool ReadFile(const std::string& filename, util::Arena* arena);
+  bool ReadBinary(const void* data, size_t data_length, util::Arena* arena);
+  // Makes sure m_arena exists if flags has ReadFlags::kArena, and returns it.
+  util::Arena* PrepareRead(ReadFlags flags);
 
   char* m_name = nullptr;
   Value m_value;
-  util::AutoDeleteIntrusiveList<ParseNode> m_children;
+  util::IntrusiveList<ParseNode> m_children;
   ParseNode* m_parent = nullptr;
   uint32_t m_cycle_id = 0;  // Used to detect circular references.
+  // True if this node, its name and string value is allocated from an arena.
+  bool m_is_arena_allocated = false;
+  // The arena owning the nodes read with ReadFlags::kArena.
+  std::unique_ptr<util::Arena> m_arena;
 };
 
 }  // namespace parsing
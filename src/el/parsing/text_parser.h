@@ -42,6 +42,10 @@ class TextParser {
   Status Read(TextParserStream* stream, TextParserTarget* target);
 
  private:
+  // Handles all complete lines in buf, tokenizing them in place.
+  // Returns the number of chars consumed. The rest is the start of a line that
+  // is not terminated yet.
+  size_t OnData(char* buf, size_t buf_len, TextParserTarget* target);
   void OnLine(char* line, TextParserTarget* target);
   void OnCompactLine(char* line, TextParserTarget* target);
   void OnMultiline(char* line, TextParserTarget* target);
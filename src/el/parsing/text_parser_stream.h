@@ -26,12 +26,18 @@ class TextParserStream {
  public:
   virtual ~TextParserStream() = default;
   virtual size_t GetMoreData(char* buf, size_t buf_len) = 0;
+
+  // Gets all data of the stream if it's available in memory, so the parser
+  // can use it directly instead of copying it with GetMoreData.
+  // Returns nullptr if the data must be read with GetMoreData.
+  virtual const char* GetAllData(size_t* /*out_length*/) { return nullptr; }
 };
 
 class FileTextParserStream : public TextParserStream {
  public:
   bool Read(const std::string& filename, TextParserTarget* target);
   size_t GetMoreData(char* buf, size_t buf_len) override;
+  const char* GetAllData(size_t* out_length) override;
 
  private:
   std::unique_ptr<io::File> file_;
@@ -41,6 +47,7 @@ class DataTextParserStream : public TextParserStream {
  public:
   bool Read(const char* data, size_t data_length, TextParserTarget* target);
   size_t GetMoreData(char* buf, size_t buf_len) override;
+  const char* GetAllData(size_t* out_length) override;
 
  private:
   const char* m_data = nullptr;
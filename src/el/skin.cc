@@ -12,16 +12,20 @@
 #include <cstdio>
 #include <string>
 
+#include "el/graphics/image_loader.h"
 #include "el/parsing/parse_node.h"
 #include "el/skin.h"
 #include "el/util/debug.h"
 #include "el/util/metrics.h"
 #include "el/util/string_builder.h"
+#include "el/util/trace.h"
+#include "el/util/work_pool.h"
 
 namespace el {
 
 using graphics::Renderer;
 using parsing::ParseNode;
+using parsing::ReadFlags;
 
 std::unique_ptr<Skin> Skin::skin_singleton_;
 
@@ -65,8 +69,9 @@ bool Skin::Load(const char* skin_file) {
 }
 
 bool Skin::LoadInternal(const char* skin_file) {
+  // The nodes are only needed while loading, so read them into an arena.
   ParseNode node;
-  if (!node.ReadFile(skin_file)) {
+  if (!node.ReadFile(skin_file, ReadFlags::kArena)) {
     return false;
   }
 
@@ -123,20 +128,27 @@ bool Skin::LoadInternal(const char* skin_file) {
     // If we have a "clone" node, clone all children from that node
     // into this node.
     while (ParseNode* clone = n->GetNode("clone")) {
-      n->Remove(clone);
-
       ParseNode* clone_source = elements->GetNode(clone->value().as_string());
       if (clone_source) {
         n->CloneChildren(clone_source);
       }
 
-      delete clone;
+      n->Delete(clone);
     }
 
     // If the skin element already exist, we will call Load on it again.
     // This will patch the element with any new data from the node.
     TBID element_id(n->name());
     SkinElement* element = GetSkinElementById(element_id);
+    if (element && element->name.compare(n->name()) != 0) {
+      // Two different names hash to the same id. Patching the element would
+      // make them silently alias, so skip this one.
+      TBDebugOut("Skin error: Element %s has the same id as %s!\n", n->name(),
+                 element->name.c_str());
+      assert(!"Skin element id collision");
+      n = n->GetNext();
+      continue;
+    }
     if (!element) {
       element = new SkinElement();
       m_elements.emplace(element_id, std::unique_ptr<SkinElement>(element));
@@ -156,14 +168,25 @@ void Skin::UnloadBitmaps() {
   // Unset all bitmap pointers.
   for (auto& it : m_elements) {
     it.second->bitmap = nullptr;
+    it.second->bitmap_load_failed_ = false;
   }
 
+  // Forget residency of everything, as the fragments are going away.
+  m_resident_bitmap_lookup.clear();
+  m_resident_bitmaps.DeleteAll();
+  m_residency_stats.resident_count = 0;
+  m_residency_stats.resident_bytes = 0;
+
   // Clear all fragments and bitmaps.
   m_frag_manager.Clear();
 }
 
 bool Skin::ReloadBitmaps() {
   UnloadBitmaps();
+  if (m_lazy_bitmap_loading) {
+    // Bitmaps will be loaded as they are used.
+    return true;
+  }
   bool success = ReloadBitmapsInternal();
   // Create all bitmaps for the bitmap fragment maps.
   if (success) {
@@ -176,39 +199,12 @@ bool Skin::ReloadBitmaps() {
 
 bool Skin::ReloadBitmapsInternal() {
   // Load all bitmap files into new bitmap fragments.
-  util::StringBuilder filename_dst_DPI;
   bool success = true;
   for (auto& it : m_elements) {
     auto element = it.second.get();
     if (!element->bitmap_file.empty()) {
       assert(!element->bitmap);
-
-      // FIX: dedicated_map is not needed for all backends (only deprecated
-      // fixed function GL).
-      // TODO(benvanik): fix shaders/etc to properly repeat subregions?
-      // This will force a new, empty map to be created just for tiled textures.
-      bool dedicated_map = element->type == SkinElementType::kTile;
-
-      // Try to load bitmap fragment in the destination DPI (F.ex "foo.png"
-      // becomes "foo@192.png")
-      int bitmap_dpi = m_dim_conv.GetSrcDPI();
-      if (m_dim_conv.NeedConversion()) {
-        m_dim_conv.GetDstDPIFilename(element->bitmap_file, &filename_dst_DPI);
-        element->bitmap = m_frag_manager.GetFragmentFromFile(
-            filename_dst_DPI.c_str(), dedicated_map);
-        if (element->bitmap) {
-          bitmap_dpi = m_dim_conv.GetDstDPI();
-        }
-      }
-      element->SetBitmapDPI(m_dim_conv, bitmap_dpi);
-
-      // If we still have no bitmap fragment, load from default file.
-      if (!element->bitmap) {
-        element->bitmap = m_frag_manager.GetFragmentFromFile(
-            element->bitmap_file, dedicated_map);
-      }
-
-      if (!element->bitmap) {
+      if (!LoadElementBitmap(element)) {
         success = false;
       }
     }
@@ -216,6 +212,175 @@ bool Skin::ReloadBitmapsInternal() {
   return success;
 }
 
+bool Skin::LoadElementBitmap(SkinElement* element) {
+  // FIX: dedicated_map is not needed for all backends (only deprecated
+  // fixed function GL).
+  // TODO(benvanik): fix shaders/etc to properly repeat subregions?
+  // This will force a new, empty map to be created just for tiled textures.
+  bool dedicated_map = element->type == SkinElementType::kTile;
+
+  // Try to load bitmap fragment in the destination DPI (F.ex "foo.png"
+  // becomes "foo@192.png")
+  int bitmap_dpi = m_dim_conv.GetSrcDPI();
+  if (m_dim_conv.NeedConversion()) {
+    util::StringBuilder filename_dst_DPI;
+    m_dim_conv.GetDstDPIFilename(element->bitmap_file, &filename_dst_DPI);
+    element->bitmap = m_frag_manager.GetFragmentFromFile(
+        filename_dst_DPI.c_str(), dedicated_map);
+    if (element->bitmap) {
+      bitmap_dpi = m_dim_conv.GetDstDPI();
+    }
+  }
+  element->SetBitmapDPI(m_dim_conv, bitmap_dpi);
+
+  // If we still have no bitmap fragment, load from default file.
+  if (!element->bitmap) {
+    element->bitmap = m_frag_manager.GetFragmentFromFile(element->bitmap_file,
+                                                         dedicated_map);
+  }
+
+  if (!element->bitmap) {
+    element->bitmap_load_failed_ = true;
+    ++m_residency_stats.failed_load_count;
+    return false;
+  }
+  element->bitmap_width_ = element->bitmap->width();
+  element->bitmap_height_ = element->bitmap->height();
+
+  // The fragment may already be resident if it's shared with another element.
+  auto fragment = element->bitmap;
+  auto it = m_resident_bitmap_lookup.find(fragment->m_id);
+  if (it != m_resident_bitmap_lookup.end()) {
+    it->second->elements.push_back(element);
+  } else {
+    auto resident_bitmap = new ResidentBitmap();
+    resident_bitmap->elements.push_back(element);
+    resident_bitmap->fragment = fragment;
+    resident_bitmap->byte_size =
+        size_t(fragment->width()) * fragment->height() * sizeof(uint32_t);
+    m_resident_bitmaps.AddLast(resident_bitmap);
+    m_resident_bitmap_lookup.emplace(fragment->m_id, resident_bitmap);
+    ++m_residency_stats.load_count;
+    ++m_residency_stats.resident_count;
+    m_residency_stats.resident_bytes += resident_bitmap->byte_size;
+  }
+  return true;
+}
+
+void Skin::ReadElementBitmapSize(SkinElement* element) {
+  // Pick the file the same way LoadElementBitmap does.
+  int bitmap_dpi = m_dim_conv.GetSrcDPI();
+  int width = 0;
+  int height = 0;
+  bool found = false;
+  if (m_dim_conv.NeedConversion()) {
+    util::StringBuilder filename_dst_DPI;
+    m_dim_conv.GetDstDPIFilename(element->bitmap_file, &filename_dst_DPI);
+    found = graphics::ImageLoader::ReadImageSize(filename_dst_DPI.c_str(),
+                                                 &width, &height);
+    if (found) {
+      bitmap_dpi = m_dim_conv.GetDstDPI();
+    }
+  }
+  if (!found) {
+    found = graphics::ImageLoader::ReadImageSize(element->bitmap_file, &width,
+                                                 &height);
+  }
+  if (!found) {
+    // Loading it when painted would fail too.
+    element->bitmap_load_failed_ = true;
+    ++m_residency_stats.failed_load_count;
+    return;
+  }
+  element->SetBitmapDPI(m_dim_conv, bitmap_dpi);
+  element->bitmap_width_ = int16_t(width);
+  element->bitmap_height_ = int16_t(height);
+}
+
+void Skin::set_lazy_bitmap_loading(bool lazy_bitmap_loading) {
+  if (m_lazy_bitmap_loading == lazy_bitmap_loading) {
+    return;
+  }
+  m_lazy_bitmap_loading = lazy_bitmap_loading;
+  if (!m_elements.empty()) {
+    ReloadBitmaps();
+  }
+}
+
+void Skin::set_bitmap_memory_budget(size_t budget_bytes) {
+  m_bitmap_memory_budget = budget_bytes;
+  if (m_lazy_bitmap_loading) {
+    EvictBitmapsOverBudget(nullptr);
+  }
+}
+
+graphics::BitmapFragment* Skin::GetElementBitmap(SkinElement* element) {
+  if (element->bitmap) {
+    if (m_lazy_bitmap_loading) {
+      TouchResidentBitmap(element->bitmap);
+    }
+    return element->bitmap;
+  }
+  if (!m_lazy_bitmap_loading || element->bitmap_file.empty() ||
+      element->bitmap_load_failed_) {
+    return nullptr;
+  }
+  if (!LoadElementBitmap(element)) {
+    return nullptr;
+  }
+  // Another element may already have the same fragment resident.
+  TouchResidentBitmap(element->bitmap);
+  EvictBitmapsOverBudget(element->bitmap);
+  return element->bitmap;
+}
+
+void Skin::TouchResidentBitmap(graphics::BitmapFragment* fragment) {
+  auto it = m_resident_bitmap_lookup.find(fragment->m_id);
+  if (it == m_resident_bitmap_lookup.end()) {
+    return;
+  }
+  // Move to the back so the front is always the least recently used.
+  ResidentBitmap* resident_bitmap = it->second;
+  if (resident_bitmap != m_resident_bitmaps.GetLast()) {
+    m_resident_bitmaps.Remove(resident_bitmap);
+    m_resident_bitmaps.AddLast(resident_bitmap);
+  }
+}
+
+void Skin::EvictBitmapsOverBudget(graphics::BitmapFragment* keep_fragment) {
+  if (!m_bitmap_memory_budget) {
+    return;
+  }
+  while (m_residency_stats.resident_bytes > m_bitmap_memory_budget) {
+    ResidentBitmap* resident_bitmap = m_resident_bitmaps.GetFirst();
+    if (!resident_bitmap || resident_bitmap->fragment == keep_fragment) {
+      // Never evict what's about to be painted, even if it alone is larger
+      // than the budget.
+      break;
+    }
+    EvictBitmap(resident_bitmap);
+  }
+}
+
+void Skin::EvictBitmap(ResidentBitmap* resident_bitmap) {
+  auto fragment = resident_bitmap->fragment;
+
+  // Unset the bitmap pointer of all elements sharing the fragment. They will
+  // be loaded again on next use.
+  for (SkinElement* element : resident_bitmap->elements) {
+    element->bitmap = nullptr;
+  }
+
+  m_residency_stats.resident_bytes -= resident_bitmap->byte_size;
+  --m_residency_stats.resident_count;
+  ++m_residency_stats.eviction_count;
+  m_resident_bitmap_lookup.erase(fragment->m_id);
+  m_resident_bitmaps.Delete(resident_bitmap);
+
+  // Frees the space in its map, and deletes the map if it became empty.
+  m_frag_manager.FreeFragment(fragment);
+}
+
 Skin::~Skin() { Renderer::get()->RemoveListener(this); }
 
 SkinElement* Skin::GetSkinElementById(const TBID& skin_id) const {
@@ -227,12 +392,20 @@ SkinElement* Skin::GetSkinElementById(const TBID& skin_id) const {
 SkinElement* Skin::GetSkinElementStrongOverride(
     const TBID& skin_id, SkinState state,
     const SkinConditionContext& context) const {
+  return GetSkinElementStrongOverride(skin_id, state, context, nullptr);
+}
+
+SkinElement* Skin::GetSkinElementStrongOverride(
+    const TBID& skin_id, SkinState state, const SkinConditionContext& context,
+    const OverrideChain* chain) const {
   if (SkinElement* skin_element = GetSkinElementById(skin_id)) {
     // Avoid eternal recursion when overrides refer to elements referring back.
-    if (skin_element->is_getting) {
-      return nullptr;
+    for (auto link = chain; link; link = link->previous) {
+      if (link->element == skin_element) {
+        return nullptr;
+      }
     }
-    skin_element->is_getting = true;
+    OverrideChain link = {skin_element, chain};
 
     // Check if there's any strong overrides for this element with the given
     // state.
@@ -241,13 +414,11 @@ SkinElement* Skin::GetSkinElementStrongOverride(
                                                                  context);
     if (override_state) {
       if (SkinElement* override_element = GetSkinElementStrongOverride(
-              override_state->element_id, state, context)) {
-        skin_element->is_getting = false;
+              override_state->element_id, state, context, &link)) {
         return override_element;
       }
     }
 
-    skin_element->is_getting = false;
     return skin_element;
   }
   return nullptr;
@@ -263,6 +434,7 @@ SkinElement* Skin::PaintSkin(const Rect& dst_rect, SkinElement* element,
                              SkinState state,
                              const SkinConditionContext& context) {
   if (!element || element->is_painting) return nullptr;
+  EL_TRACE_ZONE("Skin::PaintSkin");
 
   // Avoid potential endless recursion in evil skins.
   element->is_painting = true;
@@ -317,6 +489,42 @@ SkinElement* Skin::PaintSkin(const Rect& dst_rect, SkinElement* element,
   return return_element;
 }
 
+Rect Skin::GetOpaqueRect(const Rect& dst_rect, SkinElement* element,
+                         SkinState state,
+                         const SkinConditionContext& context) const {
+  // Follow overrides like PaintSkin. Child elements are painted on top, so
+  // they can't make the result less opaque. Give up on long override chains
+  // (which may be loops).
+  for (int depth = 0; element && depth < 8; ++depth) {
+    auto override_state =
+        element->m_override_elements.GetStateElement(state, context);
+    if (!override_state) {
+      return element->GetOpaqueRect(dst_rect);
+    }
+    element = GetSkinElementById(override_state->element_id);
+  }
+  return Rect();
+}
+
+bool Skin::MayBeOpaque(SkinElement* element) const {
+  if (!element) {
+    return false;
+  }
+  if (element->may_be_opaque()) {
+    return true;
+  }
+  // Any override may be painted instead. Skins rarely chain overrides, so
+  // don't follow the overrides of overrides.
+  for (auto state_element = element->m_override_elements.first_element();
+       state_element; state_element = state_element->GetNext()) {
+    auto override_element = GetSkinElementById(state_element->element_id);
+    if (override_element && override_element->may_be_opaque()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void Skin::PaintSkinOverlay(const Rect& dst_rect, SkinElement* element,
                             SkinState state,
                             const SkinConditionContext& context) {
@@ -341,7 +549,7 @@ void Skin::PaintSkinOverlay(const Rect& dst_rect, SkinElement* element,
 
 void Skin::PaintElement(const Rect& dst_rect, SkinElement* element) {
   PaintElementBGColor(dst_rect, element);
-  if (!element->bitmap) return;
+  if (!GetElementBitmap(element)) return;
   if (element->type == SkinElementType::kImage) {
     PaintElementImage(dst_rect, element);
   } else if (element->type == SkinElementType::kTile) {
@@ -484,7 +692,7 @@ int GetFadeoutSize(int scrolled_distance, int fadeout_length) {
 void Skin::DrawEdgeFadeout(const Rect& dst_rect, TBID skin_x, TBID skin_y,
                            int left, int top, int right, int bottom) {
   if (auto skin = Skin::get()->GetSkinElementById(skin_x)) {
-    if (skin->bitmap) {
+    if (Skin::get()->GetElementBitmap(skin)) {
       int bw = skin->bitmap->width();
       int bh = skin->bitmap->height();
       int dw;
@@ -501,7 +709,7 @@ void Skin::DrawEdgeFadeout(const Rect& dst_rect, TBID skin_x, TBID skin_y,
     }
   }
   if (auto skin = Skin::get()->GetSkinElementById(skin_y)) {
-    if (skin->bitmap) {
+    if (Skin::get()->GetElementBitmap(skin)) {
       int bw = skin->bitmap->width();
       int bh = skin->bitmap->height();
       int dh;
@@ -559,13 +767,66 @@ int SkinElement::intrinsic_min_height() const {
   return cut * 2 - expand * 2;
 }
 
+bool SkinElement::may_be_opaque() const {
+  if (bg_color.a == 255) {
+    return true;
+  }
+  // Images are painted in their own size and tiles are painted from the whole
+  // (padded) bitmap, so only stretched bitmaps are known to cover the rect.
+  // Stretch borders have no center unless painted as a stretch image.
+  return bitmap && bitmap->m_opaque_inset >= 0 &&
+         type != SkinElementType::kImage && type != SkinElementType::kTile &&
+         (type != SkinElementType::kStretchBorder || cut == 0);
+}
+
+Rect SkinElement::GetOpaqueRect(const Rect& dst_rect) const {
+  if (bg_color.a == 255) {
+    return dst_rect;
+  }
+  if (!may_be_opaque()) {
+    return Rect();
+  }
+  Rect rect = dst_rect.Expand(expand, expand);
+  if (type == SkinElementType::kStretchImage || cut == 0) {
+    // The bitmap is scaled, so only a fully opaque one is known to cover.
+    return bitmap->m_opaque_inset == 0 ? rect.Clip(dst_rect) : Rect();
+  }
+  // The edges of a stretch box are painted in their bitmap size if there's
+  // room for them (and the center), so the opaque inset of the bitmap is the
+  // same in rect.
+  if (bitmap->m_opaque_inset > cut || rect.w <= cut * 2 ||
+      rect.h <= cut * 2 || bitmap->width() <= cut * 2 ||
+      bitmap->height() <= cut * 2) {
+    return Rect();
+  }
+  return rect.Shrink(bitmap->m_opaque_inset, bitmap->m_opaque_inset)
+      .Clip(dst_rect);
+}
+
+void SkinElement::LoadBitmapSize() {
+  if (!skin_ || !skin_->is_lazy_bitmap_loading()) {
+    return;
+  }
+  util::SharedStateLock lock;
+  if (!bitmap && bitmap_width_ == kSkinValueNotSpecified &&
+      !bitmap_file.empty() && !bitmap_load_failed_) {
+    skin_->ReadElementBitmapSize(this);
+  }
+}
+
 int SkinElement::intrinsic_width() const {
   if (width_ != kSkinValueNotSpecified) {
     return width_;
   }
+  // Lazily loaded bitmaps may have their size read while other elements are
+  // measured in parallel.
+  util::SharedStateLock lock;
   if (bitmap) {
     return bitmap->width() - expand * 2;
   }
+  if (bitmap_width_ != kSkinValueNotSpecified) {
+    return bitmap_width_ - expand * 2;
+  }
   // FIX: We may want to check child elements etc.
   return kSkinValueNotSpecified;
 }
@@ -574,9 +835,13 @@ int SkinElement::intrinsic_height() const {
   if (height_ != kSkinValueNotSpecified) {
     return height_;
   }
+  util::SharedStateLock lock;
   if (bitmap) {
     return bitmap->height() - expand * 2;
   }
+  if (bitmap_height_ != kSkinValueNotSpecified) {
+    return bitmap_height_ - expand * 2;
+  }
   // FIX: We may want to check child elements etc.
   return kSkinValueNotSpecified;
 }
@@ -617,6 +882,7 @@ bool SkinElement::has_state(SkinState state,
 }
 
 void SkinElement::Load(ParseNode* n, Skin* skin, const char* skin_path) {
+  skin_ = skin;
   if (auto bitmap_path = n->GetValueString("bitmap", nullptr)) {
     bitmap_file.clear();
     bitmap_file.append(skin_path);
@@ -12,13 +12,14 @@
 
 #include <memory>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
 #include "el/graphics/bitmap_fragment.h"
 #include "el/graphics/bitmap_fragment_manager.h"
 #include "el/graphics/renderer.h"
 #include "el/types.h"
 #include "el/util/dimension_converter.h"
+#include "el/util/id_map.h"
 #include "el/util/intrusive_list.h"
 #include "el/value.h"
 
@@ -225,8 +226,6 @@ class SkinElement {
   SkinElementType type = SkinElementType::kStretchBox;  // Skin element type.
   bool is_painting =
       false;  // If the skin is being painted (avoiding eternal recursing).
-  bool is_getting =
-      false;  // If the skin is being got (avoiding eternal recursion).
   int16_t padding_left = 0;    // Left padding for any content in the element.
   int16_t padding_top = 0;     // Top padding for any content in the element.
   int16_t padding_right = 0;   // Right padding for any content in the element.
@@ -275,9 +274,16 @@ class SkinElement {
   // Gets the preferred height, or kSkinValueNotSpecified if not specified.
   int preferred_height() const { return pref_height_; }
 
+  // Makes sure the bitmap size is known, so the intrinsic size can be
+  // calculated. With lazy bitmap loading (See Skin::set_lazy_bitmap_loading),
+  // this reads the size from the image file if the bitmap has never been
+  // loaded. The bitmap itself is only loaded when painted.
+  void LoadBitmapSize();
+
   // Gets the intrinsic width. If not specified using the "width" attribute, it
   // will be calculated based on the skin properties. If it can't be calculated
   // it will return kSkinValueNotSpecified.
+  // NOTE: Call LoadBitmapSize first if the bitmap may be loaded lazily.
   int intrinsic_width() const;
   // Gets the intrinsic height. If not specified using the "height" attribute,
   // it will be calculated based on the skin properties. If it can't be
@@ -302,9 +308,24 @@ class SkinElement {
     return m_overlay_elements.has_state_elements();
   }
 
+  // Gets the part of dst_rect that painting this element (not following
+  // override elements) covers with fully opaque pixels, or an empty rect.
+  // Empty if the bitmap isn't loaded yet.
+  Rect GetOpaqueRect(const Rect& dst_rect) const;
+  // Returns false if GetOpaqueRect is empty for any dst_rect.
+  bool may_be_opaque() const;
+
   void Load(parsing::ParseNode* n, Skin* skin, const char* skin_path);
 
  private:
+  Skin* skin_ = nullptr;
+  // Size of the bitmap the last time it was resident, or kSkinValueNotSpecified
+  // if it has never been loaded. Used for intrinsic sizes while evicted.
+  int16_t bitmap_width_ = kSkinValueNotSpecified;
+  int16_t bitmap_height_ = kSkinValueNotSpecified;
+  // True if loading the bitmap failed, so lazy loading won't retry each paint.
+  bool bitmap_load_failed_ = false;
+
   int16_t width_ = kSkinValueNotSpecified;
   int16_t height_ = kSkinValueNotSpecified;
   int16_t pref_width_ = kSkinValueNotSpecified;
@@ -369,8 +390,40 @@ class Skin : private graphics::RendererListener {
 
   // Reloads all bitmaps used in this skin. Calls UnloadBitmaps first to ensure
   // no bitmaps are loaded before loading new ones.
+  // If lazy bitmap loading is enabled, bitmaps are only unloaded here and will
+  // be loaded again as they are painted.
   bool ReloadBitmaps();
 
+  // Statistics about the skin bitmaps currently packed in the fragment maps.
+  struct ResidencyStats {
+    size_t resident_count = 0;  // Number of bitmaps currently resident.
+    size_t resident_bytes = 0;  // Bytes used by the resident bitmaps.
+    size_t load_count = 0;      // Number of bitmaps loaded.
+    size_t failed_load_count = 0;  // Number of bitmaps that failed to load.
+    size_t eviction_count = 0;     // Number of bitmaps evicted by the budget.
+  };
+  const ResidencyStats& residency_stats() const { return m_residency_stats; }
+
+  bool is_lazy_bitmap_loading() const { return m_lazy_bitmap_loading; }
+  // Sets whether bitmaps should be loaded on first use (when painted) instead
+  // of all at once when the skin is loaded. Measuring an element only reads
+  // the image size. This saves texture memory for skins with many elements
+  // that are rarely or never used.
+  // Changing this on a loaded skin reloads its bitmaps.
+  void set_lazy_bitmap_loading(bool lazy_bitmap_loading);
+
+  size_t bitmap_memory_budget() const { return m_bitmap_memory_budget; }
+  // Sets the number of bytes of bitmap data that may be resident when lazy
+  // bitmap loading is enabled. When exceeded, the least recently used bitmaps
+  // are evicted from the fragment maps until the skin is within budget again.
+  // Set to 0 for unlimited (default).
+  void set_bitmap_memory_budget(size_t budget_bytes);
+
+  // Gets the bitmap fragment of the given element, loading it first if lazy
+  // bitmap loading is enabled and it isn't resident.
+  // Returns nullptr if the element has no bitmap or it failed to load.
+  graphics::BitmapFragment* GetElementBitmap(SkinElement* element);
+
   // Gets the dimension converter used for the current skin. This dimension
   // converter converts to px by the same factor as the skin (based on the skin
   // DPI settings).
@@ -440,6 +493,16 @@ class Skin : private graphics::RendererListener {
   void PaintSkinOverlay(const Rect& dst_rect, SkinElement* element,
                         SkinState state, const SkinConditionContext& context);
 
+  // Gets the part of dst_rect that PaintSkin of the given skin element and
+  // state would cover with fully opaque pixels (following override elements),
+  // or an empty rect. Used to skip painting what's below.
+  Rect GetOpaqueRect(const Rect& dst_rect, SkinElement* element,
+                     SkinState state,
+                     const SkinConditionContext& context) const;
+  // Returns false if GetOpaqueRect is empty for the given skin element in any
+  // state. This is cheaper, since it doesn't evaluate any conditions.
+  bool MayBeOpaque(SkinElement* element) const;
+
   // Draw fade out skin elements at the edges of dst_rect if needed.
   // It indicates to the user that there is hidden content.
   // left, top, right, bottom specifies the (positive) distance scrolled from
@@ -464,8 +527,36 @@ class Skin : private graphics::RendererListener {
 
   static std::unique_ptr<Skin> skin_singleton_;
 
+  // A bitmap fragment loaded by the skin. Kept in m_resident_bitmaps in least
+  // recently used order. Several skin elements may share the same fragment.
+  struct ResidentBitmap : public util::IntrusiveListEntry<ResidentBitmap> {
+    graphics::BitmapFragment* fragment = nullptr;
+    size_t byte_size = 0;
+    // The elements using the fragment, to unset when it's evicted.
+    std::vector<SkinElement*> elements;
+  };
+
+  // The skin elements visited while following strong overrides, kept on the
+  // stack (instead of flagging the shared elements) so elements can be
+  // measured on several threads.
+  struct OverrideChain {
+    const SkinElement* element;
+    const OverrideChain* previous;
+  };
+
   bool LoadInternal(const char* skin_file);
+  SkinElement* GetSkinElementStrongOverride(
+      const TBID& skin_id, SkinState state, const SkinConditionContext& context,
+      const OverrideChain* chain) const;
   bool ReloadBitmapsInternal();
+  bool LoadElementBitmap(SkinElement* element);
+  // Reads the size of the bitmap of the element from its image file, without
+  // loading it. Doesn't touch the renderer, so it may be called while
+  // measuring on any thread.
+  void ReadElementBitmapSize(SkinElement* element);
+  void TouchResidentBitmap(graphics::BitmapFragment* fragment);
+  void EvictBitmapsOverBudget(graphics::BitmapFragment* keep_fragment);
+  void EvictBitmap(ResidentBitmap* resident_bitmap);
   void PaintElement(const Rect& dst_rect, SkinElement* element);
   void PaintElementBGColor(const Rect& dst_rect, SkinElement* element);
   void PaintElementImage(const Rect& dst_rect, SkinElement* element);
@@ -477,9 +568,14 @@ class Skin : private graphics::RendererListener {
   int GetPxFromNode(parsing::ParseNode* node, int def_value) const;
 
   SkinListener* m_listener = nullptr;
-  std::unordered_map<uint32_t, std::unique_ptr<SkinElement>> m_elements;
+  util::IdMap<std::unique_ptr<SkinElement>> m_elements;
   graphics::BitmapFragmentManager m_frag_manager;
   util::DimensionConverter m_dim_conv;
+  bool m_lazy_bitmap_loading = false;
+  size_t m_bitmap_memory_budget = 0;
+  util::AutoDeleteIntrusiveList<ResidentBitmap> m_resident_bitmaps;
+  util::IdMap<ResidentBitmap*> m_resident_bitmap_lookup;
+  ResidencyStats m_residency_stats;
   Color m_default_text_color;
   float m_default_disabled_opacity = 0.3f;
   float m_default_placeholder_opacity = 0.2f;
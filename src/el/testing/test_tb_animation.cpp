@@ -0,0 +1,112 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include "el/animation_manager.h"
+#include "el/element.h"
+#include "el/element_animation.h"
+#include "el/element_animation_manager.h"
+#include "el/testing/testing.h"
+
+#ifdef EL_UNIT_TESTING
+
+using namespace el;
+
+namespace {
+
+const uint64_t kLongDuration = 1000000;
+
+// Counts its callbacks, and may abort another animation when updated.
+class TestAnimation : public Animation {
+ public:
+  explicit TestAnimation(int* stop_count) : m_stop_count(stop_count) {}
+  void OnAnimationStart() override {}
+  void OnAnimationUpdate(float progress) override {
+    ++update_count;
+    last_progress = progress;
+    if (abort_on_update) {
+      AnimationManager::AbortAnimation(abort_on_update, true);
+      abort_on_update = nullptr;
+    }
+  }
+  void OnAnimationStop(bool /*aborted*/) override { ++*m_stop_count; }
+
+  int update_count = 0;
+  float last_progress = -1;
+  Animation* abort_on_update = nullptr;
+
+ private:
+  int* m_stop_count;
+};
+
+}  // namespace
+
+EL_TEST_GROUP(tb_animation) {
+  EL_TEST(complete_and_abort) {
+    int stop_count = 0;
+    auto done = new TestAnimation(&stop_count);
+    auto first = new TestAnimation(&stop_count);
+    auto aborted = new TestAnimation(&stop_count);
+    auto kept = new TestAnimation(&stop_count);
+    AnimationManager::StartAnimation(done, AnimationCurve::kSmooth, 0);
+    AnimationManager::StartAnimation(first, AnimationCurve::kLinear,
+                                     kLongDuration);
+    AnimationManager::StartAnimation(aborted, AnimationCurve::kLinear,
+                                     kLongDuration);
+    AnimationManager::StartAnimation(kept, AnimationCurve::kSlowDown,
+                                     kLongDuration);
+    EL_VERIFY(AnimationManager::has_running_animations());
+    EL_VERIFY(aborted->is_animating());
+
+    // An animation aborted by an earlier one in the same update isn't
+    // updated. Zero duration completes on the first update.
+    first->abort_on_update = aborted;
+    AnimationManager::Update();
+    EL_VERIFY(stop_count == 2);
+    EL_VERIFY(first->update_count == 1 && first->last_progress == 0);
+    EL_VERIFY(kept->update_count == 1);
+
+    // Restarting aborts the running animation first.
+    AnimationManager::StartAnimation(kept, AnimationCurve::kSpeedUp, 0);
+    EL_VERIFY(stop_count == 3);
+    AnimationManager::Update();
+    EL_VERIFY(stop_count == 4);
+    EL_VERIFY(first->update_count == 2);
+    AnimationManager::AbortAnimation(first, true);
+    EL_VERIFY(stop_count == 5);
+  }
+
+  EL_TEST(abort_element_animations) {
+    Element element;
+    Element other;
+    auto opacity = new OpacityElementAnimation(&element, 0.5f, 1, false);
+    auto rect = new RectElementAnimation(&element, Rect(0, 0, 10, 10),
+                                         Rect(5, 5, 10, 10));
+    auto other_opacity = new OpacityElementAnimation(&other, 0.5f, 1, false);
+    AnimationManager::StartAnimation(opacity, AnimationCurve::kLinear,
+                                     kLongDuration);
+    AnimationManager::StartAnimation(rect, AnimationCurve::kLinear,
+                                     kLongDuration);
+    AnimationManager::StartAnimation(other_opacity, AnimationCurve::kLinear,
+                                     kLongDuration);
+
+    ElementAnimationManager::AbortAnimations(
+        &element, util::TypedObject::GetTypeId<OpacityElementAnimation>());
+    EL_VERIFY(element.opacity() == 1);
+    EL_VERIFY(rect->is_animating());
+    EL_VERIFY(other_opacity->is_animating());
+
+    ElementAnimationManager::AbortAnimations(&element);
+    EL_VERIFY(element.rect().equals(Rect(5, 5, 10, 10)));
+    EL_VERIFY(other_opacity->is_animating());
+    ElementAnimationManager::AbortAnimations(&other);
+    EL_VERIFY(other.opacity() == 1);
+  }
+}
+
+#endif  // EL_UNIT_TESTING
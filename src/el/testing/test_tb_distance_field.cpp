@@ -0,0 +1,56 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include "el/testing/testing.h"
+#include "el/text/distance_field.h"
+
+#ifdef EL_UNIT_TESTING
+
+using namespace el;
+
+EL_TEST_GROUP(tb_distance_field) {
+  EL_TEST(square) {
+    // A 16x16 square in a 32x32 coverage bitmap.
+    std::vector<uint8_t> coverage(32 * 32, 0);
+    for (int y = 8; y < 24; y++) {
+      for (int x = 8; x < 24; x++) {
+        coverage[x + y * 32] = 255;
+      }
+    }
+    std::vector<uint8_t> field;
+    int w = 0;
+    int h = 0;
+    EL_VERIFY(text::GenerateDistanceField(coverage.data(), 32, 32, 32, 2, 4,
+                                          &field, &w, &h));
+    EL_VERIFY(w == 16 + 8 && h == 16 + 8);
+    auto at = [&](int x, int y) { return int(field[x + y * w]); };
+    // Far outside saturates, and the center is about spread pixels inside.
+    EL_VERIFY(at(0, 0) == 0);
+    EL_VERIFY(at(12, 12) > 240);
+    // Increasing from outside to inside, passing the outline value around
+    // the square edge (at 4 + 8 / 2 output pixels).
+    for (int x = 1; x < 12; x++) {
+      EL_VERIFY(at(x, 12) >= at(x - 1, 12));
+    }
+    EL_VERIFY(at(7, 12) < 128 && at(8, 12) > 128);
+  }
+
+  EL_TEST(empty) {
+    std::vector<uint8_t> field;
+    int w = 0;
+    int h = 0;
+    EL_VERIFY(!text::GenerateDistanceField(nullptr, 0, 0, 0, 4, 4, &field, &w,
+                                           &h));
+  }
+}
+
+#endif  // EL_UNIT_TESTING
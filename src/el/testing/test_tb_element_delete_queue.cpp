@@ -0,0 +1,91 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include "el/element.h"
+#include "el/element_delete_queue.h"
+#include "el/element_listener.h"
+#include "el/testing/testing.h"
+
+#ifdef EL_UNIT_TESTING
+
+using namespace el;
+
+EL_TEST_GROUP(tb_element_delete_queue) {
+  EL_TEST(delete_all_children_deferred) {
+    ElementDeleteQueue* queue = ElementDeleteQueue::get();
+    EL_VERIFY(queue);
+    queue->FlushAll();
+
+    Element root;
+    Element* child = new Element();
+    Element* grand_child = new Element();
+    root.AddChild(child);
+    root.AddChild(new Element());
+    child->AddChild(grand_child);
+    grand_child->set_focus(FocusReason::kUnknown);
+    WeakElementPointer weak_child(child);
+    WeakElementPointer weak_grand_child(grand_child);
+
+    root.DeleteAllChildrenDeferred();
+    EL_VERIFY(!root.first_child());
+    EL_VERIFY(queue->size() == 2);
+    // Removed from the tree, but not deleted until the queue is flushed.
+    EL_VERIFY(weak_child.get() && weak_grand_child.get());
+    EL_VERIFY(!child->parent() && child->is_dying());
+    EL_VERIFY(grand_child->is_dying());
+    EL_VERIFY(Element::focused_element != grand_child);
+
+    root.InvokeProcess();
+    EL_VERIFY(queue->empty());
+    EL_VERIFY(!weak_child.get() && !weak_grand_child.get());
+  }
+
+  EL_TEST(focus_moves_out_of_deleted_branch) {
+    ElementDeleteQueue* queue = ElementDeleteQueue::get();
+    Element root;
+    Element* child = new Element();
+    Element* grand_child = new Element();
+    Element* sibling = new Element();
+    root.AddChild(child);
+    root.AddChild(sibling);
+    child->AddChild(grand_child);
+    grand_child->set_focusable(true);
+    sibling->set_focusable(true);
+    EL_VERIFY(grand_child->set_focus(FocusReason::kUnknown));
+
+    root.DeleteChildDeferred(child);
+    EL_VERIFY(Element::focused_element == sibling);
+
+    // Nothing is left to take the focus.
+    root.DeleteAllChildrenDeferred();
+    EL_VERIFY(!Element::focused_element);
+    queue->FlushAll();
+  }
+
+  EL_TEST(budget) {
+    ElementDeleteQueue* queue = ElementDeleteQueue::get();
+    Element root;
+    for (int i = 0; i < 10; i++) {
+      root.AddChild(new Element());
+    }
+    root.DeleteChildDeferred(root.first_child());
+    EL_VERIFY(queue->size() == 1);
+    root.DeleteAllChildrenDeferred();
+    EL_VERIFY(queue->size() == 10);
+
+    // At least one element is deleted per flush, however small the budget.
+    queue->set_budget_ms(1);
+    EL_VERIFY(queue->Flush() >= 1);
+    queue->set_budget_ms(0);
+    queue->Flush();
+    EL_VERIFY(queue->empty());
+  }
+}
+
+#endif  // EL_UNIT_TESTING
@@ -0,0 +1,74 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include "el/element.h"
+#include "el/element_pool.h"
+#include "el/elements/button.h"
+#include "el/testing/testing.h"
+
+#ifdef EL_UNIT_TESTING
+
+using namespace el;
+using namespace el::elements;
+
+EL_TEST_GROUP(tb_element_pool) {
+  EL_TEST(recycle) {
+    ElementPool* pool = ElementPool::get();
+    EL_VERIFY(pool);
+    pool->Trim();
+    pool->ResetStats();
+    size_t live_count = pool->stats().live_count;
+
+    Element root;
+    Button* button = new Button();
+    button->set_text("recycled");
+    button->set_id(TBIDC("button"));
+    root.AddChild(button);
+    EL_VERIFY(pool->stats().live_count > live_count);
+    root.DeleteAllChildren();
+    EL_VERIFY(pool->stats().pooled_count > 0);
+
+    // The memory is reused, but the element is freshly constructed.
+    pool->ResetStats();
+    Button* recycled = new Button();
+    EL_VERIFY(recycled == button);
+    EL_VERIFY(pool->stats().hit_count > 0);
+    EL_VERIFY(recycled->text().empty());
+    EL_VERIFY(recycled->id() != TBIDC("button"));
+    delete recycled;
+    EL_VERIFY(pool->stats().live_count == live_count);
+  }
+
+  EL_TEST(reserve_and_trim) {
+    ElementPool* pool = ElementPool::get();
+    pool->Trim();
+    pool->Reserve<Button>(10);
+    EL_VERIFY(pool->stats().pooled_count == 10);
+    EL_VERIFY(pool->stats().pooled_bytes ==
+              10 * ElementPool::block_size(sizeof(Button)));
+    pool->ResetStats();
+    Element* elements[10];
+    for (auto& element : elements) {
+      element = new Button();
+    }
+    EL_VERIFY(pool->stats().hit_count == 10);
+    EL_VERIFY(pool->stats().miss_count == 0);
+    EL_VERIFY(pool->stats().hit_rate() == 1.0);
+    for (auto element : elements) {
+      delete element;
+    }
+    EL_VERIFY(pool->stats().pooled_count >= 10);
+    pool->set_max_pooled_per_size(0);
+    EL_VERIFY(pool->stats().pooled_count == 0);
+    EL_VERIFY(pool->stats().pooled_bytes == 0);
+    pool->set_max_pooled_per_size(256);
+  }
+}
+
+#endif  // EL_UNIT_TESTING
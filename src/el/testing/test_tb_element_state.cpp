@@ -0,0 +1,69 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include "el/element.h"
+#include "el/testing/testing.h"
+
+#ifdef EL_UNIT_TESTING
+
+using namespace el;
+
+EL_TEST_GROUP(tb_element_state) {
+  EL_TEST(inherited_visibility) {
+    Element root;
+    Element* parent = new Element();
+    Element* child = new Element();
+    root.AddChild(parent);
+    parent->AddChild(child);
+    EL_VERIFY(child->computed_visibility());
+
+    parent->set_visibility(Visibility::kInvisible);
+    EL_VERIFY(!child->computed_visibility());
+    parent->set_visibility(Visibility::kVisible);
+    EL_VERIFY(child->computed_visibility());
+
+    root.set_opacity(0);
+    EL_VERIFY(!child->computed_visibility());
+    root.set_opacity(0.5f);
+    EL_VERIFY(child->computed_visibility());
+
+    // Moving to a hidden parent hides the element.
+    Element hidden;
+    hidden.set_visibility(Visibility::kGone);
+    parent->RemoveChild(child);
+    EL_VERIFY(child->computed_visibility());
+    hidden.AddChild(child);
+    EL_VERIFY(!child->computed_visibility());
+    EL_VERIFY(parent->computed_visibility());
+  }
+
+  EL_TEST(inherited_enabled) {
+    Element root;
+    Element* parent = new Element();
+    Element* child = new Element();
+    root.AddChild(parent);
+    parent->AddChild(child);
+    EL_VERIFY(child->is_enabled());
+
+    root.set_enabled(false);
+    EL_VERIFY(!parent->is_enabled());
+    EL_VERIFY(!child->is_enabled());
+    // Other state changes keep it disabled.
+    root.set_state(Element::State::kSelected, true);
+    EL_VERIFY(!child->is_enabled());
+    root.set_enabled(true);
+    EL_VERIFY(child->is_enabled());
+
+    child->set_enabled(false);
+    EL_VERIFY(!child->is_enabled());
+    EL_VERIFY(parent->is_enabled());
+  }
+}
+
+#endif  // EL_UNIT_TESTING
@@ -0,0 +1,65 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <memory>
+
+#include "el/element.h"
+#include "el/parsing/element_factory.h"
+#include "el/parsing/element_template.h"
+#include "el/parsing/parse_node.h"
+#include "el/testing/testing.h"
+
+#ifdef EL_UNIT_TESTING
+
+using namespace el;
+using namespace el::parsing;
+
+EL_TEST_GROUP(tb_element_template) {
+  const char* kTemplateData =
+      "LayoutBox: id: 'box', axis: 'y'\n"
+      "\tButton: id: 'button', text: 'Hello', gravity: 'left right'\n"
+      "\t\tlp: width: 20\n"
+      "\tTextBox: id: 'text', state: 'disabled', visibility: 'invisible'\n"
+      "NoSuchElement: id: 'skipped'\n";
+
+  void VerifyInflated(Element* root) {
+    EL_VERIFY(root->GetElementById<Element>(TBIDC("box")));
+    Element* button = root->GetElementById<Element>(TBIDC("button"));
+    EL_VERIFY(button && button->text() == "Hello");
+    EL_VERIFY(button->gravity() == (Gravity::kLeftRight | Gravity::kTop));
+    EL_VERIFY(button->layout_params() && button->layout_params()->pref_w == 20);
+    Element* text = root->GetElementById<Element>(TBIDC("text"));
+    EL_VERIFY(text && !text->is_enabled());
+    EL_VERIFY(text->visibility() == Visibility::kInvisible);
+    EL_VERIFY(!root->GetElementById<Element>(TBIDC("skipped")));
+  }
+
+  EL_TEST(same_as_node_tree) {
+    Element root;
+    ElementFactory::get()->LoadData(&root, kTemplateData);
+    VerifyInflated(&root);
+  }
+
+  EL_TEST(inflate_many) {
+    std::unique_ptr<ElementTemplate> element_template;
+    {
+      ParseNode node;
+      node.ReadData(kTemplateData);
+      element_template = ElementFactory::get()->CompileTemplate(&node);
+    }
+    EL_VERIFY(element_template->element_count() == 3);
+    for (int i = 0; i < 3; i++) {
+      Element root;
+      ElementFactory::get()->LoadTemplate(&root, element_template.get());
+      VerifyInflated(&root);
+    }
+  }
+}
+
+#endif  // EL_UNIT_TESTING
@@ -0,0 +1,125 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "el/io/archive_file_system.h"
+#include "el/io/memory_file_system.h"
+#include "el/io/posix_file_system.h"
+#include "el/testing/testing.h"
+
+#ifdef EL_UNIT_TESTING
+
+using namespace el;
+using namespace el::io;
+
+EL_TEST_GROUP(tb_file_system) {
+  EL_TEST(memory_mapped) {
+    PosixFileSystem mapped_fs(".", true);
+    PosixFileSystem buffered_fs(".");
+    std::string filename = EL_TEST_FILE("data/test_tb_parser.tb.txt");
+    auto mapped = mapped_fs.OpenRead(filename);
+    auto buffered = buffered_fs.OpenRead(filename);
+    EL_VERIFY(mapped && buffered);
+    EL_VERIFY(!buffered->data());
+    EL_VERIFY(mapped->size() == buffered->size());
+    std::vector<uint8_t> contents(buffered->size());
+    EL_VERIFY(buffered->Read(contents.data(), contents.size()) ==
+              contents.size());
+    EL_VERIFY(mapped->data());
+    EL_VERIFY(std::memcmp(mapped->data(), contents.data(), contents.size()) ==
+              0);
+
+    // Reading must still work on a mapped file.
+    std::vector<uint8_t> read_contents(mapped->size() + 10);
+    EL_VERIFY(mapped->Read(read_contents.data(), read_contents.size()) ==
+              contents.size());
+    EL_VERIFY(mapped->Read(read_contents.data(), read_contents.size()) == 0);
+  }
+
+  EL_TEST(memory_file) {
+    static const char kData[] = "foo: bar";
+    MemoryFileSystem fs;
+    fs.AddFile("foo.txt", kData, sizeof(kData) - 1);
+    auto file = fs.OpenRead("foo.txt");
+    EL_VERIFY(file && file->size() == sizeof(kData) - 1);
+    EL_VERIFY(file->data() == reinterpret_cast<const uint8_t*>(kData));
+    EL_VERIFY(!fs.OpenRead("bar.txt"));
+  }
+
+  EL_TEST(archive) {
+    std::string compressible;
+    for (int i = 0; i < 1000; ++i) {
+      compressible += "element: " + std::to_string(i % 7) + "\n";
+    }
+    std::vector<uint8_t> random(3000);
+    uint32_t seed = 1;
+    for (auto& b : random) {
+      seed = seed * 1103515245 + 12345;
+      b = uint8_t(seed >> 16);
+    }
+    ArchiveWriter writer;
+    EL_VERIFY(writer.AddFile("layout/test.tb.txt", compressible.data(),
+                             compressible.size()));
+    EL_VERIFY(writer.AddFile("images/random.png", random.data(),
+                             random.size()));
+    EL_VERIFY(writer.AddFile("empty.txt", "", 0));
+    EL_VERIFY(!writer.AddFile("./empty.txt", "", 0));
+    for (int i = 0; i < 100; ++i) {
+      std::string name = "many/" + std::to_string(i);
+      EL_VERIFY(writer.AddFile(name, name.data(), name.size(), false));
+    }
+    std::vector<uint8_t> data;
+    writer.Write(&data);
+    // Compressed well below the size of the compressible file.
+    EL_VERIFY(data.size() < compressible.size() / 2 + random.size() + 2000);
+
+    MemoryFileSystem memory_fs;
+    memory_fs.AddFile("test.elpak", data.data(), data.size());
+    auto archive = ArchiveFileSystem::Create(memory_fs.OpenRead("test.elpak"));
+    EL_VERIFY(archive && archive->file_count() == 103);
+
+    auto file = archive->OpenRead("layout\\test.tb.txt");
+    EL_VERIFY(file && file->size() == compressible.size());
+    std::string read_contents(file->size(), 0);
+    EL_VERIFY(file->Read(&read_contents[0], read_contents.size()) ==
+              compressible.size());
+    EL_VERIFY(read_contents == compressible);
+
+    // Stored files are aligned views into the archive.
+    file = archive->OpenRead("images/random.png");
+    EL_VERIFY(file && file->size() == random.size());
+    EL_VERIFY(file->data() >= data.data() &&
+              file->data() < data.data() + data.size());
+    EL_VERIFY((file->data() - data.data()) % 16 == 0);
+    EL_VERIFY(std::memcmp(file->data(), random.data(), random.size()) == 0);
+
+    file = archive->OpenRead("empty.txt");
+    EL_VERIFY(file && file->size() == 0);
+    for (int i = 0; i < 100; ++i) {
+      std::string name = "many/" + std::to_string(i);
+      file = archive->OpenRead(name);
+      EL_VERIFY(file && file->size() == name.size());
+      EL_VERIFY(std::memcmp(file->data(), name.data(), name.size()) == 0);
+    }
+    EL_VERIFY(!archive->OpenRead("many/100"));
+    EL_VERIFY(!archive->OpenRead("layout/test"));
+
+    // Truncated or foreign data is rejected.
+    memory_fs.AddFile("truncated.elpak", data.data(), 40);
+    EL_VERIFY(!ArchiveFileSystem::Create(
+        memory_fs.OpenRead("truncated.elpak")));
+    EL_VERIFY(!ArchiveFileSystem::Create(memory_fs.OpenRead("missing")));
+  }
+}
+
+#endif  // EL_UNIT_TESTING
@@ -0,0 +1,124 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "el/graphics/bitmap_fragment.h"
+#include "el/testing/testing.h"
+#include "el/text/font_face.h"
+#include "el/text/font_manager.h"
+#include "el/text/font_renderer.h"
+
+#ifdef EL_UNIT_TESTING
+
+using namespace el;
+using el::text::FontFace;
+using el::text::FontGlyph;
+using el::text::FontGlyphCache;
+using el::text::FontGlyphData;
+using el::text::FontManager;
+using el::text::FontMetrics;
+using el::text::FontRenderer;
+using el::text::GlyphMetrics;
+using el::text::utf8::UCS4;
+
+namespace {
+
+// Gives all glyphs an advance of 1, to tell them from preloaded ones.
+class TestFontRenderer : public FontRenderer {
+ public:
+  std::unique_ptr<FontFace> Create(FontManager* /*font_manager*/,
+                                   const std::string& /*filename*/,
+                                   const FontDescription& /*font_desc*/)
+      override {
+    return nullptr;
+  }
+  bool RenderGlyph(FontGlyphData* /*data*/, UCS4 /*cp*/) override {
+    return false;
+  }
+  void GetGlyphMetrics(GlyphMetrics* metrics, UCS4 /*cp*/) override {
+    metrics->advance = 1;
+  }
+  FontMetrics GetMetrics() override { return FontMetrics(); }
+};
+
+}  // namespace
+
+EL_TEST_GROUP(tb_font_glyph_cache) {
+  EL_TEST(save_load) {
+    std::vector<uint8_t> data;
+    {
+      FontGlyphCache cache;
+      FontGlyph* glyph = cache.CreateAndCacheGlyph(1234, 'a');
+      glyph->metrics.advance = 7;
+      glyph->metrics.y = -5;
+      uint32_t pixels[3 * 2] = {1, 2, 3, 4, 5, 6};
+      EL_VERIFY(cache.CreateFragment(glyph, 3, 2, 3, pixels));
+      // A glyph without bitmap (such as space) only has metrics.
+      cache.CreateAndCacheGlyph(1235, ' ')->metrics.advance = 3;
+      cache.SaveGlyphs(&data);
+    }
+
+    FontGlyphCache cache;
+    EL_VERIFY(cache.LoadGlyphs(data.data(), data.size()));
+    FontGlyph* glyph = cache.GetGlyph(1234, 'a');
+    EL_VERIFY(glyph && glyph->frag);
+    EL_VERIFY(glyph->metrics.advance == 7 && glyph->metrics.y == -5);
+    EL_VERIFY(glyph->frag->width() == 3 && glyph->frag->height() == 2);
+    glyph = cache.GetGlyph(1235, ' ');
+    EL_VERIFY(glyph && !glyph->frag && glyph->metrics.advance == 3);
+
+    // Saving again should produce the same data, including the pixels.
+    std::vector<uint8_t> data2;
+    cache.SaveGlyphs(&data2);
+    EL_VERIFY(data2 == data);
+
+    // Truncated or other version data is rejected.
+    EL_VERIFY(!cache.LoadGlyphs(data.data(), data.size() - 1));
+    // So is a glyph larger than the cache map. The width of the only entry
+    // follows the 12 byte header and 16 bytes of the entry.
+    std::vector<uint8_t> huge;
+    {
+      FontGlyphCache huge_cache;
+      uint32_t pixel = 1;
+      EL_VERIFY(huge_cache.CreateFragment(
+          huge_cache.CreateAndCacheGlyph(1236, 'b'), 1, 1, 1, &pixel));
+      huge_cache.SaveGlyphs(&huge);
+    }
+    huge[12 + 16] = huge[12 + 17] = 0xFF;
+    EL_VERIFY(!cache.LoadGlyphs(huge.data(), huge.size()));
+    data[4]++;
+    EL_VERIFY(!cache.LoadGlyphs(data.data(), data.size()));
+  }
+
+  EL_TEST(preloaded_glyphs_are_direct) {
+    FontDescription font_desc;
+    font_desc.set_id(TBIDC("tb_font_glyph_cache_face"));
+    font_desc.set_size(10);
+    std::vector<uint8_t> data;
+    {
+      FontGlyphCache cache;
+      uint32_t hash_id = 'a' * 31 + uint32_t(font_desc.font_face_id());
+      cache.CreateAndCacheGlyph(hash_id, 'a')->metrics.advance = 7;
+      cache.SaveGlyphs(&data);
+    }
+
+    FontGlyphCache cache;
+    EL_VERIFY(cache.LoadGlyphs(data.data(), data.size()));
+    FontFace face(&cache, std::make_unique<TestFontRenderer>(), font_desc);
+    EL_VERIFY(!face.has_direct_glyph('a'));
+    EL_VERIFY(face.GetStringWidth("ab") == 7 + 1);
+    EL_VERIFY(face.has_direct_glyph('a') && face.has_direct_glyph('b'));
+  }
+}
+
+#endif  // EL_UNIT_TESTING
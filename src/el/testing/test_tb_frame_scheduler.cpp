@@ -0,0 +1,114 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <memory>
+#include <vector>
+
+#include "el/element.h"
+#include "el/elements/list_box.h"
+#include "el/frame_scheduler.h"
+#include "el/testing/testing.h"
+
+#ifdef EL_UNIT_TESTING
+
+using namespace el;
+
+EL_TEST_GROUP(tb_frame_scheduler) {
+  EL_TEST(tasks) {
+    FrameScheduler scheduler;
+    std::vector<int> log;
+    int resumed = 0;
+    scheduler.Post(FramePriority::kIdle, [&]() {
+      log.push_back(3);
+      return true;
+    });
+    scheduler.Post(FramePriority::kInput, [&]() {
+      log.push_back(1);
+      return true;
+    });
+    scheduler.Post(FramePriority::kLayout, [&]() {
+      log.push_back(2);
+      // Finish on the second frame.
+      return ++resumed == 2;
+    });
+    auto cancelled = scheduler.Post(FramePriority::kLayout, [&]() {
+      log.push_back(-1);
+      return true;
+    });
+    EL_VERIFY(scheduler.Cancel(cancelled));
+    EL_VERIFY(!scheduler.Cancel(cancelled));
+
+    scheduler.RunFrame(nullptr);
+    EL_VERIFY(log == std::vector<int>({1, 2, 3}));
+    EL_VERIFY(scheduler.has_pending_tasks());
+    EL_VERIFY(scheduler.pending_task_count(FramePriority::kLayout) == 1);
+    scheduler.RunFrame(nullptr);
+    EL_VERIFY(log == std::vector<int>({1, 2, 3, 2}));
+    EL_VERIFY(!scheduler.has_pending_tasks());
+    EL_VERIFY(scheduler.timing(FramePriority::kLayout).frame_count == 2);
+    EL_VERIFY(scheduler.frame_timing().frame_count == 2);
+    EL_VERIFY(!scheduler.is_in_frame());
+  }
+
+  EL_TEST(budget) {
+    FrameScheduler scheduler;
+    scheduler.set_budget_us(0);
+    int layout_runs = 0;
+    int idle_runs = 0;
+    bool yield_in_frame = false;
+    for (int i = 0; i < 3; i++) {
+      scheduler.Post(FramePriority::kLayout, [&]() {
+        yield_in_frame = scheduler.ShouldYield();
+        ++layout_runs;
+        return true;
+      });
+    }
+    scheduler.Post(FramePriority::kIdle, [&]() {
+      ++idle_runs;
+      return true;
+    });
+    EL_VERIFY(!scheduler.ShouldYield());
+
+    // Only one layout task runs per frame when the budget is used up, and
+    // idle tasks wait for a frame with budget left.
+    scheduler.RunFrame(nullptr);
+    EL_VERIFY(yield_in_frame);
+    EL_VERIFY(layout_runs == 1 && idle_runs == 0);
+    scheduler.RunFrame(nullptr);
+    EL_VERIFY(layout_runs == 2 && idle_runs == 0);
+    scheduler.set_budget_us(1000000);
+    scheduler.RunFrame(nullptr);
+    EL_VERIFY(layout_runs == 3 && idle_runs == 1);
+  }
+
+  EL_TEST(list_box_population) {
+    FrameScheduler* scheduler = FrameScheduler::get();
+    uint64_t budget_us = scheduler->budget_us();
+    scheduler->set_budget_us(0);
+
+    Element root;
+    auto list_box = new elements::ListBox();
+    root.AddChild(list_box);
+    for (int i = 0; i < 100; i++) {
+      list_box->default_source()->push_back(
+          std::make_unique<GenericStringItem>("item"));
+    }
+    scheduler->RunFrame(&root);
+    EL_VERIFY(list_box->GetItemElement(0));
+    EL_VERIFY(!list_box->GetItemElement(99));
+    for (int i = 0; i < 10 && !list_box->GetItemElement(99); i++) {
+      scheduler->RunFrame(&root);
+    }
+    EL_VERIFY(list_box->GetItemElement(99));
+
+    scheduler->set_budget_us(budget_us);
+  }
+}
+
+#endif  // EL_UNIT_TESTING
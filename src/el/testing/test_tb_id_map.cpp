@@ -0,0 +1,99 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "el/id.h"
+#include "el/testing/testing.h"
+#include "el/util/id_map.h"
+
+#ifdef EL_UNIT_TESTING
+
+using namespace el;
+using el::util::IdMap;
+
+EL_TEST_GROUP(tb_id_map) {
+  EL_TEST(insert_find_erase) {
+    IdMap<std::string> map;
+    EL_VERIFY(map.empty());
+    EL_VERIFY(map.find(TBIDC("apple")) == map.end());
+
+    EL_VERIFY(map.emplace(TBIDC("apple"), "apple").second);
+    EL_VERIFY(map.emplace(TBIDC("pear"), "pear").second);
+    EL_VERIFY(!map.emplace(TBIDC("apple"), "other").second);
+    EL_VERIFY(map.size() == 2);
+    EL_VERIFY(map.find(TBIDC("apple"))->second == "apple");
+    EL_VERIFY(map.count(TBIDC("pear")) == 1);
+
+    EL_VERIFY(map.erase(TBIDC("apple")) == 1);
+    EL_VERIFY(map.erase(TBIDC("apple")) == 0);
+    EL_VERIFY(map.find(TBIDC("apple")) == map.end());
+    EL_VERIFY(map.find(TBIDC("pear"))->second == "pear");
+    EL_VERIFY(map.size() == 1);
+  }
+
+  EL_TEST(grow_and_erase_keeps_probe_chains) {
+    IdMap<std::unique_ptr<int>> map;
+    // Sequential keys exercise the hash spreading, and the erase of every
+    // other key forces entries to be shifted back into the holes.
+    for (int i = 0; i < 1000; i++) {
+      map.emplace(i, std::make_unique<int>(i));
+    }
+    EL_VERIFY(map.size() == 1000);
+    for (int i = 0; i < 1000; i += 2) {
+      EL_VERIFY(map.erase(i) == 1);
+    }
+    EL_VERIFY(map.size() == 500);
+    for (int i = 0; i < 1000; i++) {
+      auto it = map.find(i);
+      if (i % 2) {
+        EL_VERIFY(it != map.end() && *it->second == i);
+      } else {
+        EL_VERIFY(it == map.end());
+      }
+    }
+    size_t iterated = 0;
+    for (auto& it : map) {
+      EL_VERIFY(it.first % 2 == 1);
+      ++iterated;
+    }
+    EL_VERIFY(iterated == 500);
+  }
+
+  EL_TEST(key_zero) {
+    IdMap<int> map;
+    map[0] = 5;
+    EL_VERIFY(map.count(0) == 1);
+    EL_VERIFY(map[0] == 5);
+    map.clear();
+    EL_VERIFY(map.count(0) == 0);
+  }
+
+  EL_TEST(registry) {
+    IdRegistry* registry = IdRegistry::get();
+    TBID id = TBID::Intern("tb_id_map_registry_test");
+    EL_VERIFY(id == TBIDC("tb_id_map_registry_test"));
+    EL_VERIFY(registry->GetString(id) != nullptr);
+    EL_VERIFY(registry->Register("tb_id_map_registry_test"));
+
+    // Registered strings stay put when the registry grows, also short ones
+    // that std::string would store inline.
+    TBID short_id = TBID::Intern("tb_short");
+    const char* string = registry->GetString(short_id);
+    for (int i = 0; i < 1000; i++) {
+      registry->Register(
+          ("tb_id_map_registry_grow_" + std::to_string(i)).c_str());
+    }
+    EL_VERIFY(strcmp(string, "tb_short") == 0);
+  }
+}
+
+#endif  // EL_UNIT_TESTING
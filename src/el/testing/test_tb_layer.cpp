@@ -0,0 +1,159 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <cstring>
+#include <memory>
+
+#include "el/element.h"
+#include "el/graphics/software_renderer.h"
+#include "el/io/file_manager.h"
+#include "el/io/memory_file_system.h"
+#include "el/skin.h"
+#include "el/testing/testing.h"
+#include "el/util/counters.h"
+
+#ifdef EL_UNIT_TESTING
+
+using namespace el;
+using el::graphics::Renderer;
+using el::graphics::SoftwareRenderer;
+using el::util::Counter;
+using el::util::Counters;
+
+namespace {
+
+const char kLayerSkin[] =
+    "elements\n"
+    "\tLayerRed\n"
+    "\t\tbackground-color #ff0000\n"
+    "\tLayerBlue\n"
+    "\t\tbackground-color #0000ff\n";
+
+void LoadLayerSkin() {
+  if (Skin::get()->GetSkinElementById(TBIDC("LayerRed"))) {
+    return;
+  }
+  auto file_system = std::make_unique<io::MemoryFileSystem>();
+  file_system->AddFile("test_layer_skin.tb.txt", kLayerSkin,
+                       strlen(kLayerSkin));
+  io::FileManager::RegisterFileSystem(std::move(file_system));
+  Skin::get()->Load("test_layer_skin.tb.txt");
+}
+
+Element* AddChild(Element* parent, const Rect& rect, const char* skin) {
+  Element* child = new Element();
+  child->set_rect(rect);
+  child->set_background_skin(TBID(skin));
+  parent->AddChild(child);
+  return child;
+}
+
+// Paints the root on black and returns the number of layers painted.
+size_t PaintLayers(SoftwareRenderer* renderer, Element* root) {
+  Renderer* old_renderer = Renderer::get();
+  Renderer::set(renderer);
+  renderer->BeginPaint(40, 40);
+  renderer->Clear(Color(0, 0, 0));
+  Counters::get()->EndFrame();
+  root->InvokePaint(Element::PaintProps());
+  renderer->EndPaint();
+  Renderer::set(old_renderer);
+  return Counters::get()->frame_value(Counter::kLayersPainted);
+}
+
+uint32_t PixelAt(SoftwareRenderer* renderer, int x, int y) {
+  return renderer->pixels()[x + y * renderer->width()] & 0xffffff;
+}
+
+}  // namespace
+
+EL_TEST_GROUP(tb_layer) {
+  EL_TEST(init) { LoadLayerSkin(); }
+
+  EL_TEST(opacity_applies_to_whole_layer) {
+    SoftwareRenderer renderer;
+    Element root;
+    root.set_rect(Rect(0, 0, 40, 40));
+    Element* layer = new Element();
+    layer->set_rect(Rect(0, 0, 20, 20));
+    root.AddChild(layer);
+    AddChild(layer, Rect(0, 0, 10, 10), "LayerRed");
+    AddChild(layer, Rect(5, 0, 10, 10), "LayerBlue");
+    layer->set_opacity(0.5f);
+
+    // Without a layer, the red shows through the translucent blue.
+    EL_VERIFY(PaintLayers(&renderer, &root) == 0);
+    EL_VERIFY(PixelAt(&renderer, 7, 5) != 0x00007f);
+
+    layer->set_layer(true);
+    EL_VERIFY(PaintLayers(&renderer, &root) == 1);
+    EL_VERIFY(PixelAt(&renderer, 7, 5) == 0x00007f);
+    EL_VERIFY(PixelAt(&renderer, 2, 5) == 0x7f0000);
+  }
+
+  EL_TEST(repainted_only_when_invalidated) {
+    SoftwareRenderer renderer;
+    Element root;
+    root.set_rect(Rect(0, 0, 40, 40));
+    Element* layer = new Element();
+    layer->set_rect(Rect(0, 0, 20, 20));
+    root.AddChild(layer);
+    Element* child = AddChild(layer, Rect(0, 0, 10, 10), "LayerRed");
+    layer->set_layer(true);
+
+    EL_VERIFY(PaintLayers(&renderer, &root) == 1);
+    EL_VERIFY(PaintLayers(&renderer, &root) == 0);
+
+    // Changing the opacity or position only changes how the layer is drawn.
+    layer->set_opacity(0.5f);
+    layer->set_rect(Rect(10, 10, 20, 20));
+    EL_VERIFY(PaintLayers(&renderer, &root) == 0);
+    EL_VERIFY(PixelAt(&renderer, 12, 12) == 0x7f0000);
+
+    child->set_background_skin(TBIDC("LayerBlue"));
+    EL_VERIFY(PaintLayers(&renderer, &root) == 1);
+    EL_VERIFY(PixelAt(&renderer, 12, 12) == 0x00007f);
+
+    layer->set_rect(Rect(10, 10, 25, 20));
+    EL_VERIFY(PaintLayers(&renderer, &root) == 1);
+  }
+
+  EL_TEST(repainted_after_changes_while_hidden) {
+    SoftwareRenderer renderer;
+    Element root;
+    root.set_rect(Rect(0, 0, 40, 40));
+    Element* parent = new Element();
+    parent->set_rect(Rect(0, 0, 40, 40));
+    root.AddChild(parent);
+    Element* layer = new Element();
+    layer->set_rect(Rect(0, 0, 20, 20));
+    parent->AddChild(layer);
+    Element* child = AddChild(layer, Rect(0, 0, 10, 10), "LayerRed");
+    layer->set_layer(true);
+    EL_VERIFY(PaintLayers(&renderer, &root) == 1);
+
+    // Changes while the layer is transparent must show when it's visible.
+    layer->set_opacity(0);
+    child->set_background_skin(TBIDC("LayerBlue"));
+    EL_VERIFY(PaintLayers(&renderer, &root) == 0);
+    layer->set_opacity(1);
+    EL_VERIFY(PaintLayers(&renderer, &root) == 1);
+    EL_VERIFY(PixelAt(&renderer, 5, 5) == 0x0000ff);
+
+    // The same goes for changes while an ancestor is hidden.
+    parent->set_visibility(Visibility::kInvisible);
+    child->set_background_skin(TBIDC("LayerRed"));
+    EL_VERIFY(PaintLayers(&renderer, &root) == 0);
+    parent->set_visibility(Visibility::kVisible);
+    EL_VERIFY(PaintLayers(&renderer, &root) == 1);
+    EL_VERIFY(PixelAt(&renderer, 5, 5) == 0xff0000);
+  }
+}
+
+#endif  // EL_UNIT_TESTING
@@ -0,0 +1,149 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <cstring>
+#include <memory>
+
+#include "el/element.h"
+#include "el/elements/layout_box.h"
+#include "el/graphics/renderer.h"
+#include "el/io/file_manager.h"
+#include "el/io/memory_file_system.h"
+#include "el/skin.h"
+#include "el/testing/testing.h"
+#include "el/util/counters.h"
+
+#ifdef EL_UNIT_TESTING
+
+using namespace el;
+using el::graphics::Renderer;
+using el::util::Counter;
+using el::util::Counters;
+
+namespace {
+
+const char kOcclusionSkin[] =
+    "elements\n"
+    "\tOcclusionOpaque\n"
+    "\t\tbackground-color #ff0000\n"
+    "\tOcclusionTranslucent\n"
+    "\t\tbackground-color #ff000080\n";
+
+void LoadOcclusionSkin() {
+  if (Skin::get()->GetSkinElementById(TBIDC("OcclusionOpaque"))) {
+    return;
+  }
+  auto file_system = std::make_unique<io::MemoryFileSystem>();
+  file_system->AddFile("test_occlusion_skin.tb.txt", kOcclusionSkin,
+                       strlen(kOcclusionSkin));
+  io::FileManager::RegisterFileSystem(std::move(file_system));
+  Skin::get()->Load("test_occlusion_skin.tb.txt");
+}
+
+Element* AddChild(Element* parent, const Rect& rect, const char* skin) {
+  Element* child = new Element();
+  child->set_rect(rect);
+  child->set_background_skin(TBID(skin));
+  parent->AddChild(child);
+  return child;
+}
+
+class TestBitmap : public graphics::Bitmap {
+ public:
+  int width() override { return 64; }
+  int height() override { return 64; }
+  void set_data(uint32_t* /*data*/) override {}
+};
+
+class NullRenderer : public Renderer {
+ public:
+  NullRenderer() { batch_.vertices = vertices_; }
+  std::unique_ptr<graphics::Bitmap> CreateBitmap(int /*width*/, int /*height*/,
+                                                 uint32_t* /*data*/) override {
+    return std::make_unique<TestBitmap>();
+  }
+
+ protected:
+  size_t max_vertex_batch_size() const override { return 6 * 64; }
+  void RenderBatch(Batch* /*batch*/) override {}
+  void set_clip_rect(const Rect& /*rect*/) override {}
+  Vertex vertices_[6 * 64];
+};
+
+// Paints the root and returns the number of occluded elements.
+size_t PaintOccluded(Element* root) {
+  NullRenderer renderer;
+  Renderer* old_renderer = Renderer::get();
+  Renderer::set(&renderer);
+  renderer.BeginPaint(100, 100);
+  Counters::get()->EndFrame();
+  root->InvokePaint(Element::PaintProps());
+  renderer.EndPaint();
+  Renderer::set(old_renderer);
+  return Counters::get()->frame_value(Counter::kElementsOccluded);
+}
+
+}  // namespace
+
+EL_TEST_GROUP(tb_occlusion) {
+  EL_TEST(init) { LoadOcclusionSkin(); }
+
+  EL_TEST(covered_sibling_is_skipped) {
+    Element root;
+    root.set_rect(Rect(0, 0, 100, 100));
+    AddChild(&root, Rect(10, 10, 30, 30), "OcclusionTranslucent");
+    Element* cover = AddChild(&root, Rect(0, 0, 50, 50), "OcclusionOpaque");
+    // Translucent elements on top don't affect what's below.
+    AddChild(&root, Rect(0, 0, 100, 100), "OcclusionTranslucent");
+    EL_VERIFY(PaintOccluded(&root) == 1);
+
+    cover->set_opacity(0.5f);
+    EL_VERIFY(PaintOccluded(&root) == 0);
+    cover->set_opacity(1.0f);
+
+    Element::set_occlusion_culling(false);
+    EL_VERIFY(PaintOccluded(&root) == 0);
+    Element::set_occlusion_culling(true);
+  }
+
+  EL_TEST(covered_by_several_siblings) {
+    Element root;
+    root.set_rect(Rect(0, 0, 100, 100));
+    AddChild(&root, Rect(10, 10, 60, 60), "OcclusionOpaque");
+    Element* left = AddChild(&root, Rect(0, 0, 40, 100), "OcclusionOpaque");
+    AddChild(&root, Rect(40, 0, 60, 100), "OcclusionOpaque");
+    EL_VERIFY(PaintOccluded(&root) == 1);
+
+    // A gap between the covering siblings leaves the element visible.
+    left->set_rect(Rect(0, 0, 39, 100));
+    EL_VERIFY(PaintOccluded(&root) == 0);
+  }
+
+  EL_TEST(translucent_cover_is_not_occluding) {
+    Element root;
+    root.set_rect(Rect(0, 0, 100, 100));
+    AddChild(&root, Rect(10, 10, 30, 30), "OcclusionOpaque");
+    AddChild(&root, Rect(0, 0, 100, 100), "OcclusionTranslucent");
+    EL_VERIFY(PaintOccluded(&root) == 0);
+  }
+
+  EL_TEST(layout_box_children_overlap_with_negative_spacing) {
+    elements::LayoutBox layout;
+    layout.set_rect(Rect(0, 0, 100, 100));
+    layout.AddChild(new Element());
+    layout.set_spacing(5);
+    layout.InvokeProcess();
+    EL_VERIFY(!layout.may_children_overlap());
+    layout.set_spacing(-5);
+    layout.InvokeProcess();
+    EL_VERIFY(layout.may_children_overlap());
+  }
+}
+
+#endif  // EL_UNIT_TESTING
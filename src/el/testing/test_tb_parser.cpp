@@ -7,7 +7,14 @@
  ******************************************************************************
  */
 
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
 #include "el/parsing/parse_node.h"
+#include "el/parsing/text_parser.h"
+#include "el/parsing/text_parser_stream.h"
 #include "el/testing/testing.h"
 
 #ifdef EL_UNIT_TESTING
@@ -15,6 +22,48 @@
 using namespace el;
 using namespace el::parsing;
 
+namespace {
+
+// Records everything parsed, to compare parsing of the same data.
+class RecordingTarget : public TextParserTarget {
+ public:
+  void OnError(int line_nr, const std::string& /*error*/) override {
+    log += std::to_string(line_nr) + " error\n";
+  }
+  void OnComment(int line_nr, const char* comment) override {
+    log += std::to_string(line_nr) + " #" + comment + "\n";
+  }
+  void OnToken(int line_nr, const char* name, Value* value) override {
+    log += std::to_string(line_nr) + " " + name + "=" + value->as_string() +
+           "\n";
+  }
+  void Enter() override { log += "{\n"; }
+  void Leave() override { log += "}\n"; }
+
+  std::string log;
+};
+
+// Streams data a few chars at a time, to parse lines split across reads.
+class TrickleTextParserStream : public TextParserStream {
+ public:
+  TrickleTextParserStream(const std::string& data, size_t chunk_size)
+      : m_data(data), m_chunk_size(chunk_size) {}
+  size_t GetMoreData(char* buf, size_t buf_len) override {
+    size_t len = std::min(std::min(buf_len, m_chunk_size),
+                          m_data.size() - m_pos);
+    std::memcpy(buf, m_data.data() + m_pos, len);
+    m_pos += len;
+    return len;
+  }
+
+ private:
+  std::string m_data;
+  size_t m_chunk_size;
+  size_t m_pos = 0;
+};
+
+}  // namespace
+
 EL_TEST_GROUP(tb_parser) {
   ParseNode node;
   EL_TEST(Init) {
@@ -231,4 +280,136 @@ EL_TEST_GROUP(tb_parser) {
   // More coverage in test_tb_node_ref_tree.cpp...
 }
 
+EL_TEST_GROUP(tb_parser_stream) {
+  EL_TEST(split_reads) {
+    std::string long_value(40000, 'x');
+    std::string data =
+        "\xEF\xBB\xBFroot\r\n"
+        "\tname: \"a b\", other: 42\r\n"
+        "# comment\n"
+        "\tlong " + long_value + "\n"
+        "\tmulti: \"line 1 \"\\\n"
+        "\t\t\"line 2\"\n"
+        "\tlast 5";
+    RecordingTarget expected;
+    DataTextParserStream data_stream;
+    EL_VERIFY(data_stream.Read(data.c_str(), data.size(), &expected));
+    EL_VERIFY(expected.log.find("1 root=\n") == 0);
+    EL_VERIFY(expected.log.find("long=" + long_value) != std::string::npos);
+    EL_VERIFY(expected.log.find("multi=line 1 line 2") != std::string::npos);
+    EL_VERIFY(expected.log.find("last=5") != std::string::npos);
+
+    for (size_t chunk_size : {1, 2, 3, 7, 64, 100000}) {
+      RecordingTarget target;
+      TrickleTextParserStream stream(data, chunk_size);
+      TextParser parser;
+      EL_VERIFY(parser.Read(&stream, &target) == TextParser::Status::kOk);
+      EL_VERIFY(target.log == expected.log);
+    }
+  }
+}
+
+EL_TEST_GROUP(tb_parser_binary) {
+  ParseNode node;
+  std::vector<uint8_t> binary;
+  EL_TEST(Init) {
+    ParseNode text_node;
+    EL_VERIFY(text_node.ReadFile(EL_TEST_FILE("data/test_tb_parser.tb.txt")));
+    text_node.WriteBinary(&binary);
+    EL_VERIFY(ParseNode::IsBinary(binary.data(), binary.size()));
+    EL_VERIFY(node.ReadBinary(binary.data(), binary.size()));
+  }
+
+  EL_TEST(values) {
+    EL_VERIFY_STR(node.GetValueString("strings>string5", ""), "Foo\nBar");
+    EL_VERIFY_STR(node.GetValueStringRaw("strings_compact>string12", ""),
+                  "@language_string_token");
+    EL_VERIFY(node.GetNode("numbers>integer1")->value().is_integer());
+    EL_VERIFY(node.GetValueInt("numbers>integer1", 0) == 42);
+    EL_VERIFY(node.GetNode("numbers>float1")->value().is_float());
+    EL_VERIFY(node.GetValueFloat("numbers>float1", 0) == 1.1f);
+    Value& array = node.GetNode("arrays>numbers")->value();
+    EL_VERIFY(array.is_array() && array.array_size() == 5);
+    EL_VERIFY(array.as_array()->at(2)->as_float() == .5f);
+    EL_VERIFY(array.as_array()->at(4)->as_integer() == 1000000000);
+    EL_VERIFY_STR(node.GetValueString("include_file>file1>something2", ""),
+                  "Cake");
+    EL_VERIFY_STR(node.GetValueString("defines_test>test2", ""), "#ffdd00");
+  }
+
+  EL_TEST(round_trip) {
+    std::vector<uint8_t> binary2;
+    node.WriteBinary(&binary2);
+    EL_VERIFY(binary2 == binary);
+
+    ParseNode data_node;
+    data_node.ReadData(reinterpret_cast<const char*>(binary.data()),
+                       binary.size(), ReadFlags::kArena);
+    EL_VERIFY(data_node.GetValueInt("numbers>integer1", 0) == 42);
+    EL_VERIFY_STR(data_node.GetValueString("strings>string1", ""),
+                  "A string");
+  }
+
+  EL_TEST(invalid) {
+    ParseNode invalid_node;
+    EL_VERIFY(!invalid_node.ReadBinary(binary.data(), 20));
+    std::vector<uint8_t> corrupt = binary;
+    corrupt[sizeof(uint32_t) * 6 + 12] = 0xff;  // First node's subtree end.
+    EL_VERIFY(!invalid_node.ReadBinary(corrupt.data(), corrupt.size()));
+  }
+
+  EL_TEST(too_deep) {
+    ParseNode deep_node;
+    ParseNode* parent = &deep_node;
+    for (int i = 0; i < 1000; ++i) {
+      ParseNode* child = ParseNode::Create("child");
+      parent->Add(child);
+      parent = child;
+    }
+    std::vector<uint8_t> deep_binary;
+    deep_node.WriteBinary(&deep_binary);
+    ParseNode invalid_node;
+    EL_VERIFY(!invalid_node.ReadBinary(deep_binary.data(),
+                                       deep_binary.size()));
+  }
+}
+
+EL_TEST_GROUP(tb_parser_arena) {
+  ParseNode node;
+  EL_TEST(Init) {
+    EL_VERIFY(node.ReadFile(EL_TEST_FILE("data/test_tb_parser.tb.txt"),
+                            ReadFlags::kArena));
+  }
+
+  EL_TEST(strings) {
+    EL_VERIFY_STR(node.GetValueString("strings>string1", ""), "A string");
+    EL_VERIFY_STR(node.GetValueString("strings>string5", ""), "Foo\nBar");
+    EL_VERIFY(node.GetValueInt("numbers>integer1", 0) == 42);
+  }
+
+  EL_TEST(include_file) {
+    EL_VERIFY_STR(node.GetValueString("include_file>file1>something1", ""),
+                  "Chocolate");
+    EL_VERIFY_STR(node.GetValueString("include_file>file2>something2", ""),
+                  "Cake");
+  }
+
+  EL_TEST(include_locally) {
+    EL_VERIFY_STR(node.GetValueString("include_branch>test1>skin", ""),
+                  "DarkSkin");
+    EL_VERIFY_STR(node.GetValueString("include_branch>test2>skin", ""),
+                  "LightSkin");
+  }
+
+  EL_TEST(delete_and_append) {
+    ParseNode* strings = node.GetNode("strings");
+    EL_VERIFY(strings);
+    node.Delete(strings);
+    EL_VERIFY(!node.GetNode("strings"));
+    node.ReadData("appended: 1", ReadFlags::kAppend | ReadFlags::kArena);
+    EL_VERIFY(node.GetValueInt("appended", 0) == 1);
+    EL_VERIFY(node.GetValueInt("numbers>integer1", 0) == 42);
+  }
+}
+
 #endif  // EL_UNIT_TESTING
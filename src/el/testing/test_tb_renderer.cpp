@@ -0,0 +1,144 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <memory>
+#include <vector>
+
+#include "el/graphics/renderer.h"
+#include "el/testing/testing.h"
+#include "el/util/counters.h"
+
+#ifdef EL_UNIT_TESTING
+
+using namespace el;
+using namespace el::graphics;
+using el::util::Counter;
+using el::util::Counters;
+
+namespace {
+
+class TestBitmap : public Bitmap {
+ public:
+  int width() override { return 64; }
+  int height() override { return 64; }
+  void set_data(uint32_t* /*data*/) override {}
+};
+
+// Records the vertices of all rendered batches.
+class RecordingRenderer : public Renderer {
+ public:
+  using Renderer::set_clip_rect;
+
+  std::unique_ptr<Bitmap> CreateBitmap(int /*width*/, int /*height*/,
+                                       uint32_t* /*data*/) override {
+    return std::make_unique<TestBitmap>();
+  }
+
+  struct Quad {
+    float left, top, right, bottom;
+    float u0, v0, u1, v1;
+  };
+  std::vector<Quad> quads;
+  int batch_count = 0;
+  int clip_rect_count = 0;
+
+ protected:
+  size_t max_vertex_batch_size() const override { return 6 * 64; }
+  void RenderBatch(Batch* batch) override {
+    ++batch_count;
+    for (size_t i = 0; i < batch->vertex_count; i += 6) {
+      // Vertex 2 is top left and vertex 1 is bottom right.
+      auto& tl = batch->vertices[i + 2];
+      auto& br = batch->vertices[i + 1];
+      quads.push_back({tl.x, tl.y, br.x, br.y, tl.u, tl.v, br.u, br.v});
+    }
+  }
+  void set_clip_rect(const Rect& /*rect*/) override { ++clip_rect_count; }
+  Vertex vertices_[6 * 64];
+
+ public:
+  RecordingRenderer() { batch_.vertices = vertices_; }
+};
+
+}  // namespace
+
+EL_TEST_GROUP(tb_renderer) {
+  EL_TEST(cpu_clipping) {
+    RecordingRenderer renderer;
+    TestBitmap bitmap;
+    renderer.BeginPaint(100, 100);
+    int clip_rect_count = renderer.clip_rect_count;
+
+    Rect old_clip = renderer.set_clip_rect(Rect(10, 10, 20, 20), true);
+    // Half outside to the left and top.
+    renderer.DrawBitmap(Rect(0, 0, 20, 20), Rect(0, 0, 64, 64), &bitmap);
+    // Entirely outside.
+    renderer.DrawBitmap(Rect(50, 50, 10, 10), Rect(0, 0, 64, 64), &bitmap);
+    renderer.set_clip_rect(old_clip, false);
+    // Horizontally flipped and unclipped.
+    renderer.DrawBitmap(Rect(40, 0, -20, 20), Rect(0, 0, 64, 64), &bitmap);
+    renderer.EndPaint();
+
+    // Clip changes neither flushed nor reached the implementation.
+    EL_VERIFY(renderer.batch_count == 1);
+    EL_VERIFY(renderer.clip_rect_count == clip_rect_count);
+    EL_VERIFY(renderer.quads.size() == 2);
+    auto& clipped = renderer.quads[0];
+    EL_VERIFY(clipped.left == 10 && clipped.top == 10);
+    EL_VERIFY(clipped.right == 20 && clipped.bottom == 20);
+    EL_VERIFY(clipped.u0 == 0.5f && clipped.v0 == 0.5f);
+    EL_VERIFY(clipped.u1 == 1.0f && clipped.v1 == 1.0f);
+    auto& flipped = renderer.quads[1];
+    EL_VERIFY(flipped.left == 40 && flipped.right == 20);
+    EL_VERIFY(flipped.u0 == 0.0f && flipped.u1 == 1.0f);
+  }
+
+  EL_TEST(implementation_clipping) {
+    RecordingRenderer renderer;
+    renderer.set_cpu_clipping(false);
+    renderer.BeginPaint(100, 100);
+    Rect old_clip = renderer.set_clip_rect(Rect(10, 10, 20, 20), true);
+    renderer.DrawRectFill(Rect(0, 0, 20, 20), Color(255, 255, 255));
+    renderer.set_clip_rect(old_clip, false);
+    renderer.DrawRectFill(Rect(0, 0, 20, 20), Color(255, 255, 255));
+    renderer.EndPaint();
+
+    // Unclipped quads, in one batch per clip rect.
+    EL_VERIFY(renderer.batch_count == 2);
+    EL_VERIFY(renderer.quads.size() == 2);
+    EL_VERIFY(renderer.quads[0].left == 0 && renderer.quads[0].right == 20);
+  }
+
+  EL_TEST(flush_counters) {
+    RecordingRenderer renderer;
+    TestBitmap bitmap_a;
+    TestBitmap bitmap_b;
+    renderer.BeginPaint(100, 100);
+    // Start a frame without counts from other tests.
+    Counters::get()->EndFrame();
+    renderer.DrawBitmap(Rect(0, 0, 10, 10), Rect(0, 0, 64, 64), &bitmap_a);
+    // The other bitmap flushes the first batch, and the 65th quad with it
+    // overflows the next.
+    for (int i = 0; i < 70; ++i) {
+      renderer.DrawBitmap(Rect(0, 0, 10, 10), Rect(0, 0, 64, 64), &bitmap_b);
+    }
+    renderer.EndPaint();
+
+    auto counters = Counters::get();
+    EL_VERIFY(counters->frame_value(Counter::kBatchFlushBitmapChange) == 1);
+    EL_VERIFY(counters->frame_value(Counter::kBatchFlushBufferFull) == 1);
+    EL_VERIFY(counters->frame_value(Counter::kBatchFlushClipChange) == 0);
+    EL_VERIFY(counters->frame_value(Counter::kDrawCalls) == 3);
+    EL_VERIFY(counters->frame_value(Counter::kVertices) == 71 * 6);
+    EL_VERIFY(counters->current_value(Counter::kDrawCalls) == 0);
+    EL_VERIFY(counters->total_value(Counter::kDrawCalls) >= 3);
+  }
+}
+
+#endif  // EL_UNIT_TESTING
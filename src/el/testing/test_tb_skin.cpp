@@ -0,0 +1,94 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "el/io/file_manager.h"
+#include "el/io/memory_file_system.h"
+#include "el/skin.h"
+#include "el/testing/testing.h"
+
+#ifdef EL_UNIT_TESTING
+
+using namespace el;
+
+namespace {
+
+const char kLazySkin[] =
+    "elements\n"
+    "\tLazyA\n"
+    "\t\tbitmap a.tga\n"
+    "\tLazyB\n"
+    "\t\tbitmap b.tga\n"
+    "\tLazyC\n"
+    "\t\tclone LazyB\n";
+
+// Builds an uncompressed 32 bit TGA image of the given size.
+std::vector<uint8_t> MakeTga(int width, int height) {
+  std::vector<uint8_t> data(18 + width * height * 4, 0xff);
+  std::memset(data.data(), 0, 18);
+  data[2] = 2;  // Uncompressed true color.
+  data[12] = uint8_t(width);
+  data[14] = uint8_t(height);
+  data[16] = 32;
+  data[17] = 0x28;  // Top-left origin, 8 alpha bits.
+  return data;
+}
+
+}  // namespace
+
+EL_TEST_GROUP(tb_skin) {
+  EL_TEST(lazy_loading_and_eviction) {
+    static std::vector<uint8_t> bitmap_a = MakeTga(8, 8);
+    static std::vector<uint8_t> bitmap_b = MakeTga(8, 4);
+    auto file_system = std::make_unique<io::MemoryFileSystem>();
+    file_system->AddFile("test_lazy_skin/skin.tb.txt", kLazySkin,
+                         strlen(kLazySkin));
+    file_system->AddFile("test_lazy_skin/a.tga", bitmap_a.data(),
+                         bitmap_a.size());
+    file_system->AddFile("test_lazy_skin/b.tga", bitmap_b.data(),
+                         bitmap_b.size());
+    io::FileManager::RegisterFileSystem(std::move(file_system));
+
+    Skin skin;
+    skin.set_lazy_bitmap_loading(true);
+    EL_VERIFY(skin.Load("test_lazy_skin/skin.tb.txt"));
+    EL_VERIFY(skin.residency_stats().resident_count == 0);
+    SkinElement* a = skin.GetSkinElementById(TBIDC("LazyA"));
+    SkinElement* b = skin.GetSkinElementById(TBIDC("LazyB"));
+    SkinElement* c = skin.GetSkinElementById(TBIDC("LazyC"));
+
+    // Measuring only reads the size, without loading the bitmap.
+    a->LoadBitmapSize();
+    EL_VERIFY(!a->bitmap && a->intrinsic_width() == 8);
+    EL_VERIFY(skin.residency_stats().resident_count == 0);
+    EL_VERIFY(skin.GetElementBitmap(a));
+    EL_VERIFY(skin.residency_stats().resident_count == 1);
+
+    // Only room for one bitmap, so loading b evicts a.
+    skin.set_bitmap_memory_budget(8 * 8 * 4);
+    EL_VERIFY(skin.GetElementBitmap(b));
+    EL_VERIFY(!a->bitmap);
+    EL_VERIFY(skin.residency_stats().eviction_count == 1);
+    // The size is remembered while evicted.
+    EL_VERIFY(a->intrinsic_height() == 8);
+
+    // c shares the fragment of b, so both are unset when it's evicted.
+    EL_VERIFY(skin.GetElementBitmap(c) == b->bitmap);
+    EL_VERIFY(skin.residency_stats().resident_count == 1);
+    EL_VERIFY(skin.GetElementBitmap(a));
+    EL_VERIFY(!b->bitmap && !c->bitmap);
+    EL_VERIFY(skin.residency_stats().eviction_count == 2);
+    EL_VERIFY(skin.residency_stats().load_count == 3);
+  }
+}
+
+#endif  // EL_UNIT_TESTING
@@ -0,0 +1,187 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <memory>
+#include <vector>
+
+#include "el/graphics/software_renderer.h"
+#include "el/testing/testing.h"
+
+#ifdef EL_UNIT_TESTING
+
+using namespace el;
+using namespace el::graphics;
+
+namespace {
+
+// Bitmap data is in the byte order of the GL renderers (red in the lowest
+// byte).
+uint32_t Rgba(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+  return r | (g << 8) | (b << 16) | (uint32_t(a) << 24);
+}
+
+// Framebuffer pixels are BGRA (blue in the lowest byte).
+uint32_t Bgra(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+  return b | (g << 8) | (r << 16) | (uint32_t(a) << 24);
+}
+
+uint32_t PixelAt(SoftwareRenderer* renderer, int x, int y) {
+  return renderer->pixels()[x + y * renderer->width()];
+}
+
+// Draws a mix of opaque, translucent, stretched, tiled and clipped quads, and
+// a translucent render target.
+void DrawScene(SoftwareRenderer* renderer, Bitmap* bitmap, Bitmap* target) {
+  renderer->BeginPaint(67, 45);
+  renderer->Clear(Color(10, 20, 30));
+  renderer->DrawRectFill(Rect(1, 1, 60, 40), Color(200, 100, 50));
+  renderer->DrawRectFill(Rect(5, 3, 37, 29), Color(20, 220, 90, 77));
+  renderer->DrawBitmap(Rect(3, 2, 16, 16), Rect(0, 0, 16, 16), bitmap);
+  renderer->DrawBitmap(Rect(20, 4, 41, -23), Rect(3, 1, 9, 13), bitmap);
+  renderer->DrawBitmapColored(Rect(2, 20, 50, 21), Rect(0, 0, 16, 16),
+                              Color(255, 128, 0, 200), bitmap);
+  Rect old_clip = renderer->set_clip_rect(Rect(10, 10, 30, 25), true);
+  renderer->DrawBitmapTile(Rect(0, 0, 67, 45), bitmap);
+  renderer->set_clip_rect(old_clip, false);
+  renderer->BeginRenderTarget(target);
+  renderer->DrawRectFill(Rect(2, 2, 20, 20), Color(90, 200, 10, 160));
+  renderer->DrawBitmap(Rect(0, 0, 16, 16), Rect(0, 0, 16, 16), bitmap);
+  renderer->EndRenderTarget();
+  renderer->set_opacity(0.6f);
+  renderer->DrawRenderTarget(Rect(30, 10, 37, 30), Rect(0, 0, 31, 29),
+                             target);
+  renderer->set_opacity(1.0f);
+  renderer->EndPaint();
+}
+
+}  // namespace
+
+EL_TEST_GROUP(tb_software_renderer) {
+  EL_TEST(fill_and_blend) {
+    auto renderer = std::make_unique<SoftwareRenderer>();
+    renderer->BeginPaint(16, 16);
+    renderer->Clear(Color(0, 0, 0));
+    renderer->DrawRectFill(Rect(2, 2, 4, 4), Color(255, 0, 0));
+    renderer->DrawRectFill(Rect(4, 4, 4, 4), Color(0, 0, 255, 128));
+    renderer->EndPaint();
+
+    EL_VERIFY(PixelAt(renderer.get(), 1, 1) == Bgra(0, 0, 0, 255));
+    EL_VERIFY(PixelAt(renderer.get(), 2, 2) == Bgra(255, 0, 0, 255));
+    EL_VERIFY(PixelAt(renderer.get(), 6, 2) == Bgra(0, 0, 0, 255));
+    // Blended like glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA) on all
+    // channels.
+    EL_VERIFY(PixelAt(renderer.get(), 4, 4) == Bgra(127, 0, 128, 191));
+    EL_VERIFY(PixelAt(renderer.get(), 7, 7) == Bgra(0, 0, 128, 191));
+  }
+
+  EL_TEST(bitmap_sampling) {
+    auto renderer = std::make_unique<SoftwareRenderer>();
+    std::vector<uint32_t> data(4 * 4);
+    for (int i = 0; i < 16; ++i) {
+      data[i] = Rgba(uint8_t(i * 16), 0, 0, 255);
+    }
+    auto bitmap = renderer->CreateBitmap(4, 4, data.data());
+    renderer->BeginPaint(16, 16);
+    renderer->Clear(Color(0, 0, 0));
+    // Stretched twice as large.
+    renderer->DrawBitmap(Rect(0, 0, 8, 8), Rect(0, 0, 4, 4), bitmap.get());
+    // Flipped horizontally.
+    renderer->DrawBitmap(Rect(12, 8, -4, 4), Rect(0, 0, 4, 4), bitmap.get());
+    renderer->EndPaint();
+
+    EL_VERIFY(PixelAt(renderer.get(), 0, 0) == Bgra(0, 0, 0, 255));
+    EL_VERIFY(PixelAt(renderer.get(), 3, 1) == Bgra(16, 0, 0, 255));
+    EL_VERIFY(PixelAt(renderer.get(), 7, 7) == Bgra(240, 0, 0, 255));
+    EL_VERIFY(PixelAt(renderer.get(), 8, 8) == Bgra(48, 0, 0, 255));
+    EL_VERIFY(PixelAt(renderer.get(), 11, 8) == Bgra(0, 0, 0, 255));
+
+    // New data is used by the following frames.
+    data[0] = Rgba(0, 255, 0, 255);
+    bitmap->set_data(data.data());
+    renderer->BeginPaint(16, 16);
+    renderer->DrawBitmap(Rect(0, 0, 4, 4), Rect(0, 0, 4, 4), bitmap.get());
+    renderer->EndPaint();
+    EL_VERIFY(PixelAt(renderer.get(), 0, 0) == Bgra(0, 255, 0, 255));
+  }
+
+  EL_TEST(clipping) {
+    auto renderer = std::make_unique<SoftwareRenderer>();
+    for (bool cpu_clipping : {true, false}) {
+      renderer->set_cpu_clipping(cpu_clipping);
+      renderer->BeginPaint(16, 16);
+      renderer->Clear(Color(0, 0, 0));
+      Rect old_clip = renderer->set_clip_rect(Rect(4, 4, 4, 4), true);
+      renderer->DrawRectFill(Rect(0, 0, 16, 16), Color(255, 255, 255));
+      renderer->set_clip_rect(old_clip, false);
+      renderer->EndPaint();
+      EL_VERIFY(PixelAt(renderer.get(), 3, 4) == Bgra(0, 0, 0, 255));
+      EL_VERIFY(PixelAt(renderer.get(), 4, 4) == Bgra(255, 255, 255, 255));
+      EL_VERIFY(PixelAt(renderer.get(), 7, 7) == Bgra(255, 255, 255, 255));
+      EL_VERIFY(PixelAt(renderer.get(), 8, 7) == Bgra(0, 0, 0, 255));
+    }
+  }
+
+  EL_TEST(render_target) {
+    auto renderer = std::make_unique<SoftwareRenderer>();
+    auto target = renderer->CreateRenderTarget(10, 10);
+    EL_VERIFY(target && target->width() == 16 && target->height() == 16);
+
+    renderer->BeginPaint(16, 16);
+    renderer->Clear(Color(0, 0, 0));
+    renderer->BeginRenderTarget(target.get());
+    renderer->DrawRectFill(Rect(0, 0, 4, 4), Color(255, 0, 0));
+    renderer->DrawRectFill(Rect(2, 0, 4, 4), Color(0, 0, 255));
+    renderer->DrawRectFill(Rect(0, 4, 4, 4), Color(0, 255, 0, 128));
+    renderer->EndRenderTarget();
+    renderer->set_opacity(0.5f);
+    renderer->DrawRenderTarget(Rect(0, 0, 16, 16), Rect(0, 0, 16, 16),
+                               target.get());
+    renderer->set_opacity(1.0f);
+    renderer->EndPaint();
+
+    // The opacity applies to the target as a whole, so the red below the
+    // blue doesn't show through.
+    EL_VERIFY(PixelAt(renderer.get(), 0, 0) == Bgra(127, 0, 0, 255));
+    EL_VERIFY(PixelAt(renderer.get(), 3, 0) == Bgra(0, 0, 127, 255));
+    // Translucent content blends like it was drawn directly.
+    EL_VERIFY(PixelAt(renderer.get(), 0, 4) == Bgra(0, 64, 0, 255));
+    EL_VERIFY(PixelAt(renderer.get(), 8, 8) == Bgra(0, 0, 0, 255));
+  }
+
+  EL_TEST(simd_levels_and_threads_match) {
+    auto renderer = std::make_unique<SoftwareRenderer>();
+    std::vector<uint32_t> data(16 * 16);
+    uint32_t seed = 1;
+    for (auto& texel : data) {
+      seed = seed * 1664525 + 1013904223;
+      texel = seed;
+    }
+    auto bitmap = renderer->CreateBitmap(16, 16, data.data());
+    auto target = renderer->CreateRenderTarget(31, 29);
+
+    renderer->set_simd_level(SoftwareRenderer::SimdLevel::kScalar);
+    DrawScene(renderer.get(), bitmap.get(), target.get());
+    std::vector<uint32_t> expected(
+        renderer->pixels(),
+        renderer->pixels() + renderer->width() * renderer->height());
+
+    for (auto level : {SoftwareRenderer::SimdLevel::kSse2,
+                       SoftwareRenderer::SimdLevel::kAvx2}) {
+      renderer->set_simd_level(level);
+      for (int thread_count : {1, 3}) {
+        renderer->set_thread_count(thread_count);
+        DrawScene(renderer.get(), bitmap.get(), target.get());
+        EL_VERIFY(std::equal(expected.begin(), expected.end(),
+                             renderer->pixels()));
+      }
+    }
+  }
+}
+
+#endif  // EL_UNIT_TESTING
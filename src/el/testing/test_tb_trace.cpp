@@ -0,0 +1,79 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <string>
+#include <vector>
+
+#include "el/testing/testing.h"
+#include "el/util/trace.h"
+
+#ifdef EL_UNIT_TESTING
+
+using namespace el;
+using el::util::Tracer;
+
+EL_TEST_GROUP(tb_trace) {
+  EL_TEST(record_only_while_started) {
+    Tracer tracer;
+    tracer.Record("before", 1000, 2000);
+    EL_VERIFY(tracer.recorded_count() == 0);
+    tracer.Start(16);
+    tracer.Record("zone", 1000, 3500);
+    tracer.Stop();
+    tracer.Record("after", 4000, 5000);
+    EL_VERIFY(tracer.recorded_count() == 1);
+
+    std::vector<Tracer::Event> events;
+    tracer.ForEachEvent(
+        [&events](const Tracer::Event& event) { events.push_back(event); });
+    EL_VERIFY(events.size() == 1);
+    EL_VERIFY(std::string(events[0].name) == "zone");
+    EL_VERIFY(events[0].begin_ns == 1000);
+    EL_VERIFY(events[0].duration_ns == 2500);
+  }
+
+  EL_TEST(ring_keeps_newest) {
+    Tracer tracer;
+    tracer.Start(4);
+    for (uint64_t i = 0; i < 10; ++i) {
+      tracer.Record("zone", i, i + 1);
+    }
+    EL_VERIFY(tracer.recorded_count() == 10);
+    std::vector<uint64_t> begins;
+    tracer.ForEachEvent([&begins](const Tracer::Event& event) {
+      begins.push_back(event.begin_ns);
+    });
+    EL_VERIFY(begins.size() == 4);
+    EL_VERIFY(begins.front() == 6 && begins.back() == 9);
+
+    // Restarting drops the events.
+    tracer.Start();
+    begins.clear();
+    tracer.ForEachEvent([&begins](const Tracer::Event& event) {
+      begins.push_back(event.begin_ns);
+    });
+    EL_VERIFY(begins.empty());
+  }
+
+  EL_TEST(chrome_trace) {
+    Tracer tracer;
+    tracer.Start(16);
+    tracer.Record("Element::InvokePaint", 1234567, 1240000);
+    std::string json;
+    tracer.WriteChromeTrace(&json);
+    EL_VERIFY(json.find("\"traceEvents\"") != std::string::npos);
+    EL_VERIFY(json.find("\"name\":\"Element::InvokePaint\"") !=
+              std::string::npos);
+    EL_VERIFY(json.find("\"ph\":\"X\"") != std::string::npos);
+    EL_VERIFY(json.find("\"ts\":1234.567") != std::string::npos);
+    EL_VERIFY(json.find("\"dur\":5.433") != std::string::npos);
+  }
+}
+
+#endif  // EL_UNIT_TESTING
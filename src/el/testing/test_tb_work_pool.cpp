@@ -0,0 +1,137 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "el/elements/button.h"
+#include "el/elements/label.h"
+#include "el/elements/layout_box.h"
+#include "el/elements/text_box.h"
+#include "el/testing/testing.h"
+#include "el/util/work_pool.h"
+
+#ifdef EL_UNIT_TESTING
+
+using namespace el;
+using namespace el::elements;
+using el::util::WorkPool;
+
+namespace {
+
+// Builds rows of labels and buttons with text of varying length, and a text
+// box that has to be measured serially.
+void BuildRows(LayoutBox* root) {
+  root->set_axis(Axis::kY);
+  for (int i = 0; i < 24; ++i) {
+    LayoutBox* row = new LayoutBox();
+    Label* label = new Label();
+    label->set_text(std::string(1 + i % 7, 'x'));
+    row->AddChild(label);
+    for (int j = 0; j < i % 4; ++j) {
+      Button* button = new Button();
+      button->set_text(std::string(3 + j * i % 5, 'y'));
+      row->AddChild(button);
+    }
+    if (i == 5) {
+      TextBox* text_box = new TextBox();
+      text_box->set_text("text");
+      row->AddChild(text_box);
+    }
+    root->AddChild(row);
+  }
+}
+
+}  // namespace
+
+EL_TEST_GROUP(tb_work_pool) {
+  EL_TEST(parallel_for_runs_each_index_once) {
+    // More threads than cores, so the ranges are interleaved and stolen.
+    WorkPool pool(8);
+    const size_t count = 1000;
+    std::unique_ptr<std::atomic<int>[]> runs(new std::atomic<int>[count]);
+    for (size_t i = 0; i < count; ++i) {
+      runs[i] = 0;
+    }
+    std::atomic<bool> all_parallel(true);
+    pool.ParallelFor(count, [&](size_t index) {
+      if (!WorkPool::is_running_parallel()) {
+        all_parallel = false;
+      }
+      // Uneven work, so threads finishing early have to steal.
+      volatile int sum = 0;
+      for (size_t i = 0; i < (index % 64) * 100; ++i) {
+        sum += int(i);
+      }
+      runs[index]++;
+    });
+    for (size_t i = 0; i < count; ++i) {
+      EL_VERIFY(runs[i] == 1);
+    }
+    EL_VERIFY(all_parallel);
+    EL_VERIFY(!WorkPool::is_running_parallel());
+  }
+
+  EL_TEST(nested_parallel_for_is_serial) {
+    WorkPool pool(4);
+    std::atomic<int> total(0);
+    pool.ParallelFor(16, [&](size_t) {
+      pool.ParallelFor(4, [&](size_t) { total++; });
+    });
+    EL_VERIFY(total == 64);
+  }
+
+  EL_TEST(subtree_measure_thread_safe_is_updated) {
+    Element root;
+    Element* child = new Element();
+    root.AddChild(child);
+    EL_VERIFY(root.IsSubtreeMeasureThreadSafe());
+
+    TextBox* text_box = new TextBox();
+    child->AddChild(text_box);
+    EL_VERIFY(!root.IsSubtreeMeasureThreadSafe());
+    EL_VERIFY(!child->IsSubtreeMeasureThreadSafe());
+
+    child->RemoveChild(text_box);
+    delete text_box;
+    EL_VERIFY(root.IsSubtreeMeasureThreadSafe());
+  }
+
+  EL_TEST(parallel_layout_matches_serial) {
+    LayoutBox serial_root;
+    BuildRows(&serial_root);
+    PreferredSize serial_ps = serial_root.GetPreferredSize();
+    serial_root.set_rect({0, 0, serial_ps.pref_w, serial_ps.pref_h});
+
+    WorkPool pool(4);
+    LayoutBox::set_parallel_measure_pool(&pool);
+    LayoutBox parallel_root;
+    BuildRows(&parallel_root);
+    PreferredSize parallel_ps = parallel_root.GetPreferredSize();
+    parallel_root.set_rect({0, 0, parallel_ps.pref_w, parallel_ps.pref_h});
+    LayoutBox::set_parallel_measure_pool(nullptr);
+
+    EL_VERIFY(parallel_ps.pref_w == serial_ps.pref_w);
+    EL_VERIFY(parallel_ps.pref_h == serial_ps.pref_h);
+    EL_VERIFY(parallel_ps.min_w == serial_ps.min_w);
+    EL_VERIFY(parallel_ps.max_h == serial_ps.max_h);
+    Element* serial = serial_root.GetNextDeep(&serial_root);
+    Element* parallel = parallel_root.GetNextDeep(&parallel_root);
+    while (serial && parallel) {
+      EL_VERIFY(serial->rect().equals(parallel->rect()));
+      serial = serial->GetNextDeep(&serial_root);
+      parallel = parallel->GetNextDeep(&parallel_root);
+    }
+    EL_VERIFY(!serial && !parallel);
+  }
+}
+
+#endif  // EL_UNIT_TESTING
@@ -18,19 +18,36 @@
 // Reference at least one group in each test file, to force
 // linking the object file. This is needed if TB is compiled
 // as an library.
+EL_FORCE_LINK_TEST_GROUP(tb_animation);
 EL_FORCE_LINK_TEST_GROUP(tb_color);
 EL_FORCE_LINK_TEST_GROUP(tb_dimension_converter);
+EL_FORCE_LINK_TEST_GROUP(tb_distance_field);
+EL_FORCE_LINK_TEST_GROUP(tb_element_delete_queue);
+EL_FORCE_LINK_TEST_GROUP(tb_element_pool);
+EL_FORCE_LINK_TEST_GROUP(tb_element_state);
+EL_FORCE_LINK_TEST_GROUP(tb_element_template);
+EL_FORCE_LINK_TEST_GROUP(tb_file_system);
+EL_FORCE_LINK_TEST_GROUP(tb_font_glyph_cache);
+EL_FORCE_LINK_TEST_GROUP(tb_frame_scheduler);
 EL_FORCE_LINK_TEST_GROUP(tb_geometry);
+EL_FORCE_LINK_TEST_GROUP(tb_id_map);
+EL_FORCE_LINK_TEST_GROUP(tb_layer);
 EL_FORCE_LINK_TEST_GROUP(tb_linklist);
 EL_FORCE_LINK_TEST_GROUP(tb_node_ref_tree);
 EL_FORCE_LINK_TEST_GROUP(tb_object);
+EL_FORCE_LINK_TEST_GROUP(tb_occlusion);
 EL_FORCE_LINK_TEST_GROUP(tb_parser);
+EL_FORCE_LINK_TEST_GROUP(tb_renderer);
+EL_FORCE_LINK_TEST_GROUP(tb_skin);
+EL_FORCE_LINK_TEST_GROUP(tb_software_renderer);
 EL_FORCE_LINK_TEST_GROUP(tb_space_allocator);
 EL_FORCE_LINK_TEST_GROUP(tb_text_box);
 EL_FORCE_LINK_TEST_GROUP(tb_string_builder);
 EL_FORCE_LINK_TEST_GROUP(tb_test);
+EL_FORCE_LINK_TEST_GROUP(tb_trace);
 EL_FORCE_LINK_TEST_GROUP(tb_value);
 EL_FORCE_LINK_TEST_GROUP(tb_widget_value_text);
+EL_FORCE_LINK_TEST_GROUP(tb_work_pool);
 #endif
 
 namespace el {
@@ -110,7 +127,7 @@ int TBRunTests(uint32_t settings) {
   TBDebugOut("Running tests...\n");
 
   el::io::FileManager::RegisterFileSystem(
-      std::make_unique<el::io::PosixFileSystem>("."));
+      std::make_unique<el::io::PosixFileSystem>(".", true));
 
   for (TBTestGroup* group = g_test_groups; group;
        group = group->next_test_group) {
@@ -0,0 +1,145 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "el/text/distance_field.h"
+
+namespace el {
+namespace text {
+
+namespace {
+
+// Offset to the nearest seed pixel, used by the 8SSEDT distance transform.
+struct Offset {
+  int dx;
+  int dy;
+  int distance_squared() const { return dx * dx + dy * dy; }
+};
+
+constexpr int kFarAway = 1 << 14;
+
+class DistanceGrid {
+ public:
+  DistanceGrid(int w, int h) : m_w(w), m_h(h), m_cells(w * h) {}
+
+  void set(int x, int y, bool seed) {
+    m_cells[x + y * m_w] = seed ? Offset{0, 0} : Offset{kFarAway, kFarAway};
+  }
+  float distance(int x, int y) const {
+    return std::sqrt(float(m_cells[x + y * m_w].distance_squared()));
+  }
+
+  // Propagates the nearest seed offsets over the grid in two passes (eight
+  // point sequential euclidean distance transform).
+  void Propagate() {
+    for (int y = 0; y < m_h; ++y) {
+      for (int x = 0; x < m_w; ++x) {
+        Compare(x, y, -1, 0);
+        Compare(x, y, 0, -1);
+        Compare(x, y, -1, -1);
+        Compare(x, y, 1, -1);
+      }
+      for (int x = m_w - 1; x >= 0; --x) {
+        Compare(x, y, 1, 0);
+      }
+    }
+    for (int y = m_h - 1; y >= 0; --y) {
+      for (int x = m_w - 1; x >= 0; --x) {
+        Compare(x, y, 1, 0);
+        Compare(x, y, 0, 1);
+        Compare(x, y, -1, 1);
+        Compare(x, y, 1, 1);
+      }
+      for (int x = 0; x < m_w; ++x) {
+        Compare(x, y, -1, 0);
+      }
+    }
+  }
+
+ private:
+  void Compare(int x, int y, int ox, int oy) {
+    int nx = x + ox;
+    int ny = y + oy;
+    if (nx < 0 || ny < 0 || nx >= m_w || ny >= m_h) {
+      return;
+    }
+    Offset other = m_cells[nx + ny * m_w];
+    other.dx += ox;
+    other.dy += oy;
+    Offset& cell = m_cells[x + y * m_w];
+    if (other.distance_squared() < cell.distance_squared()) {
+      cell = other;
+    }
+  }
+
+  int m_w;
+  int m_h;
+  std::vector<Offset> m_cells;
+};
+
+}  // namespace
+
+bool GenerateDistanceField(const uint8_t* coverage, int w, int h, int stride,
+                           int downscale, int spread,
+                           std::vector<uint8_t>* out_data, int* out_w,
+                           int* out_h) {
+  if (w <= 0 || h <= 0 || downscale <= 0) {
+    return false;
+  }
+  // Work on a grid padded to a multiple of downscale, with room for the
+  // spread on all sides.
+  const int padding = spread * downscale;
+  const int dst_w = (w + downscale - 1) / downscale + spread * 2;
+  const int dst_h = (h + downscale - 1) / downscale + spread * 2;
+  const int grid_w = dst_w * downscale;
+  const int grid_h = dst_h * downscale;
+
+  // inside_dist holds the distance from outside pixels to the outline, and
+  // outside_dist the distance from inside pixels.
+  DistanceGrid inside_dist(grid_w, grid_h);
+  DistanceGrid outside_dist(grid_w, grid_h);
+  for (int y = 0; y < grid_h; ++y) {
+    int sy = y - padding;
+    for (int x = 0; x < grid_w; ++x) {
+      int sx = x - padding;
+      bool inside = sx >= 0 && sy >= 0 && sx < w && sy < h &&
+                    coverage[sx + sy * stride] >= 128;
+      inside_dist.set(x, y, inside);
+      outside_dist.set(x, y, !inside);
+    }
+  }
+  inside_dist.Propagate();
+  outside_dist.Propagate();
+
+  // Average the signed distance over each block of downscale * downscale
+  // pixels, and map it to 0-255 over the spread.
+  out_data->resize(dst_w * dst_h);
+  const float scale = 127.f / (float(padding) * downscale * downscale);
+  for (int dy = 0; dy < dst_h; ++dy) {
+    for (int dx = 0; dx < dst_w; ++dx) {
+      float sum = 0;
+      for (int y = dy * downscale; y < (dy + 1) * downscale; ++y) {
+        for (int x = dx * downscale; x < (dx + 1) * downscale; ++x) {
+          sum += outside_dist.distance(x, y) - inside_dist.distance(x, y);
+        }
+      }
+      float value = 128.f + sum * scale;
+      (*out_data)[dx + dy * dst_w] =
+          uint8_t(std::min(std::max(value, 0.f), 255.f));
+    }
+  }
+  *out_w = dst_w;
+  *out_h = dst_h;
+  return true;
+}
+
+}  // namespace text
+}  // namespace el
@@ -0,0 +1,37 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#ifndef EL_TEXT_DISTANCE_FIELD_H_
+#define EL_TEXT_DISTANCE_FIELD_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace el {
+namespace text {
+
+// Generates a signed distance field from an 8 bit coverage bitmap (such as a
+// glyph rendered by a FontRenderer).
+// The coverage is thresholded at 50% and the exact distance to the outline is
+// computed at the input resolution, then averaged down by downscale. The
+// result is padded with spread pixels on each side so the field has room to
+// fall off outside the outline.
+// Output values are 128 on the outline, increasing towards 255 inside and
+// decreasing towards 0 outside, reaching the extremes spread output pixels
+// away from the outline.
+// Returns false if the input is empty.
+bool GenerateDistanceField(const uint8_t* coverage, int w, int h, int stride,
+                           int downscale, int spread,
+                           std::vector<uint8_t>* out_data, int* out_w,
+                           int* out_h);
+
+}  // namespace text
+}  // namespace el
+
+#endif  // EL_TEXT_DISTANCE_FIELD_H_
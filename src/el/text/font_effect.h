@@ -26,6 +26,7 @@ class FontEffect {
 
   // Sets blur radius. 0 means no blur.
   void SetBlurRadius(int blur_radius);
+  int blur_radius() const { return m_blur_radius; }
 
   // Returns true if the result is in RGB and should not be painted using the
   // color parameter given to DrawString. In other words: It's a color glyph.
@@ -10,11 +10,16 @@
 #include <cmath>
 #include <cstring>
 #include <memory>
+#include <vector>
 
+#include "el/text/distance_field.h"
 #include "el/text/font_face.h"
 #include "el/text/font_manager.h"
 #include "el/text/font_renderer.h"
 #include "el/text/utf8.h"
+#include "el/util/counters.h"
+#include "el/util/trace.h"
+#include "el/util/work_pool.h"
 
 namespace el {
 namespace text {
@@ -22,6 +27,10 @@ namespace text {
 using graphics::Renderer;
 using UCS4 = el::text::utf8::UCS4;
 
+// Mixed into the glyph hash of distance field faces, so their glyphs don't
+// collide with a regular face of the same size.
+constexpr uint32_t kDistanceFieldHashSalt = 0x5DF0F1E1;
+
 FontGlyph::FontGlyph(const TBID& hash_id, UCS4 cp) : hash_id(hash_id), cp(cp) {}
 
 FontFace::FontFace(FontGlyphCache* glyph_cache,
@@ -91,6 +100,11 @@ FontGlyph* FontFace::CreateAndCacheGlyph(UCS4 cp) {
 
 void FontFace::RenderGlyph(FontGlyph* glyph) {
   assert(!glyph->frag);
+  EL_TRACE_ZONE("FontFace::RenderGlyph");
+  if (m_is_distance_field_source) {
+    RenderDistanceFieldGlyph(glyph);
+    return;
+  }
   FontGlyphData glyph_data;
   if (m_font_renderer->RenderGlyph(&glyph_data, glyph->cp)) {
     FontGlyphData* effect_glyph_data =
@@ -136,17 +150,92 @@ void FontFace::RenderGlyph(FontGlyph* glyph) {
 #endif  // EL_RUNTIME_DEBUG_INFO
 }
 
+void FontFace::RenderDistanceFieldGlyph(FontGlyph* glyph) {
+  FontGlyphData glyph_data;
+  if (!m_font_renderer->RenderGlyph(&glyph_data, glyph->cp) ||
+      !glyph_data.data8) {
+    // Color glyphs can't be drawn as distance fields. Faces using this one
+    // will render them at their own size instead.
+    return;
+  }
+  std::vector<uint8_t> field;
+  int w = 0;
+  int h = 0;
+  if (!GenerateDistanceField(glyph_data.data8, glyph_data.w, glyph_data.h,
+                             glyph_data.stride, kDistanceFieldDownscale,
+                             kDistanceFieldSpread, &field, &w, &h)) {
+    return;
+  }
+  m_temp_buffer.Reserve(w * h * sizeof(uint32_t));
+  uint32_t* data32 = reinterpret_cast<uint32_t*>(m_temp_buffer.data());
+  for (int i = 0; i < w * h; i++) {
+    data32[i] = Color(255, 255, 255, field[i]);
+  }
+  m_glyph_cache->CreateFragment(glyph, w, h, w, data32);
+}
+
+void FontFace::DrawDistanceFieldGlyph(int x, int y, const Color& color,
+                                      FontGlyph* field_glyph) {
+  // The field glyph metrics are in the render size of the distance field
+  // face, and the field bitmap is downscaled and padded by the spread.
+  const float scale =
+      float(m_font_desc.size()) / m_distance_field_face->m_font_desc.size();
+  const float padding = float(kDistanceFieldSpread * kDistanceFieldDownscale);
+  const float bitmap_scale = scale * kDistanceFieldDownscale;
+  Rect dst_rect(
+      x + int(std::floor((field_glyph->metrics.x - padding) * scale + 0.5f)),
+      y + ascent() +
+          int(std::floor((field_glyph->metrics.y - padding) * scale + 0.5f)),
+      int(std::ceil(field_glyph->frag->width() * bitmap_scale)),
+      int(std::ceil(field_glyph->frag->height() * bitmap_scale)));
+  Rect src_rect(0, 0, field_glyph->frag->width(), field_glyph->frag->height());
+  Renderer::get()->DrawBitmapDistanceField(dst_rect, src_rect, color,
+                                           field_glyph->frag);
+}
+
 TBID FontFace::GetHashId(UCS4 cp) const {
+  if (m_is_distance_field_source) {
+    return (cp * 31 + m_font_desc.font_face_id()) ^ kDistanceFieldHashSalt;
+  }
   return cp * 31 + m_font_desc.font_face_id();
 }
 
 FontGlyph* FontFace::GetGlyph(UCS4 cp, bool render_if_needed) {
+  // Fast path for the common case: no hashing, and marking the glyph as used
+  // for the eviction clock is a single store.
+  if (cp < kDirectGlyphCount) {
+    FontGlyph* glyph = m_direct_glyphs[cp].load(std::memory_order_acquire);
+    if (glyph && (!render_if_needed || glyph->frag)) {
+      if (render_if_needed) {
+        glyph->referenced = true;
+        util::Counters::Add(util::Counter::kGlyphCacheHits);
+      }
+      return glyph;
+    }
+  }
+  return GetGlyphSlow(cp, render_if_needed);
+}
+
+FontGlyph* FontFace::GetGlyphSlow(UCS4 cp, bool render_if_needed) {
+  // The glyph cache and font renderer are shared by all elements being
+  // measured if layout runs in parallel.
+  util::SharedStateLock lock;
   FontGlyph* glyph = m_glyph_cache->GetGlyph(GetHashId(cp), cp);
   if (!glyph) {
     glyph = CreateAndCacheGlyph(cp);
   }
-  if (glyph && !glyph->frag && render_if_needed) {
-    RenderGlyph(glyph);
+  // Also when found in the cache, which may have been preloaded.
+  if (glyph && cp < kDirectGlyphCount) {
+    m_direct_glyphs[cp].store(glyph, std::memory_order_release);
+  }
+  if (glyph && render_if_needed) {
+    if (!glyph->frag) {
+      util::Counters::Add(util::Counter::kGlyphCacheMisses);
+      RenderGlyph(glyph);
+    } else {
+      util::Counters::Add(util::Counter::kGlyphCacheHits);
+    }
+    glyph->referenced = true;
   }
   return glyph;
 }
@@ -161,11 +250,27 @@ void FontFace::DrawString(int x, int y, const Color& color, const char* str,
     Renderer::get()->BeginBatchHint(Renderer::BatchHint::kDrawBitmapFragment);
   }
 
+  // Blurred glyphs can't be drawn from distance fields.
+  const bool use_distance_field =
+      m_distance_field_face && !m_effect.blur_radius();
+
   size_t i = 0;
   while (str[i] && i < len) {
     UCS4 cp = utf8::decode_next(str, &i, len);
     if (cp == 0xFFFF) continue;
-    if (FontGlyph* glyph = GetGlyph(cp, true)) {
+    FontGlyph* glyph = GetGlyph(cp, !use_distance_field);
+    if (glyph && use_distance_field) {
+      // Draw the shared distance field glyph scaled to our size. If there is
+      // none, render the glyph for our size as usual.
+      FontGlyph* field_glyph = m_distance_field_face->GetGlyph(cp, true);
+      if (field_glyph && field_glyph->frag) {
+        DrawDistanceFieldGlyph(x, y, color, field_glyph);
+        x += glyph->metrics.advance;
+        continue;
+      }
+      glyph = GetGlyph(cp, true);
+    }
+    if (glyph) {
       if (glyph->frag) {
         Rect dst_rect(x + glyph->metrics.x, y + glyph->metrics.y + ascent(),
                       glyph->frag->width(), glyph->frag->height());
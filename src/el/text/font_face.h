@@ -10,6 +10,7 @@
 #ifndef EL_TEXT_FONT_FACE_H_
 #define EL_TEXT_FONT_FACE_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
 
@@ -17,7 +18,6 @@
 #include "el/font_description.h"
 #include "el/text/font_effect.h"
 #include "el/text/utf8.h"
-#include "el/util/intrusive_list.h"
 #include "el/util/string_builder.h"
 
 namespace el {
@@ -30,6 +30,7 @@ namespace el {
 namespace text {
 
 class FontGlyphCache;
+class FontManager;
 class FontRenderer;
 
 // Rendering info used during glyph rendering by FontRenderer.
@@ -63,7 +64,7 @@ class FontMetrics {
 // Holds glyph metrics and bitmap fragment.
 // There's one of these for all rendered (both successful and missing) glyphs in
 // FontFace.
-class FontGlyph : public util::IntrusiveListEntry<FontGlyph> {
+class FontGlyph {
  public:
   FontGlyph(const TBID& hash_id, utf8::UCS4 cp);
   TBID hash_id;
@@ -72,11 +73,23 @@ class FontGlyph : public util::IntrusiveListEntry<FontGlyph> {
   graphics::BitmapFragment* frag =
       nullptr;           // The bitmap fragment, or nullptr if missing.
   bool has_rgb = false;  // if true, drawing should ignore text color.
+  // Set when the glyph is drawn, and cleared by the FontGlyphCache eviction
+  // clock. Glyphs that has not been drawn since the last sweep are evicted.
+  bool referenced = false;
+  // Index in the FontGlyphCache eviction clock, if it has a fragment.
+  uint32_t clock_index = 0;
 };
 
 // Represents a loaded font that can measure and render strings.
 class FontFace {
  public:
+  // Distance field glyphs are rendered at kDistanceFieldRenderSize, and the
+  // field is generated kDistanceFieldDownscale times smaller with
+  // kDistanceFieldSpread pixels of falloff around the outline.
+  static const int kDistanceFieldRenderSize = 128;
+  static const int kDistanceFieldDownscale = 4;
+  static const int kDistanceFieldSpread = 4;
+
   FontFace(FontGlyphCache* glyph_cache, std::unique_ptr<FontRenderer> renderer,
            const FontDescription& font_desc);
   ~FontFace();
@@ -127,11 +140,36 @@ class FontFace {
   // calling DrawString. Useful to add a shadow effect to a font.
   void SetBackgroundFont(FontFace* font, const Color& col, int xofs, int yofs);
 
+  // Returns true if glyphs are drawn scaled from shared distance field glyphs
+  // instead of being rendered for the size of this font face.
+  bool is_distance_field() const { return m_distance_field_face != nullptr; }
+
+  // Returns true if the glyph for cp is looked up without hashing.
+  bool has_direct_glyph(utf8::UCS4 cp) const {
+    return cp < kDirectGlyphCount &&
+           m_direct_glyphs[cp].load(std::memory_order_acquire) != nullptr;
+  }
+
  private:
+  friend class FontManager;
+
   TBID GetHashId(utf8::UCS4 cp) const;
   FontGlyph* GetGlyph(utf8::UCS4 cp, bool render_if_needed);
+  FontGlyph* GetGlyphSlow(utf8::UCS4 cp, bool render_if_needed);
   FontGlyph* CreateAndCacheGlyph(utf8::UCS4 cp);
   void RenderGlyph(FontGlyph* glyph);
+  void RenderDistanceFieldGlyph(FontGlyph* glyph);
+  void DrawDistanceFieldGlyph(int x, int y, const Color& color,
+                              FontGlyph* field_glyph);
+
+  // Glyphs in the Latin-1 range are looked up directly from this table
+  // instead of hashing into the FontGlyphCache. The glyphs are owned by the
+  // cache, which never deletes glyphs (only their fragments).
+  // Atomic since elements may be measured in parallel (See
+  // LayoutBox::set_parallel_measure_pool). Glyphs are only created under a
+  // util::SharedStateLock.
+  static const utf8::UCS4 kDirectGlyphCount = 256;
+  std::atomic<FontGlyph*> m_direct_glyphs[kDirectGlyphCount] = {};
 
   FontGlyphCache* m_glyph_cache = nullptr;
   std::unique_ptr<FontRenderer> m_font_renderer;
@@ -140,6 +178,12 @@ class FontFace {
   FontEffect m_effect;
   util::StringBuilder m_temp_buffer;
 
+  // The face owning the distance field glyphs drawn for this face, if any.
+  // It's owned by the FontManager and shared by all sizes of the font.
+  FontFace* m_distance_field_face = nullptr;
+  // True if this face renders distance field glyphs for other faces.
+  bool m_is_distance_field_source = false;
+
   FontFace* m_bgFont = nullptr;
   int m_bgX = 0;
   int m_bgY = 0;
@@ -7,10 +7,15 @@
  ******************************************************************************
  */
 
+#include <cstdio>
+#include <cstring>
 #include <memory>
 
+#include "el/graphics/bitmap_fragment_map.h"
+#include "el/io/file_manager.h"
 #include "el/text/font_manager.h"
 #include "el/text/font_renderer.h"
+#include "el/util/counters.h"
 
 namespace el {
 namespace text {
@@ -22,6 +27,25 @@ using UCS4 = el::text::utf8::UCS4;
 constexpr int kDefaultGlyphCacheMapWidth = 512;
 constexpr int kDefaultGlyphCacheMapHeight = 512;
 
+// Glyph cache file header. The version must be bumped whenever the format
+// changes, or the glyph rendering (hash ids, effects, etc) changes.
+constexpr uint32_t kGlyphCacheFileMagic = 0x43474C45;  // 'ELGC'
+constexpr uint32_t kGlyphCacheFileVersion = 1;
+
+// A glyph in the glyph cache file, followed by the width * height pixels of
+// its bitmap. Everything is stored in native byte order.
+struct GlyphCacheFileEntry {
+  uint32_t hash_id;
+  uint32_t cp;
+  int16_t advance;
+  int16_t x;
+  int16_t y;
+  uint8_t has_rgb;
+  uint8_t has_bitmap;
+  uint16_t width;
+  uint16_t height;
+};
+
 std::unique_ptr<FontManager> FontManager::font_manager_singleton_;
 
 FontGlyphCache::FontGlyphCache() {
@@ -38,18 +62,7 @@ FontGlyphCache::~FontGlyphCache() { Renderer::get()->RemoveListener(this); }
 
 FontGlyph* FontGlyphCache::GetGlyph(const TBID& hash_id, UCS4 cp) {
   auto it = m_glyphs.find(hash_id);
-  if (it == m_glyphs.end()) {
-    return nullptr;
-  }
-  auto glyph = it->second.get();
-
-  // Move the glyph to the end of m_all_rendered_glyphs so we maintain LRU
-  // (oldest first)
-  if (m_all_rendered_glyphs.ContainsLink(glyph)) {
-    m_all_rendered_glyphs.Remove(glyph);
-    m_all_rendered_glyphs.AddLast(glyph);
-  }
-  return glyph;
+  return it != m_glyphs.end() ? it->second.get() : nullptr;
 }
 
 FontGlyph* FontGlyphCache::CreateAndCacheGlyph(const TBID& hash_id, UCS4 cp) {
@@ -71,50 +84,183 @@ graphics::BitmapFragment* FontGlyphCache::CreateFragment(FontGlyph* glyph,
     return nullptr;
   }
 
-  bool try_drop_largest = true;
-  bool dropped_large_enough_glyph = false;
+  bool try_drop_large_enough = true;
   do {
     // Attempt creating a fragment for the rendered glyph data.
     if (auto frag = m_frag_manager.CreateNewFragment(glyph->hash_id, false, w,
                                                      h, stride, data)) {
       glyph->frag = frag;
-      m_all_rendered_glyphs.AddLast(glyph);
+      glyph->referenced = true;
+      glyph->clock_index = uint32_t(m_rendered_glyphs.size());
+      m_rendered_glyphs.push_back(glyph);
       return frag;
     }
-    // Drop the oldest glyph that's large enough to free up the space we need.
-    if (try_drop_largest) {
-      const int check_limit = 20;
-      int check_count = 0;
-      for (FontGlyph* oldest = m_all_rendered_glyphs.GetFirst();
-           oldest && check_count < check_limit; oldest = oldest->GetNext()) {
-        if (oldest->frag->width() >= w &&
-            oldest->frag->allocated_height() >= h) {
-          DropGlyphFragment(oldest);
-          dropped_large_enough_glyph = true;
-          break;
-        }
-        check_count++;
-      }
-      try_drop_largest = false;
+    if (m_rendered_glyphs.empty()) {
+      break;
     }
-    // We had no large enough glyph so just drop the oldest one. We will likely
-    // spin around the loop, fail and drop again a few times before we succeed.
-    if (!dropped_large_enough_glyph) {
-      if (FontGlyph* oldest = m_all_rendered_glyphs.GetFirst()) {
-        DropGlyphFragment(oldest);
-      } else {
-        break;
-      }
+    // First try dropping a glyph that's large enough to free up the space we
+    // need. If that isn't enough, just drop glyphs in clock order. We will
+    // likely spin around the loop, fail and drop again a few times before we
+    // succeed.
+    FontGlyph* victim = nullptr;
+    if (try_drop_large_enough) {
+      victim = FindEvictionCandidate(w, h);
+      try_drop_large_enough = false;
+    }
+    if (!victim) {
+      victim = FindEvictionCandidate(0, 0);
     }
+    DropGlyphFragment(victim);
+    util::Counters::Add(util::Counter::kGlyphCacheEvictions);
   } while (true);
   return nullptr;
 }
 
+void FontGlyphCache::SaveGlyphs(std::vector<uint8_t>* data) {
+  auto append = [data](const void* src, size_t size) {
+    auto bytes = reinterpret_cast<const uint8_t*>(src);
+    data->insert(data->end(), bytes, bytes + size);
+  };
+  data->clear();
+  append(&kGlyphCacheFileMagic, sizeof(kGlyphCacheFileMagic));
+  append(&kGlyphCacheFileVersion, sizeof(kGlyphCacheFileVersion));
+  uint32_t glyph_count = uint32_t(m_glyphs.size());
+  append(&glyph_count, sizeof(glyph_count));
+
+  std::vector<uint32_t> pixels;
+  for (auto& it : m_glyphs) {
+    FontGlyph* glyph = it.second.get();
+    GlyphCacheFileEntry entry = {};
+    entry.hash_id = glyph->hash_id;
+    entry.cp = glyph->cp;
+    entry.advance = glyph->metrics.advance;
+    entry.x = glyph->metrics.x;
+    entry.y = glyph->metrics.y;
+    entry.has_rgb = glyph->has_rgb ? 1 : 0;
+    if (glyph->frag) {
+      entry.has_bitmap = 1;
+      entry.width = uint16_t(glyph->frag->width());
+      entry.height = uint16_t(glyph->frag->height());
+    }
+    append(&entry, sizeof(entry));
+    if (glyph->frag) {
+      pixels.resize(size_t(entry.width) * entry.height);
+      glyph->frag->m_map->ReadFragmentData(glyph->frag, pixels.data());
+      append(pixels.data(), pixels.size() * sizeof(uint32_t));
+    }
+  }
+}
+
+bool FontGlyphCache::LoadGlyphs(const uint8_t* data, size_t size) {
+  size_t offset = 0;
+  auto read = [data, size, &offset](void* dst, size_t length) {
+    if (offset + length > size) {
+      return false;
+    }
+    std::memcpy(dst, data + offset, length);
+    offset += length;
+    return true;
+  };
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint32_t glyph_count = 0;
+  if (!read(&magic, sizeof(magic)) || magic != kGlyphCacheFileMagic ||
+      !read(&version, sizeof(version)) || version != kGlyphCacheFileVersion ||
+      !read(&glyph_count, sizeof(glyph_count))) {
+    return false;
+  }
+
+  std::vector<uint32_t> pixels;
+  for (uint32_t i = 0; i < glyph_count; ++i) {
+    GlyphCacheFileEntry entry;
+    if (!read(&entry, sizeof(entry))) {
+      return false;
+    }
+    if (entry.has_bitmap) {
+      // Glyphs larger than the cache map can never have been saved.
+      if (entry.width > m_frag_manager.default_map_width() ||
+          entry.height > m_frag_manager.default_map_height()) {
+        return false;
+      }
+      pixels.resize(size_t(entry.width) * entry.height);
+      if (!read(pixels.data(), pixels.size() * sizeof(uint32_t))) {
+        return false;
+      }
+    }
+    if (GetGlyph(entry.hash_id, entry.cp)) {
+      continue;
+    }
+    FontGlyph* glyph = CreateAndCacheGlyph(entry.hash_id, entry.cp);
+    glyph->metrics.advance = entry.advance;
+    glyph->metrics.x = entry.x;
+    glyph->metrics.y = entry.y;
+    glyph->has_rgb = entry.has_rgb != 0;
+    if (entry.has_bitmap) {
+      CreateFragment(glyph, entry.width, entry.height, entry.width,
+                     pixels.data());
+      // Preloaded glyphs has not been drawn yet, so let them be evicted first.
+      glyph->referenced = false;
+    }
+  }
+  return true;
+}
+
+bool FontGlyphCache::SaveGlyphsToFile(const std::string& filename) {
+  std::vector<uint8_t> data;
+  SaveGlyphs(&data);
+  FILE* file = fopen(filename.c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+  bool success = fwrite(data.data(), 1, data.size(), file) == data.size();
+  fclose(file);
+  return success;
+}
+
+bool FontGlyphCache::LoadGlyphsFromFile(const std::string& filename) {
+  auto data = io::FileManager::OpenContents(filename);
+  if (!data) {
+    return false;
+  }
+  return LoadGlyphs(data->data(), data->size());
+}
+
+FontGlyph* FontGlyphCache::FindEvictionCandidate(int w, int h) {
+  assert(!m_rendered_glyphs.empty());
+  // Sweep the clock hand over the glyphs, clearing the referenced flag of
+  // glyphs that has been drawn since the last sweep. The first glyph with the
+  // flag already cleared is the candidate. When looking for a glyph of a
+  // minimum size, only check a limited number of glyphs.
+  const size_t check_limit = (w || h) ? 20 : m_rendered_glyphs.size() * 2;
+  for (size_t check_count = 0; check_count < check_limit; ++check_count) {
+    if (m_clock_hand >= m_rendered_glyphs.size()) {
+      m_clock_hand = 0;
+    }
+    FontGlyph* glyph = m_rendered_glyphs[m_clock_hand];
+    if (glyph->referenced) {
+      glyph->referenced = false;
+    } else if (glyph->frag->width() >= w &&
+               glyph->frag->allocated_height() >= h) {
+      return glyph;
+    }
+    ++m_clock_hand;
+  }
+  // Only reachable when looking for a minimum size, since a full sweep
+  // clears all referenced flags.
+  return nullptr;
+}
+
 void FontGlyphCache::DropGlyphFragment(FontGlyph* glyph) {
   assert(glyph->frag);
   m_frag_manager.FreeFragment(glyph->frag);
   glyph->frag = nullptr;
-  m_all_rendered_glyphs.Remove(glyph);
+  glyph->referenced = false;
+
+  // Swap the last glyph into the slot so the clock stays compact.
+  FontGlyph* last = m_rendered_glyphs.back();
+  m_rendered_glyphs[glyph->clock_index] = last;
+  last->clock_index = glyph->clock_index;
+  m_rendered_glyphs.pop_back();
 }
 
 #ifdef EL_RUNTIME_DEBUG_INFO
@@ -193,6 +339,11 @@ FontFace* FontManager::CreateFontFace(const FontDescription& font_desc) {
   for (auto& font_renderer : m_font_renderers) {
     auto font = font_renderer->Create(this, fi->filename(), font_desc);
     if (font) {
+      if (m_distance_field_text && font_renderer->is_scalable() &&
+          Renderer::get()->supports_distance_field()) {
+        font->m_distance_field_face = GetDistanceFieldFace(
+            font_renderer.get(), fi->filename(), font_desc);
+      }
       auto font_ptr = font.get();
       m_fonts.emplace(font_desc.font_face_id(), std::move(font));
       return font_ptr;
@@ -201,5 +352,24 @@ FontFace* FontManager::CreateFontFace(const FontDescription& font_desc) {
   return nullptr;
 }
 
+FontFace* FontManager::GetDistanceFieldFace(FontRenderer* font_renderer,
+                                            const std::string& filename,
+                                            const FontDescription& font_desc) {
+  FontDescription field_desc = font_desc;
+  field_desc.set_size(FontFace::kDistanceFieldRenderSize);
+  auto it = m_distance_field_fonts.find(field_desc.font_face_id());
+  if (it != m_distance_field_fonts.end()) {
+    return it->second.get();
+  }
+  auto font = font_renderer->Create(this, filename, field_desc);
+  if (!font) {
+    return nullptr;
+  }
+  font->m_is_distance_field_source = true;
+  auto font_ptr = font.get();
+  m_distance_field_fonts.emplace(field_desc.font_face_id(), std::move(font));
+  return font_ptr;
+}
+
 }  // namespace text
 }  // namespace el
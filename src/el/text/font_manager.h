@@ -12,7 +12,6 @@
 
 #include <memory>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "el/font_description.h"
@@ -22,6 +21,7 @@
 #include "el/text/font_face.h"
 #include "el/text/font_renderer.h"
 #include "el/text/utf8.h"
+#include "el/util/id_map.h"
 
 namespace el {
 namespace text {
@@ -60,11 +60,32 @@ class FontGlyphCache : private graphics::RendererListener {
   FontGlyph* CreateAndCacheGlyph(const TBID& hash_id, utf8::UCS4 cp);
 
   // Creates a bitmap fragment for the given glyph and render data. This may
-  // drop other rendered glyphs from the fragment map.
+  // drop other rendered glyphs from the fragment map, picking the ones that
+  // has not been drawn for the longest time using a CLOCK sweep.
   // Returns the fragment, or nullptr on fail.
   graphics::BitmapFragment* CreateFragment(FontGlyph* glyph, int w, int h,
                                            int stride, uint32_t* data);
 
+  // Writes all glyphs in the cache (identifying the font face, size and code
+  // point by their hash id) with their metrics and rendered bitmaps to data,
+  // in a versioned binary format.
+  void SaveGlyphs(std::vector<uint8_t>* data);
+
+  // Adds the glyphs saved by SaveGlyphs to the cache, so font faces will use
+  // them without rendering. Glyphs already in the cache are kept.
+  // Returns false if the data is not a glyph cache of the current version, or
+  // is truncated.
+  bool LoadGlyphs(const uint8_t* data, size_t size);
+
+  // Saves the glyphs to the given file (See SaveGlyphs).
+  // Typically done at shutdown, so the next startup can preload the glyphs
+  // that was used with LoadGlyphsFromFile.
+  bool SaveGlyphsToFile(const std::string& filename);
+
+  // Loads glyphs from the given file, read through io::FileManager
+  // (See LoadGlyphs).
+  bool LoadGlyphsFromFile(const std::string& filename);
+
 #ifdef EL_RUNTIME_DEBUG_INFO
   // Renders the glyph bitmaps on screen, to analyze fragment positioning.
   void Debug();
@@ -74,11 +95,16 @@ class FontGlyphCache : private graphics::RendererListener {
   void OnContextRestored() override;
 
  private:
+  friend class FontFace;
+
+  FontGlyph* FindEvictionCandidate(int w, int h);
   void DropGlyphFragment(FontGlyph* glyph);
 
   graphics::BitmapFragmentManager m_frag_manager;
-  std::unordered_map<uint32_t, std::unique_ptr<FontGlyph>> m_glyphs;
-  util::IntrusiveList<FontGlyph> m_all_rendered_glyphs;
+  util::IdMap<std::unique_ptr<FontGlyph>> m_glyphs;
+  // All glyphs with a fragment, swept by m_clock_hand when space is needed.
+  std::vector<FontGlyph*> m_rendered_glyphs;
+  size_t m_clock_hand = 0;
 };
 
 // Creates and owns font faces (FontFace) which are looked up from
@@ -141,15 +167,30 @@ class FontManager {
   // Returns the glyph cache used for fonts created by this font manager.
   FontGlyphCache* glyph_cache() { return &m_glyph_cache; }
 
+  bool is_distance_field_text() const { return m_distance_field_text; }
+  // Sets if scalable fonts should draw text from distance field glyphs, so one
+  // glyph in the glyph cache serves all sizes of a font. It's only used if the
+  // renderer supports it (See Renderer::supports_distance_field), and only
+  // affects font faces created after this call.
+  void set_distance_field_text(bool enable) { m_distance_field_text = enable; }
+
  private:
+  // Gets the face rendering distance field glyphs for all sizes of the font in
+  // font_desc, creating it with the given renderer if needed.
+  FontFace* GetDistanceFieldFace(FontRenderer* font_renderer,
+                                 const std::string& filename,
+                                 const FontDescription& font_desc);
+
   static std::unique_ptr<FontManager> font_manager_singleton_;
 
-  std::unordered_map<uint32_t, std::unique_ptr<FontInfo>> m_font_info;
-  std::unordered_map<uint32_t, std::unique_ptr<FontFace>> m_fonts;
+  util::IdMap<std::unique_ptr<FontInfo>> m_font_info;
+  util::IdMap<std::unique_ptr<FontFace>> m_fonts;
+  util::IdMap<std::unique_ptr<FontFace>> m_distance_field_fonts;
   std::vector<std::unique_ptr<FontRenderer>> m_font_renderers;
   FontGlyphCache m_glyph_cache;
   FontDescription m_default_font_desc;
   FontDescription m_test_font_desc;
+  bool m_distance_field_text = false;
 };
 
 }  // namespace text
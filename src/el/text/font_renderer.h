@@ -41,6 +41,12 @@ class FontRenderer {
   virtual bool RenderGlyph(FontGlyphData* data, utf8::UCS4 cp) = 0;
   virtual void GetGlyphMetrics(GlyphMetrics* metrics, utf8::UCS4 cp) = 0;
   virtual FontMetrics GetMetrics() = 0;
+
+  // Returns true if the renderer rasterizes outlines, so a font can be
+  // created at any size with the same glyph shapes. Glyphs from scalable fonts
+  // may be drawn from distance fields
+  // (See FontManager::set_distance_field_text).
+  virtual bool is_scalable() const { return false; }
 };
 
 }  // namespace text
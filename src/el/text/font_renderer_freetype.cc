@@ -7,7 +7,10 @@
  ******************************************************************************
  */
 
+#include <memory>
+
 #include "el/graphics/renderer.h"
+#include "el/io/file_manager.h"
 #include "el/text/font_renderer.h"
 
 #ifdef EL_FONT_RENDERER_FREETYPE
@@ -32,11 +35,10 @@ static util::HashTableOf<FreetypeFace> ft_face_cache;
 
 class FreetypeFace {
  public:
-  FreetypeFace() : hashID(0), ttf_buffer(nullptr), m_face(0), refCount(1) {}
+  FreetypeFace() : hashID(0), m_face(0), refCount(1) {}
   ~FreetypeFace() {
     if (hashID) ft_face_cache.Remove(hashID);
     FT_Done_Face(m_face);
-    delete[] ttf_buffer;
   }
   void Release() {
     --refCount;
@@ -44,7 +46,8 @@ class FreetypeFace {
   }
 
   uint32_t hashID;
-  unsigned char* ttf_buffer;
+  // The font file, used directly by freetype while the face is alive.
+  std::unique_ptr<el::io::FileContents> ttf_contents;
   FT_Face m_face;
   unsigned int refCount;
 };
@@ -62,6 +65,7 @@ class FreetypeFontRenderer : public FontRenderer {
   virtual FontMetrics GetMetrics();
   virtual bool RenderGlyph(FontGlyphData* dst_bitmap, UCS4 cp);
   virtual void GetGlyphMetrics(GlyphMetrics* metrics, UCS4 cp);
+  virtual bool is_scalable() const { return true; }
 
  private:
   bool Load(FreetypeFace* face, int size);
@@ -133,14 +137,11 @@ bool FreetypeFontRenderer::Load(const std::string& filename, int size) {
 
   m_face = new FreetypeFace();
 
-  auto file = util::File::Open(filename, util::File::Mode::kRead);
-  if (!file) return false;
-
-  size_t ttf_buf_size = file->Size();
-  m_face->ttf_buffer = new unsigned char[ttf_buf_size];
-  ttf_buf_size = file->Read(m_face->ttf_buffer, 1, ttf_buf_size);
+  m_face->ttf_contents = io::FileManager::OpenContents(filename);
+  if (!m_face->ttf_contents) return false;
 
-  if (FT_New_Memory_Face(g_freetype, m_face->ttf_buffer, ttf_buf_size, 0,
+  if (FT_New_Memory_Face(g_freetype, m_face->ttf_contents->data(),
+                         FT_Long(m_face->ttf_contents->size()), 0,
                          &m_face->m_face))
     return false;
   return Load(m_face, size);
@@ -7,7 +7,10 @@
  ******************************************************************************
  */
 
+#include <memory>
+
 #include "el/graphics/renderer.h"
+#include "el/io/file_manager.h"
 #include "el/text/font_face.h"
 #include "el/text/font_manager.h"
 #include "el/text/font_renderer.h"
@@ -39,21 +42,20 @@ class SFontRenderer : public FontRenderer {
   bool RenderGlyph(FontGlyphData* dst_bitmap, UCS4 cp) override;
   void GetGlyphMetrics(GlyphMetrics* metrics, UCS4 cp) override;
   FontMetrics GetMetrics() override;
+  bool is_scalable() const override { return true; }
 
  private:
   stbtt_fontinfo font;
-  unsigned char* ttf_buffer;
+  // The font file, used directly by stb_truetype.
+  std::unique_ptr<io::FileContents> ttf_contents;
   unsigned char* render_data;
   int font_size;
   float scale;
 };
 
-SFontRenderer::SFontRenderer() : ttf_buffer(nullptr), render_data(nullptr) {}
+SFontRenderer::SFontRenderer() : render_data(nullptr) {}
 
-SFontRenderer::~SFontRenderer() {
-  delete[] ttf_buffer;
-  delete[] render_data;
-}
+SFontRenderer::~SFontRenderer() { delete[] render_data; }
 
 bool SFontRenderer::RenderGlyph(FontGlyphData* data, UCS4 cp) {
   delete[] render_data;
@@ -87,13 +89,10 @@ FontMetrics SFontRenderer::GetMetrics() {
 }
 
 bool SFontRenderer::Load(const char* filename, int size) {
-  auto file = util::File::Open(filename, util::File::Mode::kRead);
-  if (!file) return false;
-
-  size_t ttf_buf_size = file->Size();
-  ttf_buffer = new unsigned char[ttf_buf_size];
-  ttf_buf_size = file->Read(ttf_buffer, 1, ttf_buf_size);
+  ttf_contents = io::FileManager::OpenContents(filename);
+  if (!ttf_contents) return false;
 
+  const unsigned char* ttf_buffer = ttf_contents->data();
   stbtt_InitFont(&font, ttf_buffer, stbtt_GetFontOffsetForIndex(ttf_buffer, 0));
 
   font_size =
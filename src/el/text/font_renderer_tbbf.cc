@@ -9,7 +9,6 @@
 
 #include <algorithm>
 #include <memory>
-#include <unordered_map>
 
 #include "el/graphics/image_loader.h"
 #include "el/graphics/renderer.h"
@@ -18,6 +17,7 @@
 #include "el/text/font_manager.h"
 #include "el/text/font_renderer.h"
 #include "el/text/utf8.h"
+#include "el/util/id_map.h"
 
 #ifdef EL_FONT_RENDERER_TBBF
 
@@ -121,7 +121,7 @@ class TBBFRenderer : public FontRenderer {
   int m_advance_delta;
   int m_space_advance;
   int m_rgb;
-  std::unordered_map<uint32_t, std::unique_ptr<GLYPH>> m_glyph_table;
+  util::IdMap<std::unique_ptr<GLYPH>> m_glyph_table;
 };
 
 TBBFRenderer::TBBFRenderer()
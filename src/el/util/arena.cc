@@ -0,0 +1,62 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <cstdint>
+#include <cstring>
+
+#include "el/util/arena.h"
+
+namespace el {
+namespace util {
+
+Arena::Arena(size_t block_size) : m_block_size(block_size) {}
+
+Arena::~Arena() = default;
+
+void* Arena::AllocateSlow(size_t size, size_t alignment) {
+  // Allocations larger than a quarter block get a block of their own, so they
+  // don't waste the remainder of the current block.
+  size_t block_size = size + alignment;
+  if (block_size > m_block_size / 4) {
+    m_blocks.emplace_back(new char[block_size]);
+    m_bytes_reserved += block_size;
+    char* block = m_blocks.back().get();
+    size_t offset = (alignment - reinterpret_cast<uintptr_t>(block) %
+                                     alignment) % alignment;
+    m_bytes_allocated += size;
+    return block + offset;
+  }
+  m_blocks.emplace_back(new char[m_block_size]);
+  m_bytes_reserved += m_block_size;
+  m_block = m_blocks.back().get();
+  m_block_capacity = m_block_size;
+  // new[] returns memory aligned for any fundamental type, and the offset is
+  // aligned relative to the block start.
+  m_offset = 0;
+  return Allocate(size, alignment);
+}
+
+char* Arena::CopyString(const char* str, size_t length) {
+  char* copy = static_cast<char*>(Allocate(length + 1, 1));
+  std::memcpy(copy, str, length);
+  copy[length] = 0;
+  return copy;
+}
+
+void Arena::Reset() {
+  m_blocks.clear();
+  m_block = nullptr;
+  m_offset = 0;
+  m_block_capacity = 0;
+  m_bytes_allocated = 0;
+  m_bytes_reserved = 0;
+}
+
+}  // namespace util
+}  // namespace el
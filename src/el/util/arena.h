@@ -0,0 +1,79 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#ifndef EL_UTIL_ARENA_H_
+#define EL_UTIL_ARENA_H_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace el {
+namespace util {
+
+// Bump allocator handing out memory from large blocks.
+// Allocations can't be freed one by one. All memory is freed at once when the
+// arena is reset or destroyed, without running any destructors. This avoids
+// the cost and heap fragmentation of many small allocations with the same
+// lifetime (such as the nodes of a parsed resource file).
+class Arena {
+ public:
+  static const size_t kDefaultBlockSize = 16 * 1024;
+
+  explicit Arena(size_t block_size = kDefaultBlockSize);
+  ~Arena();
+
+  // Allocates size bytes aligned to alignment (which must be a power of two).
+  void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+    size_t offset = (m_offset + alignment - 1) & ~(alignment - 1);
+    if (offset + size > m_block_capacity) {
+      return AllocateSlow(size, alignment);
+    }
+    m_offset = offset + size;
+    m_bytes_allocated += size;
+    return m_block + offset;
+  }
+
+  // Constructs a T in memory allocated from the arena.
+  // NOTE: The destructor is not called by the arena.
+  template <typename T, typename... Args>
+  T* New(Args&&... args) {
+    return new (Allocate(sizeof(T), alignof(T)))
+        T(std::forward<Args>(args)...);
+  }
+
+  // Copies length chars of str into the arena and null terminates the copy.
+  char* CopyString(const char* str, size_t length);
+
+  // Frees all memory allocated from the arena.
+  void Reset();
+
+  // Gets the number of bytes handed out by Allocate since the last reset.
+  size_t bytes_allocated() const { return m_bytes_allocated; }
+  // Gets the number of bytes in the blocks allocated from the heap.
+  size_t bytes_reserved() const { return m_bytes_reserved; }
+
+ private:
+  void* AllocateSlow(size_t size, size_t alignment);
+
+  size_t m_block_size;
+  std::vector<std::unique_ptr<char[]>> m_blocks;
+  char* m_block = nullptr;
+  size_t m_offset = 0;
+  size_t m_block_capacity = 0;
+  size_t m_bytes_allocated = 0;
+  size_t m_bytes_reserved = 0;
+};
+
+}  // namespace util
+}  // namespace el
+
+#endif  // EL_UTIL_ARENA_H_
@@ -0,0 +1,85 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <cassert>
+
+#include "el/util/counters.h"
+
+namespace el {
+namespace util {
+
+Counters Counters::counters_singleton_;
+
+const char* Counters::name(Counter counter) {
+  switch (counter) {
+    case Counter::kDrawCalls:
+      return "draw_calls";
+    case Counter::kVertices:
+      return "vertices";
+    case Counter::kBatchFlushBitmapChange:
+      return "batch_flush_bitmap_change";
+    case Counter::kBatchFlushClipChange:
+      return "batch_flush_clip_change";
+    case Counter::kBatchFlushBufferFull:
+      return "batch_flush_buffer_full";
+    case Counter::kBatchFlushFragment:
+      return "batch_flush_fragment";
+    case Counter::kBatchFlushRenderTarget:
+      return "batch_flush_render_target";
+    case Counter::kAtlasUploads:
+      return "atlas_uploads";
+    case Counter::kAtlasUploadBytes:
+      return "atlas_upload_bytes";
+    case Counter::kGlyphCacheHits:
+      return "glyph_cache_hits";
+    case Counter::kGlyphCacheMisses:
+      return "glyph_cache_misses";
+    case Counter::kGlyphCacheEvictions:
+      return "glyph_cache_evictions";
+    case Counter::kElementsPainted:
+      return "elements_painted";
+    case Counter::kElementsCulled:
+      return "elements_culled";
+    case Counter::kElementsOccluded:
+      return "elements_occluded";
+    case Counter::kLayersPainted:
+      return "layers_painted";
+    case Counter::kLayouts:
+      return "layouts";
+    case Counter::kMeasures:
+      return "measures";
+    case Counter::kMessagesDispatched:
+      return "messages_dispatched";
+    case Counter::kAnimationUpdates:
+      return "animation_updates";
+    default:
+      assert(!"Unknown counter");
+      return "";
+  }
+}
+
+void Counters::EndFrame() {
+  for (size_t i = 0; i < kCounterCount; ++i) {
+    m_frame[i] = m_current[i].exchange(0, std::memory_order_relaxed);
+    m_total[i] += m_frame[i];
+  }
+  ++m_frame_count;
+}
+
+void Counters::Reset() {
+  for (size_t i = 0; i < kCounterCount; ++i) {
+    m_current[i].store(0, std::memory_order_relaxed);
+    m_frame[i] = 0;
+    m_total[i] = 0;
+  }
+  m_frame_count = 0;
+}
+
+}  // namespace util
+}  // namespace el
@@ -0,0 +1,130 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#ifndef EL_UTIL_COUNTERS_H_
+#define EL_UTIL_COUNTERS_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace el {
+namespace util {
+
+// Performance counters updated by the library (See Counters).
+enum class Counter {
+  // Batches rendered by the renderer implementation (Renderer::RenderBatch).
+  kDrawCalls,
+  // Vertices in the rendered batches.
+  kVertices,
+  // Batches flushed because the next quad used another bitmap.
+  kBatchFlushBitmapChange,
+  // Batches flushed because the clip rect changed (only without CPU
+  // clipping, see Renderer::set_cpu_clipping).
+  kBatchFlushClipChange,
+  // Batches flushed because the vertex buffer was full.
+  kBatchFlushBufferFull,
+  // Batches flushed because a bitmap or fragment in it was about to change.
+  kBatchFlushFragment,
+  // Batches flushed because drawing moved into or out of a render target
+  // (See Renderer::BeginRenderTarget).
+  kBatchFlushRenderTarget,
+  // Bitmap fragment maps uploaded to the renderer (created or updated).
+  kAtlasUploads,
+  // Bytes of bitmap data in the atlas uploads.
+  kAtlasUploadBytes,
+  // Glyphs drawn that were already rendered in the glyph cache.
+  kGlyphCacheHits,
+  // Glyphs drawn that had to be rendered first.
+  kGlyphCacheMisses,
+  // Glyphs dropped from the glyph cache to make room for others.
+  kGlyphCacheEvictions,
+  // Elements painted (Element::InvokePaint of visible elements).
+  kElementsPainted,
+  // Elements skipped while painting because they were outside the clip rect.
+  kElementsCulled,
+  // Elements skipped while painting because later opaque siblings covered
+  // them (See Element::set_occlusion_culling).
+  kElementsOccluded,
+  // Element layers painted into their render target because they were
+  // invalidated (See Element::set_layer). The children of layers drawn from
+  // their render target aren't painted.
+  kLayersPainted,
+  // Layouts of children done by layout boxes.
+  kLayouts,
+  // Preferred sizes calculated because they weren't cached.
+  kMeasures,
+  // Messages delivered by MessageHandler::ProcessMessages.
+  kMessagesDispatched,
+  // Animations stepped by AnimationManager::Update.
+  kAnimationUpdates,
+
+  kCounterCount,
+};
+
+// Registry of performance counters, always available so they can be shown in
+// a debug overlay (such as the one in the testbed) or exported to monitoring.
+//
+// Each counter has the value of the last completed frame and a total since
+// startup. The renderer ends a frame in Renderer::EndPaint, so the frame
+// values include the processing and layout done before painting it.
+//
+// Counting is a relaxed atomic add, so counters may be updated from any
+// thread (such as parallel measure workers).
+class Counters {
+ public:
+  static Counters* get() { return &counters_singleton_; }
+
+  static const size_t kCounterCount = size_t(Counter::kCounterCount);
+
+  // Adds value to the given counter of the current frame.
+  static void Add(Counter counter, uint64_t value = 1) {
+    counters_singleton_.m_current[size_t(counter)].fetch_add(
+        value, std::memory_order_relaxed);
+  }
+
+  // Gets the name of the given counter, such as "draw_calls".
+  static const char* name(Counter counter);
+
+  // Gets the value of the counter in the last completed frame.
+  uint64_t frame_value(Counter counter) const {
+    return m_frame[size_t(counter)];
+  }
+  // Gets the value of the counter in the frame that is in progress.
+  uint64_t current_value(Counter counter) const {
+    return m_current[size_t(counter)].load(std::memory_order_relaxed);
+  }
+  // Gets the total value of the counter since startup (or Reset), including
+  // the frame in progress.
+  uint64_t total_value(Counter counter) const {
+    return m_total[size_t(counter)] + current_value(counter);
+  }
+  // Gets the number of completed frames.
+  uint64_t frame_count() const { return m_frame_count; }
+
+  // Completes the current frame, making its values the frame values and
+  // adding them to the totals.
+  void EndFrame();
+
+  // Sets all values to zero.
+  void Reset();
+
+ private:
+  static Counters counters_singleton_;
+
+  std::atomic<uint64_t> m_current[kCounterCount] = {};
+  uint64_t m_frame[kCounterCount] = {};
+  uint64_t m_total[kCounterCount] = {};
+  uint64_t m_frame_count = 0;
+};
+
+}  // namespace util
+}  // namespace el
+
+#endif  // EL_UTIL_COUNTERS_H_
@@ -0,0 +1,240 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#ifndef EL_UTIL_ID_MAP_H_
+#define EL_UTIL_ID_MAP_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace el {
+namespace util {
+
+// Hash map specialized for uint32_t keys (such as TBID).
+// Entries are stored in a single flat array using open addressing with linear
+// probing, so a lookup is usually a single cache line access. Deletion uses
+// backward shifting, so there are no tombstones slowing down later lookups.
+//
+// The interface is a subset of std::unordered_map so it can be used in its
+// place. The value type must be default constructible and movable.
+// NOTE: Inserting or erasing invalidates all iterators and value pointers.
+template <typename T>
+class IdMap {
+ public:
+  using key_type = uint32_t;
+  using mapped_type = T;
+  using value_type = std::pair<uint32_t, T>;
+
+ private:
+  struct Slot {
+    value_type entry;
+    bool used = false;
+  };
+
+  template <typename SlotType, typename ValueType>
+  class IteratorBase {
+   public:
+    IteratorBase(SlotType* slot, SlotType* end) : slot_(slot), end_(end) {
+      SkipUnused();
+    }
+    ValueType& operator*() const { return slot_->entry; }
+    ValueType* operator->() const { return &slot_->entry; }
+    IteratorBase& operator++() {
+      ++slot_;
+      SkipUnused();
+      return *this;
+    }
+    bool operator==(const IteratorBase& other) const {
+      return slot_ == other.slot_;
+    }
+    bool operator!=(const IteratorBase& other) const {
+      return slot_ != other.slot_;
+    }
+
+   private:
+    void SkipUnused() {
+      while (slot_ != end_ && !slot_->used) {
+        ++slot_;
+      }
+    }
+    SlotType* slot_;
+    SlotType* end_;
+  };
+
+ public:
+  using iterator = IteratorBase<Slot, value_type>;
+  using const_iterator = IteratorBase<const Slot, const value_type>;
+
+  IdMap() = default;
+  IdMap(IdMap&& other) = default;
+  IdMap& operator=(IdMap&& other) = default;
+  IdMap(const IdMap&) = delete;
+  IdMap& operator=(const IdMap&) = delete;
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  // Gets the number of slots currently allocated.
+  size_t capacity() const { return slots_.size(); }
+
+  iterator begin() { return iterator(slots_begin(), slots_end()); }
+  iterator end() { return iterator(slots_end(), slots_end()); }
+  const_iterator begin() const {
+    return const_iterator(slots_begin(), slots_end());
+  }
+  const_iterator end() const {
+    return const_iterator(slots_end(), slots_end());
+  }
+
+  iterator find(uint32_t key) {
+    size_t index = FindIndex(key);
+    return index == kNotFound ? end()
+                              : iterator(slots_begin() + index, slots_end());
+  }
+  const_iterator find(uint32_t key) const {
+    size_t index = FindIndex(key);
+    return index == kNotFound
+               ? end()
+               : const_iterator(slots_begin() + index, slots_end());
+  }
+
+  size_t count(uint32_t key) const { return FindIndex(key) != kNotFound; }
+
+  // Inserts the value if there's no entry with the given key.
+  // Returns the entry with the key, and true if it was inserted.
+  template <typename V>
+  std::pair<iterator, bool> emplace(uint32_t key, V&& value) {
+    size_t index = FindIndex(key);
+    if (index != kNotFound) {
+      return {iterator(slots_begin() + index, slots_end()), false};
+    }
+    if ((size_ + 1) * 4 > slots_.size() * 3) {
+      Rehash(slots_.empty() ? kMinCapacity : slots_.size() * 2);
+    }
+    index = InsertNew(key, T(std::forward<V>(value)));
+    return {iterator(slots_begin() + index, slots_end()), true};
+  }
+
+  // Gets the value with the given key, inserting a default value if needed.
+  T& operator[](uint32_t key) { return emplace(key, T()).first->second; }
+
+  // Removes the entry with the given key. Returns the number of entries
+  // removed (0 or 1).
+  size_t erase(uint32_t key) {
+    size_t index = FindIndex(key);
+    if (index == kNotFound) {
+      return 0;
+    }
+    // Shift following entries in the probe sequence back into the hole, so
+    // lookups never have to skip over removed entries.
+    const size_t mask = slots_.size() - 1;
+    size_t hole = index;
+    size_t next = (hole + 1) & mask;
+    while (slots_[next].used) {
+      size_t home = HomeIndex(slots_[next].entry.first);
+      if (((next - home) & mask) >= ((next - hole) & mask)) {
+        slots_[hole].entry = std::move(slots_[next].entry);
+        hole = next;
+      }
+      next = (next + 1) & mask;
+    }
+    slots_[hole].used = false;
+    slots_[hole].entry = value_type();
+    --size_;
+    return 1;
+  }
+
+  // Removes all entries and frees the memory used.
+  void clear() {
+    slots_.clear();
+    size_ = 0;
+    shift_ = 32;
+  }
+
+  // Makes sure count entries can be inserted without rehashing.
+  void reserve(size_t count) {
+    size_t capacity = kMinCapacity;
+    while (count * 4 > capacity * 3) {
+      capacity *= 2;
+    }
+    if (capacity > slots_.size()) {
+      Rehash(capacity);
+    }
+  }
+
+ private:
+  static const size_t kNotFound = ~size_t(0);
+  static const size_t kMinCapacity = 16;
+
+  Slot* slots_begin() { return slots_.data(); }
+  Slot* slots_end() { return slots_.data() + slots_.size(); }
+  const Slot* slots_begin() const { return slots_.data(); }
+  const Slot* slots_end() const { return slots_.data() + slots_.size(); }
+
+  // Fibonacci hashing spreads keys that aren't well distributed (f.ex small
+  // sequential numbers) over the whole table.
+  size_t HomeIndex(uint32_t key) const {
+    return size_t((key * 2654435769u) >> shift_);
+  }
+
+  size_t FindIndex(uint32_t key) const {
+    if (slots_.empty()) {
+      return kNotFound;
+    }
+    const size_t mask = slots_.size() - 1;
+    size_t index = HomeIndex(key);
+    while (slots_[index].used) {
+      if (slots_[index].entry.first == key) {
+        return index;
+      }
+      index = (index + 1) & mask;
+    }
+    return kNotFound;
+  }
+
+  size_t InsertNew(uint32_t key, T&& value) {
+    const size_t mask = slots_.size() - 1;
+    size_t index = HomeIndex(key);
+    while (slots_[index].used) {
+      index = (index + 1) & mask;
+    }
+    slots_[index].entry.first = key;
+    slots_[index].entry.second = std::move(value);
+    slots_[index].used = true;
+    ++size_;
+    return index;
+  }
+
+  void Rehash(size_t new_capacity) {
+    assert((new_capacity & (new_capacity - 1)) == 0);
+    std::vector<Slot> old_slots(new_capacity);
+    old_slots.swap(slots_);
+    shift_ = 32;
+    for (size_t capacity = new_capacity; capacity > 1; capacity >>= 1) {
+      --shift_;
+    }
+    size_ = 0;
+    for (auto& slot : old_slots) {
+      if (slot.used) {
+        InsertNew(slot.entry.first, std::move(slot.entry.second));
+      }
+    }
+  }
+
+  std::vector<Slot> slots_;
+  size_t size_ = 0;
+  int shift_ = 32;
+};
+
+}  // namespace util
+}  // namespace el
+
+#endif  // EL_UTIL_ID_MAP_H_
@@ -0,0 +1,177 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "el/util/lz4.h"
+
+namespace el {
+namespace util {
+
+namespace {
+
+// Format limits. The last 5 bytes are always literals, and the last match
+// must start at least 12 bytes before the end.
+const size_t kMinMatch = 4;
+const size_t kLastLiterals = 5;
+const size_t kMatchSearchLimit = 12;
+const size_t kMaxOffset = 65535;
+const int kHashBits = 12;
+
+inline uint32_t Read32(const uint8_t* p) {
+  uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline uint32_t Hash(uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - kHashBits);
+}
+
+// Writes a length continuation (the part not fitting in the token nibble).
+inline bool WriteLength(size_t length, uint8_t* dst, size_t dst_capacity,
+                        size_t* pos) {
+  while (length >= 255) {
+    if (*pos >= dst_capacity) return false;
+    dst[(*pos)++] = 255;
+    length -= 255;
+  }
+  if (*pos >= dst_capacity) return false;
+  dst[(*pos)++] = uint8_t(length);
+  return true;
+}
+
+// Writes one sequence of literals followed by a match. A match_length of 0
+// writes the last literals only.
+bool WriteSequence(const uint8_t* literals, size_t literal_length,
+                   size_t offset, size_t match_length, uint8_t* dst,
+                   size_t dst_capacity, size_t* pos) {
+  if (*pos >= dst_capacity) return false;
+  size_t token_pos = (*pos)++;
+  uint8_t token = uint8_t(literal_length < 15 ? literal_length : 15) << 4;
+  if (literal_length >= 15 &&
+      !WriteLength(literal_length - 15, dst, dst_capacity, pos)) {
+    return false;
+  }
+  if (literal_length > dst_capacity - *pos) return false;
+  std::memcpy(dst + *pos, literals, literal_length);
+  *pos += literal_length;
+  if (match_length) {
+    if (dst_capacity - *pos < 2) return false;
+    dst[(*pos)++] = uint8_t(offset);
+    dst[(*pos)++] = uint8_t(offset >> 8);
+    size_t length = match_length - kMinMatch;
+    token |= uint8_t(length < 15 ? length : 15);
+    if (length >= 15 && !WriteLength(length - 15, dst, dst_capacity, pos)) {
+      return false;
+    }
+  }
+  dst[token_pos] = token;
+  return true;
+}
+
+// Reads a length continuation.
+inline bool ReadLength(const uint8_t* src, size_t src_length, size_t* pos,
+                       size_t* length) {
+  uint8_t b;
+  do {
+    if (*pos >= src_length) return false;
+    b = src[(*pos)++];
+    *length += b;
+  } while (b == 255);
+  return true;
+}
+
+}  // namespace
+
+size_t Lz4Compress(const uint8_t* src, size_t src_length, uint8_t* dst,
+                   size_t dst_capacity) {
+  // Positions + 1 of the last occurance of each hashed 4 byte sequence.
+  std::vector<uint32_t> table(size_t(1) << kHashBits);
+  size_t pos = 0;
+  size_t anchor = 0;
+  size_t ip = 0;
+  const size_t search_end =
+      src_length > kMatchSearchLimit ? src_length - kMatchSearchLimit : 0;
+  const size_t match_end =
+      src_length > kLastLiterals ? src_length - kLastLiterals : 0;
+  while (ip < search_end) {
+    uint32_t sequence = Read32(src + ip);
+    uint32_t& entry = table[Hash(sequence)];
+    size_t ref = entry;
+    entry = uint32_t(ip + 1);
+    if (!ref || ip - (ref - 1) > kMaxOffset ||
+        Read32(src + ref - 1) != sequence) {
+      ++ip;
+      continue;
+    }
+    --ref;
+    size_t length = kMinMatch;
+    while (ip + length < match_end && src[ref + length] == src[ip + length]) {
+      ++length;
+    }
+    if (!WriteSequence(src + anchor, ip - anchor, ip - ref, length, dst,
+                       dst_capacity, &pos)) {
+      return 0;
+    }
+    ip += length;
+    anchor = ip;
+  }
+  if (!WriteSequence(src + anchor, src_length - anchor, 0, 0, dst,
+                     dst_capacity, &pos)) {
+    return 0;
+  }
+  return pos;
+}
+
+bool Lz4Decompress(const uint8_t* src, size_t src_length, uint8_t* dst,
+                   size_t dst_length) {
+  size_t sp = 0;
+  size_t dp = 0;
+  while (sp < src_length) {
+    uint8_t token = src[sp++];
+    size_t literal_length = token >> 4;
+    if (literal_length == 15 &&
+        !ReadLength(src, src_length, &sp, &literal_length)) {
+      return false;
+    }
+    if (literal_length > src_length - sp || literal_length > dst_length - dp) {
+      return false;
+    }
+    std::memcpy(dst + dp, src + sp, literal_length);
+    sp += literal_length;
+    dp += literal_length;
+    if (sp == src_length) {
+      // The last sequence has no match.
+      break;
+    }
+    if (src_length - sp < 2) return false;
+    size_t offset = src[sp] | (size_t(src[sp + 1]) << 8);
+    sp += 2;
+    if (!offset || offset > dp) return false;
+    size_t match_length = token & 15;
+    if (match_length == 15 &&
+        !ReadLength(src, src_length, &sp, &match_length)) {
+      return false;
+    }
+    match_length += kMinMatch;
+    if (match_length > dst_length - dp) return false;
+    // The match may overlap the output, so copy byte by byte.
+    const uint8_t* match = dst + dp - offset;
+    for (size_t i = 0; i < match_length; ++i) {
+      dst[dp + i] = match[i];
+    }
+    dp += match_length;
+  }
+  return dp == dst_length;
+}
+
+}  // namespace util
+}  // namespace el
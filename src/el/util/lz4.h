@@ -0,0 +1,44 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#ifndef EL_UTIL_LZ4_H_
+#define EL_UTIL_LZ4_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace el {
+namespace util {
+
+// Compression using the LZ4 block format (without the LZ4 frame header), so
+// data compressed with the lz4 tools in block mode can be decompressed and
+// vice versa. The compressor is a simple greedy matcher favouring speed over
+// ratio. Decompression is very fast and checks all bounds, so corrupt data
+// can't make it read or write outside the buffers.
+
+// Gets the maximum compressed size of src_length bytes.
+inline size_t Lz4CompressBound(size_t src_length) {
+  return src_length + src_length / 255 + 16;
+}
+
+// Compresses src_length bytes from src to dst.
+// Returns the compressed size, or 0 if it doesn't fit in dst_capacity bytes.
+size_t Lz4Compress(const uint8_t* src, size_t src_length, uint8_t* dst,
+                   size_t dst_capacity);
+
+// Decompresses src_length bytes of compressed data from src to dst, which
+// must be exactly dst_length bytes when decompressed.
+// Returns false if the data is corrupt or doesn't match dst_length.
+bool Lz4Decompress(const uint8_t* src, size_t src_length, uint8_t* dst,
+                   size_t dst_length);
+
+}  // namespace util
+}  // namespace el
+
+#endif  // EL_UTIL_LZ4_H_
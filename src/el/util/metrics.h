@@ -20,6 +20,10 @@ namespace util {
 // Gets the system time in milliseconds since some undefined epoch.
 uint64_t GetTimeMS();
 
+// Gets a monotonic time in microseconds since some undefined epoch. Use for
+// measuring durations.
+uint64_t GetTimeUS();
+
 // Gets how many milliseconds it should take after a touch down event should
 // generate a long click event.
 int GetLongClickDelayMS();
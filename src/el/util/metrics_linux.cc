@@ -10,6 +10,7 @@
 #include "el/util/metrics.h"
 
 #include <sys/time.h>
+#include <time.h>
 
 namespace el {
 namespace util {
@@ -20,6 +21,12 @@ uint64_t GetTimeMS() {
   return now.tv_usec / 1000 + now.tv_sec * 1000;
 }
 
+uint64_t GetTimeUS() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return uint64_t(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+}
+
 int GetLongClickDelayMS() { return 500; }
 
 int GetPanThreshold() { return 5 * GetDPI() / 96; }
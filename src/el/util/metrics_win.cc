@@ -23,6 +23,19 @@ uint64_t GetTimeMS() {
   return ((uint64_t(t.dwHighDateTime) << 32) | t.dwLowDateTime) / 10000;
 }
 
+uint64_t GetTimeUS() {
+  static LARGE_INTEGER frequency = []() {
+    LARGE_INTEGER value;
+    QueryPerformanceFrequency(&value);
+    return value;
+  }();
+  LARGE_INTEGER counter;
+  QueryPerformanceCounter(&counter);
+  return uint64_t(counter.QuadPart / frequency.QuadPart) * 1000000 +
+         uint64_t(counter.QuadPart % frequency.QuadPart) * 1000000 /
+             frequency.QuadPart;
+}
+
 int GetLongClickDelayMS() { return 500; }
 
 int GetPanThreshold() { return 5 * GetDPI() / 96; }
@@ -19,7 +19,7 @@ std::unique_ptr<StringTable> StringTable::string_table_singleton_;
 bool StringTable::Load(const char* filename) {
   // Read the file into a node tree (even though it's only a flat list).
   parsing::ParseNode node;
-  if (!node.ReadFile(filename)) {
+  if (!node.ReadFile(filename, parsing::ReadFlags::kArena)) {
     return false;
   }
 
@@ -12,9 +12,9 @@
 
 #include <memory>
 #include <string>
-#include <unordered_map>
 
 #include "el/id.h"
+#include "el/util/id_map.h"
 
 namespace el {
 namespace util {
@@ -55,7 +55,7 @@ class StringTable {
  private:
   static std::unique_ptr<StringTable> string_table_singleton_;
 
-  std::unordered_map<uint32_t, std::string> table_;
+  IdMap<std::string> table_;
 };
 
 inline std::string GetString(const TBID& id) {
@@ -0,0 +1,109 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+
+#include "el/util/trace.h"
+
+namespace el {
+namespace util {
+
+Tracer Tracer::tracer_singleton_;
+
+Tracer::Tracer() : m_write_index(0), m_recording(false) {}
+
+Tracer::~Tracer() = default;
+
+void Tracer::Start(size_t capacity) {
+  if (!m_slots) {
+    m_capacity = 1;
+    while (m_capacity < capacity) {
+      m_capacity *= 2;
+    }
+    m_slots.reset(new Slot[m_capacity]);
+  }
+  for (size_t i = 0; i < m_capacity; ++i) {
+    m_slots[i].sequence.store(0, std::memory_order_relaxed);
+  }
+  m_write_index.store(0, std::memory_order_relaxed);
+  m_recording.store(true, std::memory_order_release);
+}
+
+void Tracer::Stop() { m_recording.store(false, std::memory_order_release); }
+
+void Tracer::Record(const char* name, uint64_t begin_ns, uint64_t end_ns) {
+  if (!m_recording.load(std::memory_order_acquire)) {
+    return;
+  }
+  uint64_t index = m_write_index.fetch_add(1, std::memory_order_acq_rel);
+  Slot& s = m_slots[size_t(index & (m_capacity - 1))];
+  // Mark the slot as being written, so readers skip it.
+  s.sequence.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  s.event.name = name;
+  s.event.begin_ns = begin_ns;
+  s.event.duration_ns = end_ns - begin_ns;
+  s.event.thread_id = current_thread_id();
+  s.sequence.store(index + 1, std::memory_order_release);
+}
+
+void Tracer::WriteChromeTrace(std::string* out) const {
+  out->append("{\"traceEvents\":[\n");
+  bool first = true;
+  ForEachEvent([out, &first](const Event& event) {
+    // Times are in microseconds, with nanosecond precision.
+    char buffer[512];
+    int length = snprintf(
+        buffer, sizeof(buffer),
+        "%s{\"name\":\"%s\",\"cat\":\"el\",\"ph\":\"X\",\"pid\":1,"
+        "\"tid\":%u,\"ts\":%" PRIu64 ".%03u,\"dur\":%" PRIu64 ".%03u}",
+        first ? "" : ",\n", event.name, event.thread_id,
+        event.begin_ns / 1000, unsigned(event.begin_ns % 1000),
+        event.duration_ns / 1000, unsigned(event.duration_ns % 1000));
+    if (length > 0 && size_t(length) < sizeof(buffer)) {
+      out->append(buffer, length);
+      first = false;
+    }
+  });
+  out->append("\n],\"displayTimeUnit\":\"ns\"}\n");
+}
+
+bool Tracer::SaveChromeTrace(const std::string& filename) const {
+  std::string data;
+  WriteChromeTrace(&data);
+  FILE* file = fopen(filename.c_str(), "wb");
+  if (!file) {
+    return false;
+  }
+  bool success = fwrite(data.data(), 1, data.size(), file) == data.size();
+  fclose(file);
+  return success;
+}
+
+uint64_t Tracer::now_ns() {
+  return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now().time_since_epoch())
+                      .count());
+}
+
+uint32_t Tracer::current_thread_id() {
+  static std::atomic<uint32_t> next_thread_id(1);
+  thread_local uint32_t thread_id =
+      next_thread_id.fetch_add(1, std::memory_order_relaxed);
+  return thread_id;
+}
+
+const Tracer::Slot* Tracer::slot(uint64_t index) const {
+  return &m_slots[size_t(index & (m_capacity - 1))];
+}
+
+}  // namespace util
+}  // namespace el
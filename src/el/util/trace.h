@@ -0,0 +1,164 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#ifndef EL_UTIL_TRACE_H_
+#define EL_UTIL_TRACE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "el/config.h"
+
+namespace el {
+namespace util {
+
+// Records timed zones of code into a fixed size ring buffer, which can be
+// exported as a Chrome trace (chrome://tracing or https://ui.perfetto.dev) to
+// see where the time of a frame goes.
+//
+// Zones are added with EL_TRACE_ZONE, which compiles to nothing unless
+// EL_TRACE is defined (See config.h). When compiled in, a zone costs a relaxed
+// atomic load while the tracer is stopped.
+//
+// Recording is lock free and may happen from any thread: each event claims a
+// slot by incrementing the write index, so the oldest events are overwritten
+// when the buffer is full. Start, Stop and the export should be called from
+// one thread (typically the main thread between frames).
+class Tracer {
+ public:
+  static Tracer* get() { return &tracer_singleton_; }
+
+  // One recorded zone.
+  struct Event {
+    // Static string naming the zone.
+    const char* name;
+    // Start time and duration in nanoseconds (See now_ns).
+    uint64_t begin_ns;
+    uint64_t duration_ns;
+    // Small number identifying the recording thread.
+    uint32_t thread_id;
+  };
+
+  static const size_t kDefaultCapacity = 64 * 1024;
+
+  Tracer();
+  ~Tracer();
+
+  // Returns true if events are currently recorded.
+  bool is_recording() const {
+    return m_recording.load(std::memory_order_relaxed);
+  }
+
+  // Starts recording events, dropping any previously recorded ones.
+  // The buffer holding the last capacity events (rounded up to a power of
+  // two) is allocated on the first call. Later calls keep its size.
+  void Start(size_t capacity = kDefaultCapacity);
+  // Stops recording events. The recorded events are kept until the next
+  // Start.
+  void Stop();
+
+  // Records a zone that started at begin_ns and ended at end_ns.
+  // Does nothing if not recording.
+  void Record(const char* name, uint64_t begin_ns, uint64_t end_ns);
+
+  // Gets the number of events recorded since Start, including the ones that
+  // have been overwritten.
+  uint64_t recorded_count() const {
+    return m_write_index.load(std::memory_order_acquire);
+  }
+
+  // Gets the events still in the buffer, oldest first, calling the callback
+  // for each. Events that are being written concurrently are skipped.
+  template <typename T>
+  void ForEachEvent(const T& callback) const;
+
+  // Writes the events in the buffer as Chrome trace JSON (complete events)
+  // to out.
+  void WriteChromeTrace(std::string* out) const;
+  // Writes the Chrome trace JSON to the given file.
+  bool SaveChromeTrace(const std::string& filename) const;
+
+  // Gets a monotonic time in nanoseconds, used for the event times.
+  static uint64_t now_ns();
+
+ private:
+  struct Slot {
+    Event event;
+    // The write index + 1 of the event in the slot, stored after the event
+    // so readers can tell if the slot holds a complete event.
+    std::atomic<uint64_t> sequence;
+  };
+
+  static uint32_t current_thread_id();
+  const Slot* slot(uint64_t index) const;
+
+  static Tracer tracer_singleton_;
+
+  std::unique_ptr<Slot[]> m_slots;
+  size_t m_capacity = 0;
+  std::atomic<uint64_t> m_write_index;
+  std::atomic<bool> m_recording;
+};
+
+template <typename T>
+void Tracer::ForEachEvent(const T& callback) const {
+  uint64_t end = recorded_count();
+  uint64_t begin = end > m_capacity ? end - m_capacity : 0;
+  for (uint64_t index = begin; index < end; ++index) {
+    const Slot* s = slot(index);
+    if (s->sequence.load(std::memory_order_acquire) != index + 1) {
+      continue;
+    }
+    Event event = s->event;
+    // Skip the event if it was overwritten while it was copied.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (s->sequence.load(std::memory_order_relaxed) != index + 1) {
+      continue;
+    }
+    callback(event);
+  }
+}
+
+// Records the time from construction to destruction as a zone with the given
+// name, if the tracer was recording at construction.
+class TraceScope {
+ public:
+  explicit TraceScope(const char* name)
+      : m_name(name),
+        m_begin_ns(Tracer::get()->is_recording() ? Tracer::now_ns() : 0) {}
+  ~TraceScope() {
+    if (m_begin_ns) {
+      Tracer::get()->Record(m_name, m_begin_ns, Tracer::now_ns());
+    }
+  }
+
+ private:
+  const char* m_name;
+  uint64_t m_begin_ns;
+};
+
+}  // namespace util
+}  // namespace el
+
+#define EL_TRACE_CONCAT_(a, b) a##b
+#define EL_TRACE_CONCAT(a, b) EL_TRACE_CONCAT_(a, b)
+
+#ifdef EL_TRACE
+// Records the rest of the current scope as a trace zone named by the given
+// string literal.
+#define EL_TRACE_ZONE(name) \
+  el::util::TraceScope EL_TRACE_CONCAT(trace_zone_, __LINE__)(name)
+#else
+#define EL_TRACE_ZONE(name)
+#endif  // EL_TRACE
+
+#endif  // EL_UTIL_TRACE_H_
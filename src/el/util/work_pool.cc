@@ -0,0 +1,157 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include "el/util/work_pool.h"
+
+namespace el {
+namespace util {
+
+namespace {
+
+// True on threads currently running work of a pool.
+thread_local bool is_running_work = false;
+
+uint64_t PackRange(uint64_t begin, uint64_t end) { return begin | end << 32; }
+size_t RangeBegin(uint64_t bounds) { return size_t(bounds & 0xffffffff); }
+size_t RangeEnd(uint64_t bounds) { return size_t(bounds >> 32); }
+
+}  // namespace
+
+std::atomic<int> WorkPool::parallel_count_(0);
+
+WorkPool::WorkPool(size_t thread_count) {
+  if (thread_count < 1) {
+    thread_count = 1;
+  }
+  m_ranges.reset(new Range[thread_count]);
+  for (size_t i = 1; i < thread_count; ++i) {
+    m_threads.emplace_back(&WorkPool::WorkerMain, this, i);
+  }
+}
+
+WorkPool::~WorkPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_exiting = true;
+  }
+  m_start_condition.notify_all();
+  for (auto& thread : m_threads) {
+    thread.join();
+  }
+}
+
+void WorkPool::ParallelFor(size_t count,
+                           const std::function<void(size_t)>& function) {
+  // Ranges pack indices in 32 bits.
+  if (m_threads.empty() || is_running_work || count < 2 ||
+      count > 0xffffffff) {
+    for (size_t i = 0; i < count; ++i) {
+      function(i);
+    }
+    return;
+  }
+
+  const size_t threads = thread_count();
+  for (size_t i = 0; i < threads; ++i) {
+    m_ranges[i].bounds.store(
+        PackRange(count * i / threads, count * (i + 1) / threads),
+        std::memory_order_relaxed);
+  }
+  parallel_count_.fetch_add(1, std::memory_order_acq_rel);
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_function = &function;
+    m_running_count = m_threads.size();
+    ++m_generation;
+  }
+  m_start_condition.notify_all();
+
+  Run(0);
+
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done_condition.wait(lock, [this] { return m_running_count == 0; });
+    m_function = nullptr;
+  }
+  parallel_count_.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void WorkPool::WorkerMain(size_t thread_index) {
+  uint64_t generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_start_condition.wait(lock, [this, generation] {
+        return m_exiting || m_generation != generation;
+      });
+      if (m_exiting) {
+        return;
+      }
+      generation = m_generation;
+    }
+    Run(thread_index);
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (--m_running_count == 0) {
+        m_done_condition.notify_one();
+      }
+    }
+  }
+}
+
+void WorkPool::Run(size_t thread_index) {
+  is_running_work = true;
+  size_t index;
+  while (TakeIndex(thread_index, &index)) {
+    (*m_function)(index);
+  }
+  is_running_work = false;
+}
+
+bool WorkPool::TakeIndex(size_t thread_index, size_t* out_index) {
+  // Take the first index of the own range.
+  Range& own = m_ranges[thread_index];
+  uint64_t bounds = own.bounds.load(std::memory_order_acquire);
+  while (RangeBegin(bounds) < RangeEnd(bounds)) {
+    if (own.bounds.compare_exchange_weak(
+            bounds, PackRange(RangeBegin(bounds) + 1, RangeEnd(bounds)),
+            std::memory_order_acq_rel)) {
+      *out_index = RangeBegin(bounds);
+      return true;
+    }
+  }
+
+  // Steal the second half of the range of another thread. The first stolen
+  // index is run now and the rest becomes the own range.
+  const size_t threads = thread_count();
+  for (size_t i = 1; i < threads; ++i) {
+    Range& victim = m_ranges[(thread_index + i) % threads];
+    bounds = victim.bounds.load(std::memory_order_acquire);
+    while (RangeBegin(bounds) < RangeEnd(bounds)) {
+      size_t begin = RangeBegin(bounds);
+      size_t end = RangeEnd(bounds);
+      size_t middle = begin + (end - begin) / 2;
+      if (victim.bounds.compare_exchange_weak(bounds, PackRange(begin, middle),
+                                              std::memory_order_acq_rel)) {
+        own.bounds.store(PackRange(middle + 1, end), std::memory_order_release);
+        *out_index = middle;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+std::recursive_mutex& SharedStateLock::mutex() {
+  static std::recursive_mutex shared_state_mutex;
+  return shared_state_mutex;
+}
+
+}  // namespace util
+}  // namespace el
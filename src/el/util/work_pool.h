@@ -0,0 +1,112 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#ifndef EL_UTIL_WORK_POOL_H_
+#define EL_UTIL_WORK_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace el {
+namespace util {
+
+// A pool of threads running the iterations of a loop in parallel (See
+// ParallelFor).
+//
+// Each thread starts on its own contiguous part of the iterations. A thread
+// that runs out of work steals the second half of what remains for another
+// thread, so uneven iterations (f.ex measuring a few large subtrees among
+// many small ones) keep all threads busy.
+class WorkPool {
+ public:
+  // Creates a pool running work on thread_count threads: the thread calling
+  // ParallelFor, and thread_count - 1 worker threads.
+  explicit WorkPool(size_t thread_count);
+  ~WorkPool();
+
+  size_t thread_count() const { return m_threads.size() + 1; }
+
+  // Calls function(index) for every index in [0, count) and returns when all
+  // calls are done. The calls run in parallel on the threads of the pool.
+  // Calls made from within a ParallelFor of any pool run serially on the
+  // calling thread.
+  void ParallelFor(size_t count, const std::function<void(size_t)>& function);
+
+  // Returns true while any pool runs work in parallel. Code touching state
+  // that isn't owned by the work itself must then be synchronized (See
+  // SharedStateLock).
+  static bool is_running_parallel() {
+    return parallel_count_.load(std::memory_order_acquire) != 0;
+  }
+
+ private:
+  // Iterations left for one thread, as begin | end << 32. The owner takes
+  // from the beginning and thieves take from the end. Padded so the ranges of
+  // different threads don't share cache lines.
+  struct Range {
+    std::atomic<uint64_t> bounds;
+    uint8_t padding[64 - sizeof(std::atomic<uint64_t>)];
+  };
+
+  void WorkerMain(size_t thread_index);
+  void Run(size_t thread_index);
+  // Takes the next index for the given thread, from its own range or stolen
+  // from another thread. Returns false when there's no work left.
+  bool TakeIndex(size_t thread_index, size_t* out_index);
+
+  static std::atomic<int> parallel_count_;
+
+  std::vector<std::thread> m_threads;
+  std::unique_ptr<Range[]> m_ranges;
+  const std::function<void(size_t)>* m_function = nullptr;
+
+  std::mutex m_mutex;
+  std::condition_variable m_start_condition;
+  std::condition_variable m_done_condition;
+  uint64_t m_generation = 0;
+  size_t m_running_count = 0;
+  bool m_exiting = false;
+};
+
+// Serializes access to state that is shared by all elements and created on
+// demand, such as glyph metrics and lazily loaded skin bitmaps, while a
+// WorkPool runs work in parallel. Does nothing otherwise, so it costs an
+// atomic load in the normal single threaded case.
+class SharedStateLock {
+ public:
+  SharedStateLock() : m_locked(WorkPool::is_running_parallel()) {
+    if (m_locked) {
+      mutex().lock();
+    }
+  }
+  ~SharedStateLock() {
+    if (m_locked) {
+      mutex().unlock();
+    }
+  }
+  SharedStateLock(const SharedStateLock&) = delete;
+  SharedStateLock& operator=(const SharedStateLock&) = delete;
+
+ private:
+  static std::recursive_mutex& mutex();
+
+  bool m_locked;
+};
+
+}  // namespace util
+}  // namespace el
+
+#endif  // EL_UTIL_WORK_POOL_H_
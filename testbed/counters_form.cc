@@ -0,0 +1,63 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * ©2015 Ben Vanik. All rights reserved. Released under the BSD license.      *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <string>
+
+#include "el/util/counters.h"
+#include "el/util/metrics.h"
+#include "testbed/counters_form.h"
+
+namespace testbed {
+
+using el::util::Counter;
+using el::util::Counters;
+
+CountersForm::CountersForm(Element* root) {
+  set_text("Performance counters");
+  LoadData(
+      "TextBox: id: 'output', gravity: all, multiline: 1, readonly: 1, "
+      "adapt-to-content: 1");
+  output_ = GetElementById<elements::TextBox>(TBIDC("output"));
+  UpdateOutput();
+
+  Rect bounds(0, 0, root->rect().w, root->rect().h);
+  set_rect(GetResizeToFitContentRect().MoveIn(bounds).Clip(bounds));
+
+  root->AddChild(this);
+}
+
+void CountersForm::OnProcess() {
+  Form::OnProcess();
+  if (util::GetTimeMS() - last_update_ms_ >= kUpdateIntervalMs) {
+    UpdateOutput();
+  }
+}
+
+void CountersForm::UpdateOutput() {
+  last_update_ms_ = util::GetTimeMS();
+  auto counters = Counters::get();
+  std::string text;
+  char line[128];
+  snprintf(line, sizeof(line), "frames: %" PRIu64 "\n",
+           counters->frame_count());
+  text.append(line);
+  for (size_t i = 0; i < Counters::kCounterCount; ++i) {
+    Counter counter = Counter(i);
+    snprintf(line, sizeof(line), "%s: %" PRIu64 " (total %" PRIu64 ")\n",
+             Counters::name(counter), counters->frame_value(counter),
+             counters->total_value(counter));
+    text.append(line);
+  }
+  text.pop_back();
+  output_->set_text(text.c_str());
+}
+
+}  // namespace testbed
@@ -0,0 +1,46 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * ©2015 Ben Vanik. All rights reserved. Released under the BSD license.      *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#ifndef TESTBED_COUNTERS_FORM_H_
+#define TESTBED_COUNTERS_FORM_H_
+
+#include <cstdint>
+
+#include "el/elements/form.h"
+#include "el/elements/text_box.h"
+
+namespace testbed {
+
+using namespace el;
+
+// Lists the performance counters (See util::Counters) of the last frame and
+// their totals, updated every kUpdateIntervalMs.
+class CountersForm : public elements::Form {
+ public:
+  TBOBJECT_SUBCLASS(CountersForm, elements::Form);
+
+  // How often the counters are shown. Showing them invalidates the form,
+  // which causes a new frame, so it's not done every frame.
+  static const uint64_t kUpdateIntervalMs = 500;
+
+  // Creates the form and adds it to root.
+  explicit CountersForm(Element* root);
+
+  void OnProcess() override;
+
+ private:
+  void UpdateOutput();
+
+  elements::TextBox* output_ = nullptr;
+  uint64_t last_update_ms_ = 0;
+};
+
+}  // namespace testbed
+
+#endif  // TESTBED_COUNTERS_FORM_H_
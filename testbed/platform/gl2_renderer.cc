@@ -7,6 +7,7 @@
  ******************************************************************************
  */
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
 
@@ -27,6 +28,10 @@ GL2Renderer::GL2Bitmap::~GL2Bitmap() {
   if (handle_ == renderer_->current_texture_) {
     renderer_->BindBitmap(nullptr);
   }
+  assert(renderer_->render_target_ != this);
+  if (framebuffer_) {
+    glDeleteFramebuffersEXT(1, &framebuffer_);
+  }
   glDeleteTextures(1, &handle_);
 }
 
@@ -47,6 +52,18 @@ bool GL2Renderer::GL2Bitmap::Init(int width, int height, uint32_t* data) {
   return true;
 }
 
+bool GL2Renderer::GL2Bitmap::InitRenderTarget() {
+  glGenFramebuffersEXT(1, &framebuffer_);
+  glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, framebuffer_);
+  glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT,
+                            GL_TEXTURE_2D, handle_, 0);
+  GLenum status = glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT);
+  glBindFramebufferEXT(
+      GL_FRAMEBUFFER_EXT,
+      renderer_->render_target_ ? renderer_->render_target_->framebuffer_ : 0);
+  return status == GL_FRAMEBUFFER_COMPLETE_EXT;
+}
+
 void GL2Renderer::GL2Bitmap::set_data(uint32_t* data) {
   renderer_->FlushBitmap(this);
   renderer_->BindBitmap(this);
@@ -74,12 +91,19 @@ GL2Renderer::GL2Renderer() {
       "\
     uniform sampler2D texture_sampler;\n\
     uniform float texture_mix;\n\
+    uniform float distance_field;\n\
     varying vec4 vtx_color;\n\
     varying vec2 vtx_uv;\n\
     void main() {\n\
       gl_FragColor = vtx_color;\n\
       if (texture_mix > 0.0) {\n\
-        gl_FragColor *= texture2D(texture_sampler, vtx_uv).rgba;\n\
+        vec4 texel = texture2D(texture_sampler, vtx_uv);\n\
+        if (distance_field > 0.0) {\n\
+          float w = clamp(fwidth(texel.a) * 0.7, 0.001, 0.5);\n\
+          gl_FragColor.a *= smoothstep(0.5 - w, 0.5 + w, texel.a);\n\
+        } else {\n\
+          gl_FragColor *= texel;\n\
+        }\n\
       }\n\
     }\n\
     ";
@@ -113,6 +137,7 @@ GL2Renderer::GL2Renderer() {
   projection_matrix_loc_ = glGetUniformLocation(program_, "projection_matrix");
   texture_sampler_loc_ = glGetUniformLocation(program_, "texture_sampler");
   texture_mix_loc_ = glGetUniformLocation(program_, "texture_mix");
+  distance_field_loc_ = glGetUniformLocation(program_, "distance_field");
 }
 
 GL2Renderer::~GL2Renderer() { glDeleteProgram(program_); }
@@ -123,9 +148,11 @@ void GL2Renderer::BeginPaint(int render_target_w, int render_target_h) {
   Renderer::BeginPaint(render_target_w, render_target_h);
 
   current_texture_ = 0;
+  current_distance_field_ = false;
+  current_premultiplied_ = false;
+  render_target_ = nullptr;
   batch_.vertices = vertices_;
 
-  // Ortho2D(0, (GLfloat)render_target_w, (GLfloat)render_target_h, 0);
   glViewport(0, 0, render_target_w, render_target_h);
   glScissor(0, 0, render_target_w, render_target_h);
 
@@ -137,22 +164,9 @@ void GL2Renderer::BeginPaint(int render_target_w, int render_target_h) {
 
   glUseProgram(program_);
 
-  float left = 0.0f;
-  float right = float(render_target_w);
-  float bottom = float(render_target_h);
-  float top = 0.0f;
-  float z_near = -1.0f;
-  float z_far = 1.0f;
-  float projection[16] = {0};
-  projection[0] = 2.0f / (right - left);
-  projection[5] = 2.0f / (top - bottom);
-  projection[10] = -2.0f / (z_far - z_near);
-  projection[12] = -(right + left) / (right - left);
-  projection[13] = -(top + bottom) / (top - bottom);
-  projection[14] = -(z_far + z_near) / (z_far - z_near);
-  projection[15] = 1.0f;
-  glUniformMatrix4fv(projection_matrix_loc_, 1, GL_FALSE, projection);
+  UpdateProjection();
   glUniform1f(texture_mix_loc_, 0.0f);
+  glUniform1f(distance_field_loc_, 0.0f);
 
   glBindBuffer(GL_ARRAY_BUFFER, 0);
   glEnableVertexAttribArray(0);
@@ -191,19 +205,94 @@ std::unique_ptr<el::graphics::Bitmap> GL2Renderer::CreateBitmap(
   return std::unique_ptr<el::graphics::Bitmap>(std::move(bitmap));
 }
 
+std::unique_ptr<el::graphics::Bitmap> GL2Renderer::CreateRenderTarget(
+    int width, int height) {
+  if (!GLAD_GL_EXT_framebuffer_object) {
+    return nullptr;
+  }
+  auto bitmap = std::make_unique<GL2Bitmap>(this);
+  if (!bitmap->Init(el::util::GetNearestPowerOfTwo(std::max(width, 1)),
+                    el::util::GetNearestPowerOfTwo(std::max(height, 1)),
+                    nullptr) ||
+      !bitmap->InitRenderTarget()) {
+    return nullptr;
+  }
+  return std::unique_ptr<el::graphics::Bitmap>(std::move(bitmap));
+}
+
 void GL2Renderer::RenderBatch(Batch* batch) {
   if (current_texture_ && !batch->bitmap) {
     glUniform1f(texture_mix_loc_, 0.0f);
   } else if (!current_texture_ && batch->bitmap) {
     glUniform1f(texture_mix_loc_, 1.0f);
   }
+  if (current_distance_field_ != batch->is_distance_field) {
+    current_distance_field_ = batch->is_distance_field;
+    glUniform1f(distance_field_loc_, current_distance_field_ ? 1.0f : 0.0f);
+  }
+  if (current_premultiplied_ != batch->is_premultiplied) {
+    current_premultiplied_ = batch->is_premultiplied;
+    UpdateBlendFunc();
+  }
   BindBitmap(batch->bitmap);
   glDrawArrays(GL_TRIANGLES, 0, uint32_t(batch->vertex_count));
 }
 
 void GL2Renderer::set_clip_rect(const el::Rect& rect) {
-  glScissor(clip_rect_.x, screen_rect_.h - (clip_rect_.y + clip_rect_.h),
-            clip_rect_.w, clip_rect_.h);
+  // Render targets are drawn upside down (See UpdateProjection).
+  int y = render_target_ ? rect.y : screen_rect_.h - (rect.y + rect.h);
+  glScissor(rect.x, y, rect.w, rect.h);
+}
+
+void GL2Renderer::set_render_target(el::graphics::Bitmap* target,
+                                    bool clear) {
+  render_target_ = static_cast<GL2Bitmap*>(target);
+  glBindFramebufferEXT(GL_FRAMEBUFFER_EXT,
+                       render_target_ ? render_target_->framebuffer_ : 0);
+  glViewport(0, 0, screen_rect_.w, screen_rect_.h);
+  UpdateProjection();
+  UpdateBlendFunc();
+  if (clear) {
+    glDisable(GL_SCISSOR_TEST);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glEnable(GL_SCISSOR_TEST);
+  }
+}
+
+void GL2Renderer::UpdateProjection() {
+  // Ortho2D(0, w, h, 0) for the screen. Render targets are flipped so the
+  // top row ends up first in the texture, where texture coordinates start.
+  float left = 0.0f;
+  float right = float(screen_rect_.w);
+  float bottom = float(screen_rect_.h);
+  float top = 0.0f;
+  if (render_target_) {
+    std::swap(top, bottom);
+  }
+  float z_near = -1.0f;
+  float z_far = 1.0f;
+  float projection[16] = {0};
+  projection[0] = 2.0f / (right - left);
+  projection[5] = 2.0f / (top - bottom);
+  projection[10] = -2.0f / (z_far - z_near);
+  projection[12] = -(right + left) / (right - left);
+  projection[13] = -(top + bottom) / (top - bottom);
+  projection[14] = -(z_far + z_near) / (z_far - z_near);
+  projection[15] = 1.0f;
+  glUniformMatrix4fv(projection_matrix_loc_, 1, GL_FALSE, projection);
+}
+
+void GL2Renderer::UpdateBlendFunc() {
+  if (current_premultiplied_) {
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+  } else if (render_target_) {
+    // Keep the colors premultiplied with alpha.
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE,
+                        GL_ONE_MINUS_SRC_ALPHA);
+  } else {
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  }
 }
 
 void GL2Renderer::BindBitmap(el::graphics::Bitmap* bitmap) {
@@ -28,6 +28,11 @@ class GL2Renderer : public el::graphics::Renderer {
 
   std::unique_ptr<el::graphics::Bitmap> CreateBitmap(int width, int height,
                                                      uint32_t* data) override;
+  // Render targets need GL_EXT_framebuffer_object.
+  std::unique_ptr<el::graphics::Bitmap> CreateRenderTarget(
+      int width, int height) override;
+
+  bool supports_distance_field() const override { return true; }
 
  protected:
   class GL2Bitmap : public el::graphics::Bitmap {
@@ -36,6 +41,8 @@ class GL2Renderer : public el::graphics::Renderer {
     ~GL2Bitmap() override;
 
     bool Init(int width, int height, uint32_t* data);
+    // Creates a framebuffer object drawing into the texture.
+    bool InitRenderTarget();
     int width() override { return width_; }
     int height() override { return height_; }
     void set_data(uint32_t* data) override;
@@ -45,6 +52,7 @@ class GL2Renderer : public el::graphics::Renderer {
     int width_ = 0;
     int height_ = 0;
     GLuint handle_ = 0;
+    GLuint framebuffer_ = 0;
   };
 
   static const uint32_t kMaxVertexBatchSize = 6 * 2048;
@@ -52,15 +60,25 @@ class GL2Renderer : public el::graphics::Renderer {
   size_t max_vertex_batch_size() const override { return kMaxVertexBatchSize; }
   void RenderBatch(Batch* batch) override;
   void set_clip_rect(const el::Rect& rect) override;
+  void set_render_target(el::graphics::Bitmap* target, bool clear) override;
 
   void BindBitmap(el::graphics::Bitmap* bitmap);
+  // Sets the projection mapping pixels to the viewport of the current render
+  // target (screen_rect_).
+  void UpdateProjection();
+  // Sets the blend function for the current render target and batch.
+  void UpdateBlendFunc();
 
   GLuint program_ = 0;
   GLuint projection_matrix_loc_ = 0;
   GLuint texture_sampler_loc_ = 0;
   GLuint texture_mix_loc_ = 0;
+  GLuint distance_field_loc_ = 0;
 
   GLuint current_texture_ = 0;
+  bool current_distance_field_ = false;
+  bool current_premultiplied_ = false;
+  GL2Bitmap* render_target_ = nullptr;
   Vertex vertices_[kMaxVertexBatchSize];
 
   size_t bitmap_validations_ = 0;
@@ -18,6 +18,7 @@
 #include "el/element_animation_manager.h"
 #include "el/elemental_forms.h"
 #include "el/elements.h"
+#include "el/frame_scheduler.h"
 #include "el/io/file_manager.h"
 #include "el/io/memory_file_system.h"
 #include "el/io/posix_file_system.h"
@@ -31,6 +32,7 @@
 #include "el/util/string.h"
 #include "el/util/string_builder.h"
 #include "el/util/string_table.h"
+#include "testbed/counters_form.h"
 #include "testbed/list_window.h"
 #include "testbed/resource_edit_window.h"
 #include "testbed/scratch/code_text_box.h"
@@ -163,9 +165,7 @@ void TestbedApplication::ShutDown() {
 }
 
 void TestbedApplication::Process() {
-  AnimationManager::Update();
-  GetRoot()->InvokeProcessStates();
-  GetRoot()->InvokeProcess();
+  FrameScheduler::get()->RunFrame(GetRoot());
 }
 
 void TestbedApplication::RenderFrame(int window_w, int window_h) {
@@ -201,9 +201,10 @@ void TestbedApplication::RenderFrame(int window_w, int window_h) {
 
   Renderer::get()->EndPaint();
 
-  // If we want continous updates or got animations running, reinvalidate
-  // immediately
-  if (continuous_repaint || AnimationManager::has_running_animations()) {
+  // If we want continous updates, got animations running or work left for
+  // later frames, reinvalidate immediately
+  if (continuous_repaint || AnimationManager::has_running_animations() ||
+      FrameScheduler::get()->has_pending_tasks()) {
     GetRoot()->Invalidate();
   }
 }
@@ -221,7 +222,8 @@ int app_main() {
   // el::io::FileManager::RegisterFileSystem(
   //    std::make_unique<el::io::PosixFileSystem>("./resources"));
   el::io::FileManager::RegisterFileSystem(
-      std::make_unique<el::io::PosixFileSystem>("./testbed/resources"));
+      std::make_unique<el::io::PosixFileSystem>("./testbed/resources",
+                                                  true));
   el::io::FileManager::RegisterFileSystem(
       std::make_unique<el::io::Win32ResFileSystem>("IDR_default_resources_"));
   el::io::FileManager::RegisterFileSystem(
@@ -946,6 +948,10 @@ bool MainWindow::OnEvent(const Event& ev) {
     } else if (ev.target->id() == TBIDC("test-dsl")) {
       new DslWindow();
       return true;
+    } else if (ev.type == EventType::kClick &&
+               ev.target->id() == TBIDC("performance counters")) {
+      new CountersForm(parent_root());
+      return true;
     } else if (ev.type == EventType::kClick &&
                ev.target->id() == TBIDC("debug settings")) {
 #ifdef EL_RUNTIME_DEBUG_INFO
@@ -0,0 +1,192 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+// Measures the memory footprint of elements and the speed of walking large
+// element trees, which is dominated by cache misses.
+//
+// Usage: elemental-forms-element-benchmark [element count]
+//
+// Builds a tree of about 100k plain elements (by default) and reports the
+// size of common element types and the time per element of a paint-like
+// traversal, of hit testing with GetElementAt, and of building and deleting
+// the tree. Deferred deletion is reported as the time to remove the tree
+// (spent in the frame) and the time to flush the ElementDeleteQueue.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "el/element.h"
+#include "el/element_delete_queue.h"
+#include "el/elemental_forms.h"
+#include "el/elements.h"
+#include "tools/benchmarks/null_renderer.h"
+
+namespace {
+
+using el::Element;
+using el::Rect;
+
+// Minimum time to run each measurement.
+const double kMinSeconds = 0.5;
+// Number of children of each element that isn't a leaf.
+const int kFanout = 10;
+
+// Adds children to parent until the tree has element_count elements, splitting
+// the parent rect between the children along alternating axes.
+void BuildTree(Element* root, size_t element_count) {
+  std::vector<Element*> level = {root};
+  size_t count = 1;
+  bool split_x = true;
+  while (count < element_count) {
+    std::vector<Element*> next_level;
+    for (Element* parent : level) {
+      Rect rect = parent->rect();
+      for (int i = 0; i < kFanout && count < element_count; ++i, ++count) {
+        Element* child = new Element();
+        if (split_x) {
+          child->set_rect(
+              Rect(rect.w * i / kFanout, 0, rect.w / kFanout, rect.h));
+        } else {
+          child->set_rect(
+              Rect(0, rect.h * i / kFanout, rect.w, rect.h / kFanout));
+        }
+        parent->AddChild(child);
+        next_level.push_back(child);
+      }
+    }
+    level.swap(next_level);
+    split_x = !split_x;
+  }
+}
+
+// Visits all elements like painting does, checking visibility, opacity and the
+// rect against a clip rect.
+size_t PaintWalk(Element* element, const Rect& clip_rect) {
+  size_t visited = 1;
+  for (Element* child = element->first_child(); child;
+       child = child->GetNext()) {
+    if (child->visibility() != el::Visibility::kVisible ||
+        child->opacity() == 0) {
+      continue;
+    }
+    Rect rect = child->rect();
+    if (!rect.intersects(clip_rect)) {
+      continue;
+    }
+    visited += PaintWalk(child, clip_rect.Offset(-rect.x, -rect.y));
+  }
+  return visited;
+}
+
+// Runs fn repeatedly for at least kMinSeconds and returns the average time in
+// seconds per call.
+template <typename F>
+double MeasureSeconds(F fn) {
+  using Clock = std::chrono::steady_clock;
+  size_t iterations = 0;
+  auto start = Clock::now();
+  double seconds = 0;
+  do {
+    fn();
+    ++iterations;
+    seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  } while (seconds < kMinSeconds);
+  return seconds / iterations;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  size_t element_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 0;
+  if (!element_count) {
+    element_count = 111111;
+  }
+
+  auto renderer = std::make_unique<benchmarks::NullRenderer>();
+  el::Initialize(renderer.get());
+
+  printf("sizeof(Element)         %5zu\n", sizeof(Element));
+  printf("sizeof(LayoutBox)       %5zu\n", sizeof(el::elements::LayoutBox));
+  printf("sizeof(Label)           %5zu\n", sizeof(el::elements::Label));
+  printf("sizeof(Button)          %5zu\n", sizeof(el::elements::Button));
+  printf("sizeof(TextBox)         %5zu\n", sizeof(el::elements::TextBox));
+  printf("sizeof(ListBox)         %5zu\n", sizeof(el::elements::ListBox));
+
+  const Rect kRootRect(0, 0, 100000, 100000);
+  double build_seconds = 0;
+  double delete_seconds = 0;
+  double deferred_remove_seconds = 0;
+  double deferred_flush_seconds = 0;
+  double walk_seconds = 0;
+  double hit_test_seconds = 0;
+  const int kHitTests = 10000;
+  {
+    using Clock = std::chrono::steady_clock;
+    Element root;
+    root.set_rect(kRootRect);
+    auto start = Clock::now();
+    BuildTree(&root, element_count);
+    build_seconds =
+        std::chrono::duration<double>(Clock::now() - start).count();
+
+    size_t visited = 0;
+    walk_seconds =
+        MeasureSeconds([&]() { visited = PaintWalk(&root, kRootRect); });
+    if (visited != element_count) {
+      printf("walk visited %zu of %zu elements\n", visited, element_count);
+    }
+
+    // Random points, generated up front so only the hit tests are measured.
+    std::vector<std::pair<int, int>> points(kHitTests);
+    uint32_t seed = 1;
+    for (auto& point : points) {
+      seed = seed * 1664525 + 1013904223;
+      point.first = int(seed % uint32_t(kRootRect.w));
+      seed = seed * 1664525 + 1013904223;
+      point.second = int(seed % uint32_t(kRootRect.h));
+    }
+    hit_test_seconds = MeasureSeconds([&]() {
+      for (auto& point : points) {
+        root.GetElementAt(point.first, point.second, true);
+      }
+    });
+
+    start = Clock::now();
+    root.DeleteAllChildren();
+    delete_seconds =
+        std::chrono::duration<double>(Clock::now() - start).count();
+
+    BuildTree(&root, element_count);
+    start = Clock::now();
+    root.DeleteAllChildrenDeferred();
+    auto removed = Clock::now();
+    el::ElementDeleteQueue::get()->FlushAll();
+    deferred_remove_seconds =
+        std::chrono::duration<double>(removed - start).count();
+    deferred_flush_seconds =
+        std::chrono::duration<double>(Clock::now() - removed).count();
+  }
+
+  printf("elements                %zu\n", element_count);
+  printf("build        ns/element %8.1f\n",
+         build_seconds * 1e9 / element_count);
+  printf("paint walk   ns/element %8.1f\n",
+         walk_seconds * 1e9 / element_count);
+  printf("hit test     ns/test    %8.1f\n", hit_test_seconds * 1e9 / kHitTests);
+  printf("delete       ns/element %8.1f\n",
+         delete_seconds * 1e9 / element_count);
+  printf("deferred     ms remove  %8.3f\n", deferred_remove_seconds * 1e3);
+  printf("deferred     ms flush   %8.3f\n", deferred_flush_seconds * 1e3);
+
+  el::Shutdown();
+  return 0;
+}
@@ -0,0 +1,55 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+// The porting interfaces the library leaves to the application, implemented
+// as no-ops for the benchmarks, which run without a window or event loop.
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "el/config.h"
+#include "el/util/clipboard.h"
+#include "el/util/debug.h"
+#include "el/util/timer.h"
+
+namespace el {
+namespace util {
+
+// Messages are processed every frame by the benchmarks, so there's no timer
+// to reschedule.
+void RescheduleTimer(uint64_t /*fire_time_millis*/) {}
+
+#ifndef _WIN32
+
+// The library implements the clipboard on Windows only.
+void Clipboard::Empty() {}
+
+bool Clipboard::HasText() { return false; }
+
+std::string Clipboard::GetText() { return ""; }
+
+bool Clipboard::SetText(const std::string& /*text*/) { return false; }
+
+#endif  // !_WIN32
+
+}  // namespace util
+}  // namespace el
+
+#if defined(EL_RUNTIME_DEBUG_INFO) && !defined(_WIN32)
+
+void TBDebugOut(const char* format, ...) {
+  va_list va;
+  va_start(va, format);
+  vprintf(format, va);
+  va_end(va);
+}
+
+#endif  // EL_RUNTIME_DEBUG_INFO && !_WIN32
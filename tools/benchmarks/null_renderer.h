@@ -0,0 +1,56 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+#ifndef TOOLS_BENCHMARKS_NULL_RENDERER_H_
+#define TOOLS_BENCHMARKS_NULL_RENDERER_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "el/graphics/renderer.h"
+#include "el/rect.h"
+
+namespace benchmarks {
+
+class NullBitmap : public el::graphics::Bitmap {
+ public:
+  NullBitmap(int width, int height) : width_(width), height_(height) {}
+  int width() override { return width_; }
+  int height() override { return height_; }
+  void set_data(uint32_t* /*data*/) override {}
+
+ private:
+  int width_;
+  int height_;
+};
+
+// A renderer that batches like a real one but draws nothing, to measure the
+// library alone.
+class NullRenderer : public el::graphics::Renderer {
+ public:
+  NullRenderer() { batch_.vertices = vertices_; }
+
+  std::unique_ptr<el::graphics::Bitmap> CreateBitmap(
+      int width, int height, uint32_t* /*data*/) override {
+    return std::make_unique<NullBitmap>(width, height);
+  }
+
+ protected:
+  static const size_t kMaxVertexBatchSize = 6 * 2048;
+
+  size_t max_vertex_batch_size() const override { return kMaxVertexBatchSize; }
+  void RenderBatch(Batch* /*batch*/) override {}
+  void set_clip_rect(const el::Rect& /*rect*/) override {}
+
+  Vertex vertices_[kMaxVertexBatchSize];
+};
+
+}  // namespace benchmarks
+
+#endif  // TOOLS_BENCHMARKS_NULL_RENDERER_H_
@@ -0,0 +1,148 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+// Measures the throughput of the resource file parser.
+//
+// Usage: elemental-forms-parser-benchmark [files...]
+//
+// Run from the repository root. Without arguments it parses the unit test
+// data, the default skin and language, and a generated large layout. For each
+// file it reports the throughput of tokenizing only (TextParser) and of
+// building node trees with and without an arena (ParseNode).
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "el/io/file_manager.h"
+#include "el/io/memory_file_system.h"
+#include "el/io/posix_file_system.h"
+#include "el/parsing/parse_node.h"
+#include "el/parsing/text_parser.h"
+#include "el/parsing/text_parser_stream.h"
+
+namespace {
+
+using el::parsing::ParseNode;
+using el::parsing::ReadFlags;
+using el::parsing::TextParserTarget;
+
+const char* kDefaultFiles[] = {
+    "src/el/testing/data/test_tb_parser.tb.txt",
+    "src/el/testing/data/test_tb_parser_definitions.tb.txt",
+    "src/el/testing/data/test_tb_parser_included.tb.txt",
+    "resources/default_skin/skin.tb.txt",
+    "resources/default_language/language_en.tb.txt",
+    "generated_layout.tb.txt",
+};
+
+// Minimum time to run each measurement.
+const double kMinSeconds = 0.5;
+
+// Counts tokens without doing anything else with them.
+class CountingTarget : public TextParserTarget {
+ public:
+  void OnError(int /*line_nr*/, const std::string& /*error*/) override {}
+  void OnComment(int /*line_nr*/, const char* /*comment*/) override {}
+  void OnToken(int /*line_nr*/, const char* /*name*/,
+               el::Value* /*value*/) override {
+    ++token_count;
+  }
+  void Enter() override {}
+  void Leave() override {}
+
+  size_t token_count = 0;
+};
+
+// Generates a layout with many nested elements, like a big generated form.
+std::string GenerateLayout() {
+  std::string layout;
+  for (int group = 0; group < 500; ++group) {
+    layout += "LayoutBox: axis: y, distribution-position: left top\n";
+    layout += "\tid group" + std::to_string(group) + "\n";
+    for (int row = 0; row < 20; ++row) {
+      layout += "\tLayoutBox\n";
+      layout += "\t\tLabel: text: \"Row " + std::to_string(row) +
+                " of group " + std::to_string(group) + "\"\n";
+      layout += "\t\tTextBox: id: \"edit" + std::to_string(row) +
+                "\", gravity: left right, placeholder: @search\n";
+      layout += "\t\tButton\n\t\t\ttext Ok\n\t\t\tskin Button.flat\n";
+    }
+  }
+  return layout;
+}
+
+// Runs fn repeatedly for at least kMinSeconds and returns the MB/s.
+template <typename F>
+double MeasureThroughput(size_t bytes, F fn) {
+  using Clock = std::chrono::steady_clock;
+  size_t iterations = 0;
+  auto start = Clock::now();
+  double seconds = 0;
+  do {
+    fn();
+    ++iterations;
+    seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  } while (seconds < kMinSeconds);
+  return double(bytes) * iterations / seconds / (1024 * 1024);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  el::io::FileManager::RegisterFileSystem(
+      std::make_unique<el::io::PosixFileSystem>(".", true));
+  std::string generated_layout = GenerateLayout();
+  auto memory_fs = std::make_unique<el::io::MemoryFileSystem>();
+  memory_fs->AddFile("generated_layout.tb.txt", generated_layout.data(),
+                     generated_layout.size());
+  el::io::FileManager::RegisterFileSystem(std::move(memory_fs));
+
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; ++i) {
+    files.push_back(argv[i]);
+  }
+  if (files.empty()) {
+    files.assign(std::begin(kDefaultFiles), std::end(kDefaultFiles));
+  }
+
+  printf("%-56s %9s %8s %10s %10s %10s\n", "file", "bytes", "tokens",
+         "tok MB/s", "tree MB/s", "arena MB/s");
+  for (auto& filename : files) {
+    auto contents = el::io::FileManager::OpenContents(filename);
+    if (!contents) {
+      printf("%-56s not found\n", filename.c_str());
+      continue;
+    }
+    const char* data = reinterpret_cast<const char*>(contents->data());
+    size_t size = contents->size();
+
+    CountingTarget counter;
+    el::parsing::DataTextParserStream stream;
+    stream.Read(data, size, &counter);
+    double tokenize_mbs = MeasureThroughput(size, [&]() {
+      CountingTarget target;
+      el::parsing::DataTextParserStream stream;
+      stream.Read(data, size, &target);
+    });
+    double tree_mbs = MeasureThroughput(size, [&]() {
+      ParseNode node;
+      node.ReadFile(filename);
+    });
+    double arena_mbs = MeasureThroughput(size, [&]() {
+      ParseNode node;
+      node.ReadFile(filename, ReadFlags::kArena);
+    });
+    printf("%-56s %9zu %8zu %10.1f %10.1f %10.1f\n", filename.c_str(), size,
+           counter.token_count, tokenize_mbs, tree_mbs, arena_mbs);
+  }
+  return 0;
+}
@@ -0,0 +1,86 @@
+project_root = "../.."
+include(project_root.."/build_tools")
+
+group("tools")
+project("elemental-forms-parser-benchmark")
+  uuid("8e4b2d1c-6f0a-4c55-a3e9-2d7b91f0c6a4")
+  kind("ConsoleApp")
+  language("C++")
+  links({
+    "elemental-forms",
+  })
+  includedirs({
+    project_root,
+    project_root.."/src",
+  })
+  files({
+    "headless_port.cc",
+    "parser_benchmark.cc",
+  })
+  debugdir(project_root)
+
+group("tools")
+project("elemental-forms-element-benchmark")
+  uuid("3c9f5a27-1b8e-4d60-9f42-7ae0c5d8b613")
+  kind("ConsoleApp")
+  language("C++")
+  links({
+    "elemental-forms",
+  })
+  includedirs({
+    project_root,
+    project_root.."/src",
+  })
+  files({
+    "element_benchmark.cc",
+    "headless_port.cc",
+    "null_renderer.h",
+  })
+  debugdir(project_root)
+
+group("tools")
+project("elemental-forms-software-renderer-benchmark")
+  uuid("b7d2e9f4-5a13-4c8e-8f06-41c3a9e7d2b5")
+  kind("ConsoleApp")
+  language("C++")
+  links({
+    "elemental-forms",
+  })
+  includedirs({
+    project_root,
+    project_root.."/src",
+  })
+  files({
+    "headless_port.cc",
+    "software_renderer_benchmark.cc",
+  })
+  debugdir(project_root)
+
+  filter("platforms:Linux")
+    links({
+      "pthread",
+    })
+
+group("tools")
+project("elemental-forms-ui-benchmark")
+  uuid("4c9e1a7b-2f3d-4b86-9a15-e8d06c2f7b43")
+  kind("ConsoleApp")
+  language("C++")
+  links({
+    "elemental-forms",
+  })
+  includedirs({
+    project_root,
+    project_root.."/src",
+  })
+  files({
+    "headless_port.cc",
+    "null_renderer.h",
+    "ui_benchmark.cc",
+  })
+  debugdir(project_root)
+
+  filter("platforms:Linux")
+    links({
+      "pthread",
+    })
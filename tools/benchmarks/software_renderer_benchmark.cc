@@ -0,0 +1,170 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+// Measures the frames per second of the software renderer drawing the testbed
+// forms, for each supported instruction set and with tiles split over
+// threads.
+//
+// Usage: elemental-forms-software-renderer-benchmark [thread count]
+//
+// Must run from the repository root (to find the resources). Each form is
+// laid out in a 1280x720 framebuffer over the testbed background, and the
+// whole frame is painted repeatedly. The thread count defaults to the number
+// of hardware threads.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+
+#include "el/animation_manager.h"
+#include "el/element.h"
+#include "el/elemental_forms.h"
+#include "el/elements.h"
+#include "el/graphics/software_renderer.h"
+#include "el/io/file_manager.h"
+#include "el/io/posix_file_system.h"
+#include "el/parsing/parse_node.h"
+#include "el/skin.h"
+#include "el/text/font_manager.h"
+#include "el/util/string_table.h"
+
+void register_tbbf_font_renderer();
+
+namespace {
+
+using el::graphics::SoftwareRenderer;
+
+// Minimum time to paint each form with each configuration.
+const double kMinSeconds = 0.5;
+const int kWidth = 1280;
+const int kHeight = 720;
+
+const char* kForms[] = {
+    "test_ui.tb.txt",
+    "test_layout01.tb.txt",
+    "test_layout02.tb.txt",
+    "test_layout03.tb.txt",
+    "test_list_item.tb.txt",
+    "test_radio_checkbox.tb.txt",
+    "test_scrollcontainer.tb.txt",
+    "test_select.tb.txt",
+    "test_skin_conditions01.tb.txt",
+    "test_tabcontainer01.tb.txt",
+    "test_textwindow.tb.txt",
+    "test_toggle_containers.tb.txt",
+    "test_batching01.tb.txt",
+};
+
+const char* SimdLevelName(SoftwareRenderer::SimdLevel level) {
+  switch (level) {
+    case SoftwareRenderer::SimdLevel::kAvx2:
+      return "avx2";
+    case SoftwareRenderer::SimdLevel::kSse2:
+      return "sse2";
+    default:
+      return "scalar";
+  }
+}
+
+// Paints the root repeatedly for at least kMinSeconds and returns the frames
+// per second.
+double MeasureFps(SoftwareRenderer* renderer, el::Element* root) {
+  using Clock = std::chrono::steady_clock;
+  size_t frames = 0;
+  auto start = Clock::now();
+  double seconds = 0;
+  do {
+    renderer->BeginPaint(kWidth, kHeight);
+    root->InvokePaint(el::Element::PaintProps());
+    renderer->EndPaint();
+    ++frames;
+    seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  } while (seconds < kMinSeconds);
+  return frames / seconds;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  int thread_count = argc > 1 ? std::atoi(argv[1]) : 0;
+  if (thread_count <= 0) {
+    thread_count = std::max(int(std::thread::hardware_concurrency()), 1);
+  }
+
+  SoftwareRenderer renderer;
+  el::Initialize(&renderer);
+  el::io::FileManager::RegisterFileSystem(
+      std::make_unique<el::io::PosixFileSystem>("./resources"));
+  el::io::FileManager::RegisterFileSystem(
+      std::make_unique<el::io::PosixFileSystem>("./testbed/resources"));
+  el::util::StringTable::get()->Load("default_language/language_en.tb.txt");
+  el::Skin::get()->Load("default_skin/skin.tb.txt");
+  el::Skin::get()->Load("skin/skin.tb.txt");
+
+  register_tbbf_font_renderer();
+  auto font_manager = el::text::FontManager::get();
+  font_manager->AddFontInfo("fonts/segoe_white_with_shadow.tb.txt", "Segoe");
+  el::FontDescription font_desc;
+  font_desc.set_id(TBIDC("Segoe"));
+  font_desc.set_size(el::Skin::get()->dimension_converter()->DpToPx(14));
+  font_manager->set_default_font_description(font_desc);
+  font_manager->CreateFontFace(font_desc);
+
+  const SoftwareRenderer::SimdLevel kLevels[] = {
+      SoftwareRenderer::SimdLevel::kScalar,
+      SoftwareRenderer::SimdLevel::kSse2,
+      SoftwareRenderer::SimdLevel::kAvx2,
+  };
+  printf("%-32s", "form (fps)");
+  for (auto level : kLevels) {
+    if (level <= SoftwareRenderer::supported_simd_level()) {
+      printf(" %8s", SimdLevelName(level));
+    }
+  }
+  printf(" %5s x%d\n", SimdLevelName(SoftwareRenderer::supported_simd_level()),
+         thread_count);
+
+  for (const char* filename : kForms) {
+    el::Element root;
+    root.set_rect(el::Rect(0, 0, kWidth, kHeight));
+    root.set_background_skin(TBIDC("background"));
+    // Show the form without the fade in animation (finished by the next
+    // AnimationManager::Update).
+    el::AnimationBlocker animation_blocker;
+    auto form = new el::elements::Form();
+    root.AddChild(form);
+    el::parsing::ParseNode node;
+    if (!node.ReadFile(filename)) {
+      printf("%-32s failed to load\n", filename);
+      continue;
+    }
+    form->LoadNodeTree(&node);
+    form->set_rect(form->GetResizeToFitContentRect().Clip(root.rect()));
+    root.InvokeProcessStates(true);
+    root.InvokeProcess();
+    el::AnimationManager::Update();
+
+    printf("%-32s", filename);
+    renderer.set_thread_count(1);
+    for (auto level : kLevels) {
+      if (level <= SoftwareRenderer::supported_simd_level()) {
+        renderer.set_simd_level(level);
+        printf(" %8.1f", MeasureFps(&renderer, &root));
+      }
+    }
+    renderer.set_simd_level(SoftwareRenderer::supported_simd_level());
+    renderer.set_thread_count(thread_count);
+    printf(" %8.1f\n", MeasureFps(&renderer, &root));
+  }
+
+  el::Shutdown();
+  return 0;
+}
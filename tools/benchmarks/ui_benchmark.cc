@@ -0,0 +1,572 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+// Replays scripted input on the testbed forms without a window, and reports
+// the time spent in each phase of the frames as JSON, to catch performance
+// regressions.
+//
+// Usage: elemental-forms-ui-benchmark [--null-renderer] [--trace file]
+//                                     [--measure-threads count] [script...]
+//
+// Must run from the repository root. The resources and scripts are read into
+// an io::MemoryFileSystem up front, so the replay doesn't touch the disk.
+// Without arguments all scripts in tools/benchmarks/scripts are run. Frames
+// are drawn with the SoftwareRenderer, or with a renderer that draws nothing
+// with --null-renderer (to measure the library alone). With --trace, the
+// trace zones of all frames are saved as Chrome trace JSON to the given file
+// (the library must be built with EL_TRACE). With --measure-threads, layouts
+// measure their children in parallel on a util::WorkPool with the given number
+// of threads (See LayoutBox::set_parallel_measure_pool).
+//
+// A script is a resource file naming a form and the input to replay:
+//
+//   form test_select.tb.txt    The form, loaded at the top left corner.
+//   list-items 5000            Items to add to the ListBox with id "list",
+//                              filtered by the TextBox with id "filter".
+//   repeat 3                   Times to replay the events.
+//   events
+//     move filter              Moves the pointer to the center of the element
+//                              with the given id, to x y in the form, or to
+//                              the form center if there is no value.
+//     click filter             Presses and releases the pointer.
+//     sweep list               Moves the pointer from the top to the bottom
+//       frames 60              of the element over the given number of frames.
+//     wheel list               Turns the wheel over the element.
+//       delta 3
+//     type "hello"             Types the text, one character per frame.
+//     key backspace            Presses a special key.
+//     resize 500 400           Resizes the form to width height.
+//     idle 10                  Runs frames without input.
+//
+// All events can be repeated on consecutive frames with a "count" child.
+//
+// Animations are blocked so the replay is deterministic. Each frame is timed
+// in phases: input (dispatching the events), process (messages, animations
+// and element states), layout (InvokeProcess) and paint. Render batches and
+// glyph cache misses are counted per frame too. The report has the mean,
+// percentiles and max of each.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "el/animation_manager.h"
+#include "el/element.h"
+#include "el/element_delete_queue.h"
+#include "el/elemental_forms.h"
+#include "el/elements.h"
+#include "el/event_handler.h"
+#include "el/graphics/software_renderer.h"
+#include "el/io/file_manager.h"
+#include "el/io/memory_file_system.h"
+#include "el/list_item.h"
+#include "el/message_handler.h"
+#include "el/parsing/parse_node.h"
+#include "el/skin.h"
+#include "el/text/font_manager.h"
+#include "el/text/utf8.h"
+#include "el/util/counters.h"
+#include "el/util/string_table.h"
+#include "el/util/trace.h"
+#include "el/util/work_pool.h"
+#include "tools/benchmarks/null_renderer.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif  // _WIN32
+
+void register_tbbf_font_renderer();
+
+namespace {
+
+using el::Element;
+using el::ModifierKeys;
+using el::Rect;
+using el::SpecialKey;
+using el::parsing::ParseNode;
+
+const int kWidth = 1280;
+const int kHeight = 720;
+const char* kScriptDir = "tools/benchmarks/scripts/";
+
+// Lists all files under root/path (recursively) as paths relative to root.
+void ListFiles(const std::string& root, const std::string& path,
+               std::vector<std::string>* out_files) {
+#ifdef _WIN32
+  WIN32_FIND_DATAA find_data;
+  HANDLE find = FindFirstFileA((root + path + "*").c_str(), &find_data);
+  if (find == INVALID_HANDLE_VALUE) {
+    return;
+  }
+  do {
+    std::string name = find_data.cFileName;
+    if (name == "." || name == "..") {
+      continue;
+    }
+    if (find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+      ListFiles(root, path + name + "/", out_files);
+    } else {
+      out_files->push_back(path + name);
+    }
+  } while (FindNextFileA(find, &find_data));
+  FindClose(find);
+#else
+  DIR* dir = opendir((root + path).c_str());
+  if (!dir) {
+    return;
+  }
+  while (dirent* entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name == "." || name == "..") {
+      continue;
+    }
+    struct stat st;
+    if (stat((root + path + name).c_str(), &st) != 0) {
+      continue;
+    }
+    if (S_ISDIR(st.st_mode)) {
+      ListFiles(root, path + name + "/", out_files);
+    } else if (S_ISREG(st.st_mode)) {
+      out_files->push_back(path + name);
+    }
+  }
+  closedir(dir);
+#endif  // _WIN32
+}
+
+// Keeps the contents of files added to a MemoryFileSystem, which doesn't copy
+// them.
+std::vector<std::unique_ptr<std::vector<uint8_t>>> file_contents;
+
+// Reads all files under root into the file system, named relative to prefix.
+void AddFiles(el::io::MemoryFileSystem* file_system, const std::string& root,
+              const std::string& prefix) {
+  std::vector<std::string> files;
+  ListFiles(root, "", &files);
+  for (auto& filename : files) {
+    FILE* file = fopen((root + filename).c_str(), "rb");
+    if (!file) {
+      continue;
+    }
+    auto data = std::make_unique<std::vector<uint8_t>>();
+    uint8_t buffer[16384];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+      data->insert(data->end(), buffer, buffer + read);
+    }
+    fclose(file);
+    file_system->AddFile(prefix + filename, data->data(), data->size());
+    file_contents.push_back(std::move(data));
+  }
+}
+
+SpecialKey GetSpecialKey(const char* name) {
+  struct {
+    const char* name;
+    SpecialKey key;
+  } const kKeys[] = {
+      {"up", SpecialKey::kUp},
+      {"down", SpecialKey::kDown},
+      {"left", SpecialKey::kLeft},
+      {"right", SpecialKey::kRight},
+      {"pageup", SpecialKey::kPageUp},
+      {"pagedown", SpecialKey::kPageDown},
+      {"home", SpecialKey::kHome},
+      {"end", SpecialKey::kEnd},
+      {"tab", SpecialKey::kTab},
+      {"backspace", SpecialKey::kBackspace},
+      {"delete", SpecialKey::kDelete},
+      {"enter", SpecialKey::kEnter},
+      {"esc", SpecialKey::kEsc},
+  };
+  for (auto& key : kKeys) {
+    if (strcmp(key.name, name) == 0) {
+      return key.key;
+    }
+  }
+  return SpecialKey::kUndefined;
+}
+
+// Measurements of one frame.
+struct FrameSample {
+  double input_us = 0;
+  double process_us = 0;
+  double layout_us = 0;
+  double paint_us = 0;
+  double frame_us = 0;
+  double batches = 0;
+  double glyph_misses = 0;
+};
+
+class ScriptRunner {
+ public:
+  explicit ScriptRunner(el::graphics::Renderer* renderer)
+      : renderer_(renderer) {}
+
+  // Loads the script and replays it. Returns false if it couldn't be loaded.
+  bool Run(const std::string& filename);
+
+  const std::vector<FrameSample>& samples() const { return samples_; }
+
+ private:
+  // Runs one frame, dispatching input first.
+  void RunFrame(const std::function<void()>& input);
+  void RunEvent(ParseNode* event);
+  // Gets the point in the root for the event target (See usage).
+  void GetTargetPoint(ParseNode* event, int* x, int* y);
+  Element* GetTarget(ParseNode* event);
+
+  el::graphics::Renderer* renderer_;
+  Element* root_ = nullptr;
+  el::elements::Form* form_ = nullptr;
+  std::vector<FrameSample> samples_;
+};
+
+bool ScriptRunner::Run(const std::string& filename) {
+  ParseNode script;
+  if (!script.ReadFile(filename)) {
+    return false;
+  }
+  ParseNode form_resource;
+  if (!form_resource.ReadFile(script.GetValueString("form", ""))) {
+    return false;
+  }
+
+  // Show the form without the fade in animation, and keep all animations
+  // from depending on time.
+  el::AnimationBlocker animation_blocker;
+  Element root;
+  root.set_rect(Rect(0, 0, kWidth, kHeight));
+  root.set_background_skin(TBIDC("background"));
+  root_ = &root;
+  form_ = new el::elements::Form();
+  root.AddChild(form_);
+  form_->LoadNodeTree(&form_resource);
+  Rect form_rect = form_->GetResizeToFitContentRect();
+  ParseNode* size = form_resource.GetNode("WindowInfo>size");
+  if (size && size->value().array_size() == 2) {
+    auto dc = el::Skin::get()->dimension_converter();
+    form_rect.w = dc->GetPxFromString(
+        size->value().as_array()->at(0)->as_string(), form_rect.w);
+    form_rect.h = dc->GetPxFromString(
+        size->value().as_array()->at(1)->as_string(), form_rect.h);
+  }
+  form_->set_rect(Rect(0, 0, form_rect.w, form_rect.h).Clip(root.rect()));
+
+  // Add items to the list, and filter them like the testbed list window.
+  el::EventHandler event_handler(form_);
+  auto list = form_->GetElementById<el::elements::ListBox>(TBIDC("list"));
+  auto filter = form_->GetElementById<el::elements::TextBox>(TBIDC("filter"));
+  int list_item_count = script.GetValueInt("list-items", 0);
+  if (list && list_item_count) {
+    auto source = list->default_source();
+    for (int i = 0; i < list_item_count; ++i) {
+      source->push_back(std::make_unique<el::GenericStringItem>(
+          el::util::format_string("Item %d", i)));
+    }
+    if (filter) {
+      event_handler.Listen(el::EventType::kChanged, filter,
+                           [list](const el::Event& ev) {
+                             list->set_filter(ev.target->text());
+                             return true;
+                           });
+    }
+  }
+
+  // The first frame lays out and paints the new form.
+  RunFrame([]() {});
+  int repeat = std::max(script.GetValueInt("repeat", 1), 1);
+  ParseNode* events = script.GetNode("events");
+  for (int i = 0; i < repeat && events; ++i) {
+    for (ParseNode* event = events->first_child(); event;
+         event = event->GetNext()) {
+      int count = std::max(event->GetValueInt("count", 1), 1);
+      for (int j = 0; j < count; ++j) {
+        RunEvent(event);
+      }
+    }
+  }
+
+  root.DeleteAllChildren();
+  el::ElementDeleteQueue::get()->FlushAll();
+  root_ = nullptr;
+  form_ = nullptr;
+  return true;
+}
+
+void ScriptRunner::RunFrame(const std::function<void()>& input) {
+  using Clock = std::chrono::steady_clock;
+  auto us = [](Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double, std::micro>(b - a).count();
+  };
+  auto counters = el::util::Counters::get();
+  uint64_t miss_count =
+      counters->total_value(el::util::Counter::kGlyphCacheMisses);
+
+  FrameSample sample;
+  auto start = Clock::now();
+  input();
+  auto input_done = Clock::now();
+  el::MessageHandler::ProcessMessages();
+  el::AnimationManager::Update();
+  root_->InvokeProcessStates();
+  auto process_done = Clock::now();
+  root_->InvokeProcess();
+  auto layout_done = Clock::now();
+  renderer_->BeginPaint(kWidth, kHeight);
+  root_->InvokePaint(Element::PaintProps());
+  renderer_->EndPaint();
+  auto paint_done = Clock::now();
+
+  sample.input_us = us(start, input_done);
+  sample.process_us = us(input_done, process_done);
+  sample.layout_us = us(process_done, layout_done);
+  sample.paint_us = us(layout_done, paint_done);
+  sample.frame_us = us(start, paint_done);
+  sample.batches = double(renderer_->frame_batch_count());
+  sample.glyph_misses = double(
+      counters->total_value(el::util::Counter::kGlyphCacheMisses) -
+      miss_count);
+  samples_.push_back(sample);
+}
+
+void ScriptRunner::RunEvent(ParseNode* event) {
+  const char* name = event->name();
+  Element* root = root_;
+  if (strcmp(name, "move") == 0) {
+    int x, y;
+    GetTargetPoint(event, &x, &y);
+    RunFrame([=]() {
+      root->InvokePointerMove(x, y, ModifierKeys::kNone, false);
+    });
+  } else if (strcmp(name, "click") == 0) {
+    int x, y;
+    GetTargetPoint(event, &x, &y);
+    RunFrame([=]() {
+      root->InvokePointerMove(x, y, ModifierKeys::kNone, false);
+      root->InvokePointerDown(x, y, 1, ModifierKeys::kNone, false);
+      root->InvokePointerUp(x, y, ModifierKeys::kNone, false);
+    });
+  } else if (strcmp(name, "sweep") == 0) {
+    Element* target = GetTarget(event);
+    Rect rect = target->rect();
+    target->parent()->ConvertToRoot(&rect.x, &rect.y);
+    int frames = std::max(event->GetValueInt("frames", 30), 1);
+    for (int i = 0; i < frames; ++i) {
+      int x = rect.x + rect.w / 2;
+      int y = rect.y + rect.h * i / frames;
+      RunFrame([=]() {
+        root->InvokePointerMove(x, y, ModifierKeys::kNone, false);
+      });
+    }
+  } else if (strcmp(name, "wheel") == 0) {
+    int x, y;
+    GetTargetPoint(event, &x, &y);
+    int delta = event->GetValueInt("delta", 1);
+    RunFrame([=]() {
+      root->InvokeWheel(x, y, 0, delta, ModifierKeys::kNone);
+    });
+  } else if (strcmp(name, "type") == 0) {
+    const char* text = event->GetValueString("", "");
+    size_t length = strlen(text);
+    for (size_t i = 0; i < length;) {
+      int ch = int(el::text::utf8::decode_next(text, &i, length));
+      RunFrame([=]() {
+        root->InvokeKey(ch, SpecialKey::kUndefined, ModifierKeys::kNone, true);
+        root->InvokeKey(ch, SpecialKey::kUndefined, ModifierKeys::kNone,
+                        false);
+      });
+    }
+  } else if (strcmp(name, "key") == 0) {
+    SpecialKey key = GetSpecialKey(event->GetValueString("", ""));
+    RunFrame([=]() {
+      root->InvokeKey(0, key, ModifierKeys::kNone, true);
+      root->InvokeKey(0, key, ModifierKeys::kNone, false);
+    });
+  } else if (strcmp(name, "resize") == 0 &&
+             event->value().array_size() == 2) {
+    el::elements::Form* form = form_;
+    Rect rect(form->rect().x, form->rect().y,
+              event->value().as_array()->at(0)->as_integer(),
+              event->value().as_array()->at(1)->as_integer());
+    RunFrame([=]() { form->set_rect(rect.Clip(root->rect())); });
+  } else if (strcmp(name, "idle") == 0) {
+    int frames = std::max(event->value().as_integer(), 1);
+    for (int i = 0; i < frames; ++i) {
+      RunFrame([]() {});
+    }
+  } else {
+    fprintf(stderr, "unknown event: %s\n", name);
+  }
+}
+
+Element* ScriptRunner::GetTarget(ParseNode* event) {
+  if (event->value().is_string()) {
+    const char* id = event->value().as_string();
+    if (Element* target = form_->GetElementById<Element>(el::TBID(id))) {
+      return target;
+    }
+    fprintf(stderr, "no element with id: %s\n", id);
+  }
+  return form_;
+}
+
+void ScriptRunner::GetTargetPoint(ParseNode* event, int* x, int* y) {
+  if (event->value().array_size() == 2) {
+    *x = form_->rect().x + event->value().as_array()->at(0)->as_integer();
+    *y = form_->rect().y + event->value().as_array()->at(1)->as_integer();
+    return;
+  }
+  Element* target = GetTarget(event);
+  *x = target->rect().w / 2;
+  *y = target->rect().h / 2;
+  target->ConvertToRoot(x, y);
+}
+
+// Prints the mean, percentiles and max of one measurement of all frames as a
+// JSON object member.
+void PrintStats(const char* name, const std::vector<FrameSample>& samples,
+                double FrameSample::*member, bool last = false) {
+  std::vector<double> values;
+  double sum = 0;
+  for (auto& sample : samples) {
+    values.push_back(sample.*member);
+    sum += sample.*member;
+  }
+  std::sort(values.begin(), values.end());
+  // Nearest rank percentile.
+  auto percentile = [&values](double p) {
+    size_t rank = size_t(std::ceil(p / 100 * values.size()));
+    return values[std::max(rank, size_t(1)) - 1];
+  };
+  printf(
+      "      \"%s\": {\"mean\": %.2f, \"p50\": %.2f, \"p90\": %.2f, "
+      "\"p99\": %.2f, \"max\": %.2f}%s\n",
+      name, sum / values.size(), percentile(50), percentile(90),
+      percentile(99), values.back(), last ? "" : ",");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  bool null_renderer = false;
+  std::string trace_filename;
+  int measure_threads = 0;
+  std::vector<std::string> scripts;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--null-renderer") == 0) {
+      null_renderer = true;
+    } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+      trace_filename = argv[++i];
+    } else if (strcmp(argv[i], "--measure-threads") == 0 && i + 1 < argc) {
+      measure_threads = atoi(argv[++i]);
+    } else {
+      scripts.push_back(argv[i]);
+    }
+  }
+  if (scripts.empty()) {
+    ListFiles(kScriptDir, "", &scripts);
+    std::sort(scripts.begin(), scripts.end());
+    for (auto& script : scripts) {
+      script = kScriptDir + script;
+    }
+  }
+
+  std::unique_ptr<el::graphics::Renderer> renderer;
+  if (null_renderer) {
+    renderer = std::make_unique<benchmarks::NullRenderer>();
+  } else {
+    renderer = std::make_unique<el::graphics::SoftwareRenderer>();
+  }
+  el::Initialize(renderer.get());
+
+  auto file_system = std::make_unique<el::io::MemoryFileSystem>();
+  AddFiles(file_system.get(), "resources/", "");
+  AddFiles(file_system.get(), "testbed/resources/", "");
+  for (auto& script : scripts) {
+    std::string::size_type slash = script.find_last_of('/');
+    AddFiles(file_system.get(), script.substr(0, slash + 1), "");
+  }
+  el::io::FileManager::RegisterFileSystem(std::move(file_system));
+
+  el::util::StringTable::get()->Load("default_language/language_en.tb.txt");
+  el::Skin::get()->Load("default_skin/skin.tb.txt");
+  el::Skin::get()->Load("skin/skin.tb.txt");
+  register_tbbf_font_renderer();
+  auto font_manager = el::text::FontManager::get();
+  font_manager->AddFontInfo("fonts/segoe_white_with_shadow.tb.txt", "Segoe");
+  el::FontDescription font_desc;
+  font_desc.set_id(TBIDC("Segoe"));
+  font_desc.set_size(el::Skin::get()->dimension_converter()->DpToPx(14));
+  font_manager->set_default_font_description(font_desc);
+  font_manager->CreateFontFace(font_desc);
+
+  if (!trace_filename.empty()) {
+    el::util::Tracer::get()->Start(1024 * 1024);
+  }
+  std::unique_ptr<el::util::WorkPool> measure_pool;
+  if (measure_threads > 1) {
+    measure_pool = std::make_unique<el::util::WorkPool>(measure_threads);
+    el::elements::LayoutBox::set_parallel_measure_pool(measure_pool.get());
+  }
+
+  printf("{\n");
+  printf("  \"renderer\": \"%s\",\n", null_renderer ? "null" : "software");
+  printf("  \"measure_threads\": %d,\n", std::max(measure_threads, 1));
+  printf("  \"scripts\": [");
+  bool first = true;
+  int failed_count = 0;
+  for (auto& script : scripts) {
+    ScriptRunner runner(renderer.get());
+    std::string name = script.substr(script.find_last_of('/') + 1);
+    if (!runner.Run(name)) {
+      fprintf(stderr, "failed to load script: %s\n", script.c_str());
+      ++failed_count;
+      continue;
+    }
+    auto& samples = runner.samples();
+    printf("%s\n    {\n", first ? "" : ",");
+    first = false;
+    printf("      \"name\": \"%s\",\n", name.c_str());
+    printf("      \"frames\": %zu,\n", samples.size());
+    PrintStats("input_us", samples, &FrameSample::input_us);
+    PrintStats("process_us", samples, &FrameSample::process_us);
+    PrintStats("layout_us", samples, &FrameSample::layout_us);
+    PrintStats("paint_us", samples, &FrameSample::paint_us);
+    PrintStats("frame_us", samples, &FrameSample::frame_us);
+    PrintStats("batches", samples, &FrameSample::batches);
+    PrintStats("glyph_misses", samples, &FrameSample::glyph_misses, true);
+    printf("    }");
+  }
+  printf("\n  ]\n}\n");
+
+  if (!trace_filename.empty()) {
+    el::util::Tracer::get()->Stop();
+    if (!el::util::Tracer::get()->SaveChromeTrace(trace_filename)) {
+      fprintf(stderr, "failed to save trace: %s\n", trace_filename.c_str());
+      ++failed_count;
+    }
+  }
+
+  el::elements::LayoutBox::set_parallel_measure_pool(nullptr);
+  measure_pool.reset();
+  el::Shutdown();
+  return failed_count ? 1 : 0;
+}
@@ -0,0 +1,137 @@
+/**
+ ******************************************************************************
+ * Elemental Forms : a lightweight user interface framework                   *
+ ******************************************************************************
+ * Copyright 2015 Ben Vanik. All rights reserved. Licensed as BSD 3-clause.   *
+ * Portions ©2011-2015 Emil Segerås: https://github.com/fruxo/turbobadger     *
+ ******************************************************************************
+ */
+
+// Packs a resource directory into one archive for io::ArchiveFileSystem.
+//
+// Usage: elemental-forms-packer [--store] <resource dir> <archive file>
+//
+// Files are named by their path relative to the resource dir, using '/' as
+// separator. They are compressed unless --store is given or compression
+// doesn't make them smaller. The archive is written in the byte order of the
+// machine running the packer (See io::ArchiveFileSystem).
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "el/io/archive_file_system.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif  // _WIN32
+
+namespace {
+
+// Lists all files under root/path (recursively) as paths relative to root.
+void ListFiles(const std::string& root, const std::string& path,
+               std::vector<std::string>* out_files) {
+#ifdef _WIN32
+  WIN32_FIND_DATAA find_data;
+  HANDLE find = FindFirstFileA((root + path + "*").c_str(), &find_data);
+  if (find == INVALID_HANDLE_VALUE) {
+    return;
+  }
+  do {
+    std::string name = find_data.cFileName;
+    if (name == "." || name == "..") {
+      continue;
+    }
+    if (find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+      ListFiles(root, path + name + "/", out_files);
+    } else {
+      out_files->push_back(path + name);
+    }
+  } while (FindNextFileA(find, &find_data));
+  FindClose(find);
+#else
+  DIR* dir = opendir((root + path).c_str());
+  if (!dir) {
+    return;
+  }
+  while (dirent* entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (name == "." || name == "..") {
+      continue;
+    }
+    struct stat st;
+    if (stat((root + path + name).c_str(), &st) != 0) {
+      continue;
+    }
+    if (S_ISDIR(st.st_mode)) {
+      ListFiles(root, path + name + "/", out_files);
+    } else if (S_ISREG(st.st_mode)) {
+      out_files->push_back(path + name);
+    }
+  }
+  closedir(dir);
+#endif  // _WIN32
+}
+
+bool ReadFile(const std::string& filename, std::vector<uint8_t>* out_data) {
+  FILE* file = fopen(filename.c_str(), "rb");
+  if (!file) {
+    return false;
+  }
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  out_data->resize(size_t(size));
+  bool success =
+      fread(out_data->data(), 1, out_data->size(), file) == out_data->size();
+  fclose(file);
+  return success;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  bool compress = true;
+  int arg = 1;
+  if (arg < argc && std::strcmp(argv[arg], "--store") == 0) {
+    compress = false;
+    ++arg;
+  }
+  if (argc - arg != 2) {
+    fprintf(stderr,
+            "Usage: %s [--store] <resource dir> <archive file>\n", argv[0]);
+    return 1;
+  }
+  std::string root = argv[arg];
+  if (root.back() != '/' && root.back() != '\\') {
+    root += '/';
+  }
+  const char* archive_filename = argv[arg + 1];
+
+  std::vector<std::string> files;
+  ListFiles(root, "", &files);
+
+  el::io::ArchiveWriter writer;
+  size_t total_size = 0;
+  std::vector<uint8_t> data;
+  for (auto& file : files) {
+    if (!ReadFile(root + file, &data)) {
+      fprintf(stderr, "Failed to read %s\n", (root + file).c_str());
+      return 1;
+    }
+    writer.AddFile(file, data.data(), data.size(), compress);
+    total_size += data.size();
+  }
+
+  if (!writer.WriteToFile(archive_filename)) {
+    fprintf(stderr, "Failed to write %s\n", archive_filename);
+    return 1;
+  }
+  printf("Packed %zu files (%zu bytes) into %s\n", files.size(), total_size,
+         archive_filename);
+  return 0;
+}
@@ -0,0 +1,18 @@
+project_root = "../.."
+include(project_root.."/build_tools")
+
+group("tools")
+project("elemental-forms-packer")
+  uuid("5c0f6a6e-3a1e-4f43-9d8b-7f2b0c9a4e31")
+  kind("ConsoleApp")
+  language("C++")
+  links({
+    "elemental-forms",
+  })
+  includedirs({
+    project_root,
+    project_root.."/src",
+  })
+  files({
+    "packer_main.cc",
+  })